@@ -32,7 +32,9 @@ void CiderHashJoinBridge::setHashTable(std::unique_ptr<CiderHashJoinTable> table
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(table, "setHashTable may be called only once");
-    this->buildResult_ = CiderHashBuildResult(std::move(table));
+    // probe side drops rows by the key filter before looking up the table
+    auto keyFilter = table->getKeyFilter();
+    this->buildResult_ = CiderHashBuildResult(std::move(table), std::move(keyFilter));
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -65,13 +67,12 @@ CiderHashJoinBuild::CiderHashJoinBuild(int32_t operatorId,
 }
 
 void CiderHashJoinBuild::addInput(RowVectorPtr input) {
-  for (size_t i = 0; i < input->childrenSize(); i++) {
-    input->childAt(i)->mutableRawNulls();
-  }
+  // Build batches are kept by the hash table, so they take over their own Arrow structs.
+  // Columns without nulls are exported without validity bitmap.
   ArrowArray* inputArrowArray = CiderBatchUtils::allocateArrowArray();
-  exportToArrow(input_, *inputArrowArray);
+  exportToArrow(input, *inputArrowArray);
   ArrowSchema* inputArrowSchema = CiderBatchUtils::allocateArrowSchema();
-  exportToArrow(input_, *inputArrowSchema);
+  exportToArrow(input, *inputArrowSchema);
 
   auto inBatch =
       CiderBatchUtils::createCiderBatch(allocator_, inputArrowSchema, inputArrowArray);
@@ -126,7 +127,8 @@ bool CiderHashJoinBuild::finishHashBuild() {
     VELOX_CHECK(build);
     otherTables.push_back(std::move(build->joinHashTableBuilder_->build()));
   }
-  // merge other tables into one table
+  // Keys were scattered into partitions by every driver in addInput, merge builds the
+  // partitions of all tables concurrently.
   auto joinTable = joinHashTableBuilder_->build()->merge(std::move(otherTables));
 
   joinBridge_->setHashTable(std::move(joinTable));
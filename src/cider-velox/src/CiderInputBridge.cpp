@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "CiderInputBridge.h"
+
+#include "velox/vector/arrow/Bridge.h"
+
+namespace facebook::velox::plugin {
+
+CiderInputBridge::~CiderInputBridge() {
+  releaseArray();
+}
+
+ArrowArray* CiderInputBridge::exportArray(const RowVectorPtr& input) {
+  releaseArray();
+  exportToArrow(input, array_);
+  return &array_;
+}
+
+void CiderInputBridge::releaseArray() {
+  // Released arrays have null release callback.
+  if (array_.release) {
+    array_.release(&array_);
+  }
+}
+
+}  // namespace facebook::velox::plugin
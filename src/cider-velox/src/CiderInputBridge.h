@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/arrow/Abi.h"
+
+namespace facebook::velox::plugin {
+
+// Exports input vectors of an operator to Arrow for Cider without copying buffers.
+// Validity bitmaps are exported only if vectors have them, so non-null columns come
+// with null_count 0 and no bitmap. The ArrowArray struct is owned by the bridge and
+// reused across batches. No schema is exported, processors are compiled from the plan.
+class CiderInputBridge {
+ public:
+  CiderInputBridge() = default;
+
+  CiderInputBridge(const CiderInputBridge&) = delete;
+  CiderInputBridge& operator=(const CiderInputBridge&) = delete;
+
+  ~CiderInputBridge();
+
+  // Exports input into the reused ArrowArray, the previous batch is released first
+  // unless its consumer already did. Valid until the next call.
+  ArrowArray* exportArray(const RowVectorPtr& input);
+
+ private:
+  void releaseArray();
+
+  ArrowArray array_{};
+};
+
+}  // namespace facebook::velox::plugin
@@ -33,15 +33,7 @@ bool CiderPipelineOperator::needsInput() const {
 }
 
 void CiderPipelineOperator::addInput(RowVectorPtr input) {
-  for (size_t i = 0; i < input->childrenSize(); i++) {
-    input->childAt(i)->mutableRawNulls();
-  }
-  ArrowArray* inputArrowArray = CiderBatchUtils::allocateArrowArray();
-  exportToArrow(input_, *inputArrowArray);
-  ArrowSchema* inputArrowSchema = CiderBatchUtils::allocateArrowSchema();
-  exportToArrow(input_, *inputArrowSchema);
-
-  batchProcessor_->processNextBatch(inputArrowArray, inputArrowSchema);
+  batchProcessor_->processNextBatch(inputBridge_.exportArray(input));
 }
 
 facebook::velox::exec::BlockingReason CiderPipelineOperator::isBlocked(
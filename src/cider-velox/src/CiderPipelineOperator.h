@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "CiderInputBridge.h"
 #include "CiderOperator.h"
 #include "CiderPipelineOperator.h"
 #include "cider/processor/BatchProcessor.h"
@@ -47,6 +48,10 @@ class CiderPipelineOperator : public exec::Operator {
   void noMoreInput() override;
 
  private:
+  // Declared before batchProcessor_, which may still refer to the last input, so the
+  // input is released after the processor is destroyed.
+  CiderInputBridge inputBridge_;
+
   cider::exec::processor::BatchProcessorPtr batchProcessor_;
 
   bool finished_{false};
@@ -22,7 +22,7 @@
 
 #pragma once
 
-// #include <common/base/defines.h>
+#include <common/base/defines.h>
 #include <common/base/time.h>
 // #include <common/base/types.h>
 
@@ -30,10 +30,6 @@
 #include <cassert>
 #include <memory>
 
-#if !defined(likely)
-#define likely(x) (__builtin_expect(!!(x), 1))
-#endif
-
 inline uint64_t clock_gettime_ns(clockid_t clock_type = CLOCK_MONOTONIC) {
   struct timespec ts;
   clock_gettime(clock_type, &ts);
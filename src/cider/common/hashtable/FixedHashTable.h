@@ -147,12 +147,12 @@ class FixedHashTable : private boost::noncopyable,
   Cell* buf;  /// A piece of memory for all elements.
 
   void alloc() {
-    buf = reinterpret_cast<Cell*>(Allocator::allocate(NUM_CELLS * sizeof(Cell)));
+    buf = reinterpret_cast<Cell*>(Allocator::alloc(NUM_CELLS * sizeof(Cell)));
   }
 
   void free() {
     if (buf) {
-      Allocator::deallocate(reinterpret_cast<int8_t*>(buf), getBufferSizeInBytes());
+      Allocator::free(buf, getBufferSizeInBytes());
       buf = nullptr;
     }
   }
@@ -225,6 +225,11 @@ class FixedHashTable : private boost::noncopyable,
 
   FixedHashTable() { alloc(); }
 
+  /// Allocates the buffer from the given allocator, e.g. to track its memory.
+  explicit FixedHashTable(Allocator&& allocator) : Allocator(std::move(allocator)) {
+    alloc();
+  }
+
   FixedHashTable(FixedHashTable&& rhs) noexcept : buf(nullptr) {
     *this = std::move(rhs);
   }  /// NOLINT
@@ -27,6 +27,7 @@
 // #include <common/base/types.h>
 #include <common/base/unaligned.h>
 #include <common/contrib/cityhash102/include/city.h>
+#include "util/Logger.h"
 
 #include <type_traits>
 
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <iostream>
+
 #include <common/hashtable/Hash.h>
 #include <common/hashtable/HashTable.h>
 #include <common/hashtable/HashTableAllocator.h>
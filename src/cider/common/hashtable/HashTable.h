@@ -26,13 +26,16 @@
 
 #include <math.h>
 
+#include <cassert>
 #include <new>
 #include <utility>
 
 #include <boost/noncopyable.hpp>
 
+#include <common/base/defines.h>
 #include <common/hashtable/HashTableAllocator.h>
-// #include <common/hashtable/HashTableKeyHolder.h>
+#include <common/hashtable/HashTableKeyHolder.h>
+#include "util/Logger.h"
 
 #ifdef DBMS_HASH_MAP_DEBUG_RESIZES
 #include <Common/Stopwatch.h>
@@ -744,6 +747,13 @@ class HashTable : private boost::noncopyable,
     alloc(grower);
   }
 
+  /// Allocates the buffer from the given allocator, e.g. to track its memory.
+  explicit HashTable(Allocator&& allocator) : Allocator(std::move(allocator)) {
+    if (Cell::need_zero_value_storage)
+      this->zeroValue()->setZero();
+    alloc(grower);
+  }
+
   HashTable(size_t reserve_for_num_elements)  /// NOLINT
   {
     if (Cell::need_zero_value_storage)
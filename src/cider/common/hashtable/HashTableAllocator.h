@@ -22,14 +22,57 @@
 
 #pragma once
 
+#include <cstring>
+#include <memory>
+#include <utility>
+
 #include <../../cider/include/cider/CiderAllocator.h>
 
 /**
- * We are going to use the entire memory we allocated when resizing a hash
- * table, so it makes sense to pre-fault the pages so that page faults don't
- * interrupt the resize loop. Set the allocator parameter accordingly.
+ * Adapts a CiderAllocator to the allocator interface of the hash tables. Empty cells
+ * are all zero bytes, so alloc() and realloc() return zero-filled memory. Tables swap
+ * their buffers on move, the underlying allocators are swapped along with them.
  */
-using HashTableAllocator = CiderDefaultAllocator;
+class HashTableAllocator {
+ public:
+  HashTableAllocator() : allocator_(std::make_shared<CiderDefaultAllocator>()) {}
+
+  explicit HashTableAllocator(std::shared_ptr<CiderAllocator> allocator)
+      : allocator_(std::move(allocator)) {}
+
+  HashTableAllocator(HashTableAllocator&& rhs) : HashTableAllocator() {
+    std::swap(allocator_, rhs.allocator_);
+  }
+
+  HashTableAllocator& operator=(HashTableAllocator&& rhs) noexcept {
+    std::swap(allocator_, rhs.allocator_);
+    return *this;
+  }
+
+  void* alloc(size_t size) {
+    int8_t* buf = allocator_->allocate(size);
+    std::memset(buf, 0, size);
+    return buf;
+  }
+
+  void free(void* buf, size_t size) {
+    allocator_->deallocate(static_cast<int8_t*>(buf), size);
+  }
+
+  void* realloc(void* buf, size_t old_size, size_t new_size) {
+    int8_t* new_buf =
+        allocator_->reallocate(static_cast<int8_t*>(buf), old_size, new_size);
+    if (new_size > old_size) {
+      std::memset(new_buf + old_size, 0, new_size - old_size);
+    }
+    return new_buf;
+  }
+
+  const std::shared_ptr<CiderAllocator>& getAllocator() const { return allocator_; }
+
+ private:
+  std::shared_ptr<CiderAllocator> allocator_;
+};
 
 // TODO: will implement more allocator later
 // template <size_t initial_bytes = 64>
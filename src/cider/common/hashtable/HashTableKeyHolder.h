@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ * Copyright (c) 2016-2022 ClickHouse, Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <type_traits>
+
+#include <common/base/defines.h>
+
+/**
+ * In some aggregation scenarios, when adding a key to the hash table, we
+ * start with a temporary key object, and if it turns out to be a new key,
+ * we must make it persistent. The key holder wraps a temporary key and
+ * provides these operations to the hash table.
+ *
+ * Only plain keys are supported for now, they are persistent by themselves.
+ */
+template <typename Key>
+inline Key& ALWAYS_INLINE keyHolderGetKey(Key&& key) {
+  return key;
+}
+
+template <typename Key>
+inline void ALWAYS_INLINE keyHolderPersistKey(Key&&) {}
+
+template <typename Key>
+inline void ALWAYS_INLINE keyHolderDiscardKey(Key&&) {}
@@ -124,7 +124,6 @@ class CiderCompileModule::Impl {
 
     if (co.use_nextgen_compiler) {
       cider::jitlib::CompilationOptions co;
-      co.dump_ir = true;
       ciderCompilationResult->impl_->codegen_ctx_ =
           cider::exec::nextgen::compile(*ra_exe_unit_, co);
       return ciderCompilationResult;
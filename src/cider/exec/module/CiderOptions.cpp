@@ -51,3 +51,6 @@ DEFINE_bool(allow_runtime_query_interrupt, false, "allow runtime query interrupt
 DEFINE_double(running_query_interrupt_freq, 0.5, "running query interrupt freq");
 DEFINE_uint64(pending_query_interrupt_freq, 1000, "pending query interrupt freq");
 DEFINE_bool(force_direct_hash, false, "force direct hash");
+DEFINE_uint64(groupby_buffer_memory_limit,
+              16777216,
+              "memory limit of group-by aggregation buffer, bytes");
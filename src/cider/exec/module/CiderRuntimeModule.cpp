@@ -587,8 +587,17 @@ void CiderRuntimeModule::groupByProcessImpl(const int8_t*** input_cols,
                          matched_rows,
                          group_by_output_buffer,
                          join_hash_tables_ptr);
+    } else if (group_by_agg_hashtable_->spill()) {
+      // Buffer is cleared, continue with the rows not aggregated yet.
+      groupByProcessImpl(input_cols,
+                         row_skip_mask,
+                         num_fragments,
+                         num_rows_ptr,
+                         flatened_frag_offsets,
+                         matched_rows,
+                         group_by_output_buffer,
+                         join_hash_tables_ptr);
     } else {
-      // TODO: Spill
       CIDER_THROW(CiderRuntimeException, "Group-by aggregation spill not supported.");
     }
   }
@@ -701,6 +710,10 @@ CiderRuntimeModule::fetchResults(int32_t max_row) {
   }
 
   if (!group_by_agg_iterator_) {
+    // Spilled groups are re-aggregated and returned one partition at a time.
+    if (group_by_agg_hashtable_->hasSpilled()) {
+      group_by_agg_hashtable_->loadNextSpillPartition();
+    }
     group_by_agg_iterator_ = group_by_agg_hashtable_->getRowIterator(0);
   }
 
@@ -738,8 +751,10 @@ CiderRuntimeModule::fetchResults(int32_t max_row) {
     }
   }
 
+  const bool has_more_output =
+      group_by_agg_iterator_ || group_by_agg_hashtable_->hasPendingSpillPartitions();
   return std::make_pair(
-      group_by_agg_iterator_ ? kMoreOutput : kNoMoreOutput,
+      has_more_output ? kMoreOutput : kNoMoreOutput,
       std::move(std::make_unique<CiderBatch>(
           setSchemaAndUpdateAggResIfNeed(std::move(groupby_agg_result)))));
 }
@@ -758,7 +773,8 @@ void CiderRuntimeModule::initCiderAggGroupByHashTable() {
   group_by_agg_hashtable_ = std::unique_ptr<CiderAggHashTable, CiderAggHashTableDeleter>(
       new CiderAggHashTable(ciderCompilationResult_->impl_->query_mem_desc_,
                             ciderCompilationResult_->impl_->rel_alg_exe_unit_,
-                            allocator_),
+                            allocator_,
+                            ciderExecutionOption_.groupby_buffer_memory_limit),
       CiderAggHashTableDeleter());
 }
 
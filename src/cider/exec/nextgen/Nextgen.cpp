@@ -22,14 +22,120 @@
 #include "exec/nextgen/Nextgen.h"
 
 #include <memory>
+#include <string>
 
 #include "jitlib/base/JITFunction.h"
 
 namespace cider::exec::nextgen {
 
+using jitlib::JITTypeTag;
+
+namespace {
+std::string getSortKeyEncodeFuncName(SQLTypes type) {
+  switch (type) {
+    case kBOOLEAN:
+      return "nextgen_sort_key_encode_bool";
+    case kTINYINT:
+      return "nextgen_sort_key_encode_int8";
+    case kSMALLINT:
+      return "nextgen_sort_key_encode_int16";
+    case kINT:
+    case kDATE:
+      return "nextgen_sort_key_encode_int32";
+    case kBIGINT:
+    case kTIME:
+    case kTIMESTAMP:
+      return "nextgen_sort_key_encode_int64";
+    case kFLOAT:
+      return "nextgen_sort_key_encode_float";
+    case kDOUBLE:
+      return "nextgen_sort_key_encode_double";
+    default:
+      return "nextgen_sort_key_encode_string";
+  }
+}
+}  // namespace
+
+jitlib::JITFunctionPointer buildSortKeyEncode(jitlib::LLVMJITModule& module,
+                                              const sort::SortKeyLayout& layout) {
+  auto builder = [&layout](jitlib::JITFunctionPointer function) {
+    auto batch = function->getArgument(0);
+    auto row = function->getArgument(1);
+    auto key = function->getArgument(2);
+    auto key_bytes = function->createLiteral(JITTypeTag::INT64, layout.getKeyBytes());
+    function->emitRuntimeFunctionCall(
+        "nextgen_sort_key_clear",
+        jitlib::JITFunctionEmitDescriptor{.ret_type = JITTypeTag::VOID,
+                                          .params_vector = {key.get(), key_bytes.get()}});
+    for (const auto& sort_key : layout.getKeys()) {
+      auto column = context::codegen_utils::getArrowArrayChild(batch, sort_key.column);
+      auto offset = function->createLiteral(JITTypeTag::INT64, sort_key.offset);
+      auto dst = *key + *offset;
+      auto is_desc = function->createLiteral(JITTypeTag::BOOL, sort_key.is_desc);
+      auto nulls_first = function->createLiteral(JITTypeTag::BOOL, sort_key.nulls_first);
+      function->emitRuntimeFunctionCall(
+          getSortKeyEncodeFuncName(sort_key.type),
+          jitlib::JITFunctionEmitDescriptor{.ret_type = JITTypeTag::VOID,
+                                            .params_vector = {dst.get(),
+                                                              column.get(),
+                                                              row.get(),
+                                                              is_desc.get(),
+                                                              nulls_first.get()}});
+    }
+    auto key_words = function->createLiteral(JITTypeTag::INT64, layout.getKeyWords());
+    function->emitRuntimeFunctionCall(
+        "nextgen_sort_key_finish",
+        jitlib::JITFunctionEmitDescriptor{.ret_type = JITTypeTag::VOID,
+                                          .params_vector = {key.get(), key_words.get()}});
+    function->createReturn();
+  };
+
+  return jitlib::JITFunctionBuilder()
+      .registerModule(module)
+      .setFuncName("sort_key_encode")
+      .addReturn(JITTypeTag::VOID)
+      .addParameter(JITTypeTag::POINTER, "batch", JITTypeTag::INT8)
+      .addParameter(JITTypeTag::INT64, "row")
+      .addParameter(JITTypeTag::POINTER, "key", JITTypeTag::INT8)
+      .addProcedureBuilder(builder)
+      .build();
+}
+
+jitlib::JITFunctionPointer buildSortKeyCompare(jitlib::LLVMJITModule& module,
+                                               size_t words) {
+  auto builder = [words](jitlib::JITFunctionPointer function) {
+    auto lhs = function->getArgument(0);
+    auto rhs = function->getArgument(1);
+    auto result = function->createVariable(JITTypeTag::INT32, "result", 0);
+    // From the last word to the first, without branches. Booleans are sign extended,
+    // so true is -1 and lt - gt is the sign of the word comparison.
+    for (size_t i = words; i-- > 0;) {
+      auto index = function->createLiteral(JITTypeTag::INT64, i);
+      auto lhs_word = lhs[index];
+      auto rhs_word = rhs[index];
+      auto lt = (*lhs_word < *rhs_word)->castJITValuePrimitiveType(JITTypeTag::INT32);
+      auto gt = (*lhs_word > *rhs_word)->castJITValuePrimitiveType(JITTypeTag::INT32);
+      auto eq = (*lhs_word == *rhs_word)->castJITValuePrimitiveType(JITTypeTag::INT32);
+      *result = *(*(*lt - *gt) - *(*eq * *result));
+    }
+    function->createReturn(*result);
+  };
+
+  return jitlib::JITFunctionBuilder()
+      .registerModule(module)
+      .setFuncName("sort_key_compare")
+      .addReturn(JITTypeTag::INT32)
+      .addParameter(JITTypeTag::POINTER, "lhs", JITTypeTag::INT64)
+      .addParameter(JITTypeTag::POINTER, "rhs", JITTypeTag::INT64)
+      .addProcedureBuilder(builder)
+      .build();
+}
+
 std::unique_ptr<context::CodegenContext> compile(const RelAlgExecutionUnit& ra_exe_unit,
-                                                 const jitlib::CompilationOptions& co) {
+                                                 const jitlib::CompilationOptions& co,
+                                                 const context::CodegenOptions& cgo) {
   auto codegen_ctx = std::make_unique<context::CodegenContext>();
+  codegen_ctx->setCodegenOptions(cgo);
   auto module = std::make_shared<jitlib::LLVMJITModule>("codegen", true, co);
 
   auto builder = [&ra_exe_unit, &codegen_ctx](jitlib::JITFunctionPointer function) {
@@ -50,8 +156,43 @@ std::unique_ptr<context::CodegenContext> compile(const RelAlgExecutionUnit& ra_e
           .addProcedureBuilder(builder)
           .build();
 
+  // Output rows are sorted by keys referring to target expressions. Output columns, with
+  // or without aggregation, follow the order of targets, so the target at tle_no is the
+  // output column tle_no - 1.
+  const auto& order_entries = ra_exe_unit.sort_info.order_entries;
+  sort::SortKeyLayout sort_layout;
+  jitlib::JITFunctionPointer sort_key_encode;
+  jitlib::JITFunctionPointer sort_key_compare;
+  if (!order_entries.empty()) {
+    for (const auto& entry : order_entries) {
+      CHECK_GT(entry.tle_no, 0);
+      CHECK_LE(static_cast<size_t>(entry.tle_no), ra_exe_unit.target_exprs.size());
+      const size_t output_column = entry.tle_no - 1;
+      auto target = ra_exe_unit.target_exprs[output_column];
+      sort_layout.addKey(output_column,
+                         target->get_type_info().get_type(),
+                         entry.is_desc,
+                         entry.nulls_first);
+    }
+    sort_key_encode = buildSortKeyEncode(*module, sort_layout);
+    sort_key_compare = buildSortKeyCompare(*module, sort_layout.getCompareWords());
+  }
+
   module->finish();
 
+  if (sort_key_compare) {
+    using SortDescriptor = context::CodegenContext::SortDescriptor;
+    codegen_ctx->setSortDescriptor(std::make_shared<SortDescriptor>(
+        sort_layout,
+        ra_exe_unit.sort_info.has_limit
+            ? std::optional<size_t>(ra_exe_unit.sort_info.limit)
+            : std::nullopt,
+        ra_exe_unit.sort_info.offset,
+        sort_key_encode->getFunctionPointer<void, const ArrowArray*, int64_t, int64_t*>(),
+        sort_key_compare->getFunctionPointer<int32_t, const int64_t*, const int64_t*>(),
+        module));
+  }
+
   codegen_ctx->setJITModule(std::move(module));
 
   return codegen_ctx;
@@ -31,7 +31,19 @@ using QueryFunc = void (*)(int8_t*, int8_t*);
 
 std::unique_ptr<context::CodegenContext> compile(
     const RelAlgExecutionUnit& eu,
-    const jitlib::CompilationOptions& co = jitlib::CompilationOptions{});
+    const jitlib::CompilationOptions& co = jitlib::CompilationOptions{},
+    const context::CodegenOptions& cgo = context::CodegenOptions{});
+
+// Builds the encoder of normalized sort keys of a row into module, with the type, offset
+// and order of every key column fixed at codegen time. It encodes keys the same way as
+// SortKeyLayout::encode().
+jitlib::JITFunctionPointer buildSortKeyEncode(jitlib::LLVMJITModule& module,
+                                              const sort::SortKeyLayout& layout);
+
+// Builds the comparator of the first words of normalized sort keys into module, which
+// returns the sign of the first differing word like compareSortKeys().
+jitlib::JITFunctionPointer buildSortKeyCompare(jitlib::LLVMJITModule& module,
+                                               size_t words);
 
 }  // namespace cider::exec::nextgen
 
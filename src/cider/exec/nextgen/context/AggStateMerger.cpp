@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/nextgen/context/AggStateMerger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "cider/CiderException.h"
+
+namespace cider::exec::nextgen::context {
+namespace {
+template <typename T>
+void mergeSlot(int8_t* dst, const int8_t* src, SQLAgg agg_type) {
+  T& dst_value = *reinterpret_cast<T*>(dst);
+  const T src_value = *reinterpret_cast<const T*>(src);
+  // Slots of null states keep their initial values, which are identities of the merge.
+  switch (agg_type) {
+    case SQLAgg::kSUM:
+    case SQLAgg::kCOUNT:
+      dst_value += src_value;
+      break;
+    case SQLAgg::kMIN:
+      dst_value = std::min(dst_value, src_value);
+      break;
+    case SQLAgg::kMAX:
+      dst_value = std::max(dst_value, src_value);
+      break;
+    case SQLAgg::kAVG:
+      dst_value += src_value;
+      *reinterpret_cast<int64_t*>(dst + sizeof(T)) +=
+          *reinterpret_cast<const int64_t*>(src + sizeof(T));
+      break;
+    default:
+      LOG(FATAL) << "Unsupported aggregation in partial merge: " << toString(agg_type);
+  }
+}
+
+void checkMergeable(const AggExprsInfoVector& info) {
+  for (const auto& agg : info) {
+    if (agg.is_distinct_) {
+      CIDER_THROW(CiderRuntimeException,
+                  "Partial states of distinct aggregation can't be merged.");
+    }
+    switch (agg.agg_type_) {
+      case SQLAgg::kSUM:
+      case SQLAgg::kCOUNT:
+      case SQLAgg::kMIN:
+      case SQLAgg::kMAX:
+      case SQLAgg::kAVG:
+        break;
+      default:
+        CIDER_THROW(CiderRuntimeException,
+                    "Unsupported aggregation in partial merge: " +
+                        toString(agg.agg_type_));
+    }
+  }
+}
+
+void mergeAggStatesImpl(int8_t* dst, const int8_t* src, const AggExprsInfoVector& info) {
+  for (const auto& agg : info) {
+    int8_t* dst_slot = dst + agg.start_offset_;
+    const int8_t* src_slot = src + agg.start_offset_;
+    switch (agg.jit_value_type_) {
+      case jitlib::JITTypeTag::INT8:
+        mergeSlot<int8_t>(dst_slot, src_slot, agg.agg_type_);
+        break;
+      case jitlib::JITTypeTag::INT16:
+        mergeSlot<int16_t>(dst_slot, src_slot, agg.agg_type_);
+        break;
+      case jitlib::JITTypeTag::INT32:
+        mergeSlot<int32_t>(dst_slot, src_slot, agg.agg_type_);
+        break;
+      case jitlib::JITTypeTag::INT64:
+        mergeSlot<int64_t>(dst_slot, src_slot, agg.agg_type_);
+        break;
+      case jitlib::JITTypeTag::FLOAT:
+        mergeSlot<float>(dst_slot, src_slot, agg.agg_type_);
+        break;
+      case jitlib::JITTypeTag::DOUBLE:
+        mergeSlot<double>(dst_slot, src_slot, agg.agg_type_);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported aggregation slot type in partial merge: "
+                   << jitlib::getJITTypeName(agg.jit_value_type_);
+    }
+    // null flag: 1--null, 0--not null
+    dst[agg.null_offset_] = dst[agg.null_offset_] && src[agg.null_offset_];
+  }
+}
+}  // namespace
+
+void mergeAggStates(int8_t* dst, const int8_t* src, const AggExprsInfoVector& info) {
+  checkMergeable(info);
+  mergeAggStatesImpl(dst, src, info);
+}
+
+std::vector<GroupByHashTablePtr> mergeGroupByHashTables(
+    const std::vector<const GroupByHashTable*>& tables,
+    const AggExprsInfoVector& info,
+    const CiderAllocatorPtr& allocator,
+    size_t partition_num) {
+  CHECK(!tables.empty());
+  checkMergeable(info);
+  partition_num = std::max<size_t>(1, partition_num);
+  const GroupByHashTable& layout = *tables.front();
+
+  // Runs task(i) for i in [0, task_num) on partition_num threads. Tasks allocate from
+  // allocator and may throw, e.g. CiderOutOfMemoryException, the first exception stops
+  // the remaining tasks and is rethrown on the calling thread.
+  auto parallel_for = [partition_num](size_t task_num, const auto& task) {
+    std::atomic<size_t> next_task{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto run_tasks = [&]() {
+      try {
+        for (size_t i = next_task++; i < task_num; i = next_task++) {
+          task(i);
+        }
+      } catch (...) {
+        next_task = task_num;
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(partition_num, task_num); ++i) {
+      threads.emplace_back(run_tasks);
+    }
+    run_tasks();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  };
+
+  // Split entries of every table by the high bits of key hash, the low bits pick slots
+  // inside partition tables.
+  std::vector<std::vector<std::vector<size_t>>> partitioned_entries(
+      tables.size(), std::vector<std::vector<size_t>>(partition_num));
+  parallel_for(tables.size(), [&](size_t table_index) {
+    const GroupByHashTable& table = *tables[table_index];
+    auto& partitions = partitioned_entries[table_index];
+    for (size_t i = 0; i < table.getEntryNum(); ++i) {
+      partitions[(table.getEntryHash(i) >> 32) % partition_num].push_back(i);
+    }
+  });
+
+  std::vector<GroupByHashTablePtr> merged(partition_num);
+  parallel_for(partition_num, [&](size_t partition) {
+    auto table = std::make_unique<GroupByHashTable>(layout.getKeyNum(),
+                                                    layout.getInitState(),
+                                                    allocator,
+                                                    layout.getSingleKeyWidth());
+    for (size_t i = 0; i < tables.size(); ++i) {
+      for (auto entry : partitioned_entries[i][partition]) {
+        int8_t* state = table->findOrInsert(tables[i]->getEntryKey(entry),
+                                            tables[i]->getEntryKeySize(entry));
+        mergeAggStatesImpl(state, tables[i]->getEntryState(entry), info);
+      }
+    }
+    merged[partition] = std::move(table);
+  });
+  return merged;
+}
+
+}  // namespace cider::exec::nextgen::context
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NEXTGEN_CONTEXT_AGGSTATEMERGER_H
+#define NEXTGEN_CONTEXT_AGGSTATEMERGER_H
+
+#include <vector>
+
+#include "exec/nextgen/context/CodegenContext.h"
+#include "exec/nextgen/context/GroupByHashTable.h"
+
+namespace cider::exec::nextgen::context {
+
+/// \brief Merges the aggregation state src into dst, both are laid out as described by
+/// info. States which can't be combined (e.g. COUNT DISTINCT) are rejected.
+void mergeAggStates(int8_t* dst, const int8_t* src, const AggExprsInfoVector& info);
+
+/// \brief Merges partial group-by hash tables of the same query into partition_num
+/// tables. Entries are first split by key hash, then every partition is merged by one
+/// thread without locking, so a key appears in exactly one of the returned tables.
+std::vector<GroupByHashTablePtr> mergeGroupByHashTables(
+    const std::vector<const GroupByHashTable*>& tables,
+    const AggExprsInfoVector& info,
+    const CiderAllocatorPtr& allocator,
+    size_t partition_num);
+
+}  // namespace cider::exec::nextgen::context
+
+#endif  // NEXTGEN_CONTEXT_AGGSTATEMERGER_H
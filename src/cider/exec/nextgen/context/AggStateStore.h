@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NEXTGEN_CONTEXT_AGGSTATESTORE_H
+#define NEXTGEN_CONTEXT_AGGSTATESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "cider/CiderAllocator.h"
+#include "type/data/funcannotations.h"
+
+#include "common/hashtable/FixedHashMap.h"
+#include "common/hashtable/HashMap.h"
+
+namespace cider::exec::nextgen::context {
+
+/// \brief Maps a single fixed-width group-by key to the address of its aggregation
+/// states. States are owned by the caller, a store only keeps their addresses, which
+/// are never null, so the implicit-zero fixed maps can be used as-is.
+template <typename Map>
+class AggStateStore {
+ public:
+  using Key = typename Map::key_type;
+
+  AggStateStore() = default;
+
+  /// The cells are allocated from allocator, so they are counted if it tracks memory.
+  explicit AggStateStore(const std::shared_ptr<CiderAllocator>& allocator)
+      : map_(HashTableAllocator(allocator)) {}
+
+  size_t size() const { return map_.size(); }
+
+  /// \brief Returns the states of key, create() is called to allocate them if the key
+  /// doesn't exist.
+  template <typename Creator>
+  int8_t* findOrInsert(Key key, Creator&& create) {
+    typename Map::LookupResult it;
+    bool inserted = false;
+    map_.emplace(key, it, inserted);
+    if (inserted) {
+      it->getMapped() = create(key);
+    }
+    return it->getMapped();
+  }
+
+  template <typename Func>
+  void forEachValue(Func&& func) {
+    map_.forEachValue(func);
+  }
+
+ private:
+  Map map_;
+};
+
+// 8-bit and 16-bit keys index a flat array of 256 / 65536 cells directly.
+using Int8AggStateStore = AggStateStore<FixedImplicitZeroHashMap<uint8_t, int8_t*>>;
+using Int16AggStateStore =
+    AggStateStore<FixedImplicitZeroHashMapWithCalculatedSize<uint16_t, int8_t*>>;
+// Wider keys are bit-casted into 64 bits, saved hashes make resizing cheaper.
+using Int64AggStateStore = AggStateStore<HashMapWithSavedHash<uint64_t, int8_t*>>;
+
+}  // namespace cider::exec::nextgen::context
+
+#endif  // NEXTGEN_CONTEXT_AGGSTATESTORE_H
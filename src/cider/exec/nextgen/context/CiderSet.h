@@ -22,6 +22,8 @@
 #ifndef CIDER_SET_H
 #define CIDER_SET_H
 
+#include <functional>
+
 #include "cider/CiderException.h"
 #include "robin_hood.h"
 
@@ -167,7 +169,80 @@ class CiderDoubleSet : public CiderSet {
   robin_hood::unordered_set<double> set_;
 };
 
+// Distinct values of COUNT(DISTINCT), values are normalized into int64 and grouped by
+// the address of aggregation state, so that a single set serves all groups. Values
+// inserted without a group belong to the null group.
+class CiderCountDistinctSet : public CiderSet {
+ public:
+  CiderCountDistinctSet() : CiderSet() {}
+
+  // Returns true if the value is new to the group.
+  bool insertDistinct(const int8_t* group, int64_t key_val) {
+    return grouped_set_.insert({group, key_val}).second;
+  }
+
+  void insert(int8_t key_val) { insertDistinct(nullptr, key_val); }
+
+  void insert(int16_t key_val) { insertDistinct(nullptr, key_val); }
+
+  void insert(int32_t key_val) { insertDistinct(nullptr, key_val); }
+
+  void insert(int64_t key_val) { insertDistinct(nullptr, key_val); }
+
+  void insert(float key_val) {
+    CIDER_THROW(CiderRuntimeException,
+                "CiderCountDistinctSet doesn't support insert float value.");
+  }
+
+  void insert(double key_val) {
+    CIDER_THROW(CiderRuntimeException,
+                "CiderCountDistinctSet doesn't support insert double value.");
+  }
+
+  void insert(std::string key_val) {
+    CIDER_THROW(CiderRuntimeException,
+                "CiderCountDistinctSet doesn't support insert string value.");
+  }
+
+  bool contains(int8_t key_val) { return grouped_set_.contains({nullptr, key_val}); }
+
+  bool contains(int16_t key_val) { return grouped_set_.contains({nullptr, key_val}); }
+
+  bool contains(int32_t key_val) { return grouped_set_.contains({nullptr, key_val}); }
+
+  bool contains(int64_t key_val) { return grouped_set_.contains({nullptr, key_val}); }
+
+  bool contains(float key_val) {
+    CIDER_THROW(CiderRuntimeException,
+                "CiderCountDistinctSet doesn't support find float value.");
+  }
+
+  bool contains(double key_val) {
+    CIDER_THROW(CiderRuntimeException,
+                "CiderCountDistinctSet doesn't support find double value.");
+  }
+
+  bool contains(std::string key_val) {
+    CIDER_THROW(CiderRuntimeException,
+                "CiderCountDistinctSet doesn't support find string value.");
+  }
+
+ private:
+  using GroupedKey = std::pair<const int8_t*, int64_t>;
+
+  struct GroupedKeyHash {
+    size_t operator()(const GroupedKey& key) const {
+      return robin_hood::hash_int(static_cast<uint64_t>(key.second) ^
+                                  reinterpret_cast<uint64_t>(key.first) *
+                                      0x9E3779B97F4A7C15ULL);
+    }
+  };
+
+  robin_hood::unordered_set<GroupedKey, GroupedKeyHash> grouped_set_;
+};
+
 using CiderSetPtr = std::unique_ptr<CiderSet>;
+using CiderSetCreator = std::function<CiderSetPtr()>;
 
 }  // namespace cider::exec::nextgen::context
 #endif  // CIDER_SET_H
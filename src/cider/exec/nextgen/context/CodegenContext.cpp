@@ -20,6 +20,9 @@
  */
 
 #include "exec/nextgen/context/CodegenContext.h"
+
+#include <algorithm>
+
 #include "exec/nextgen/context/RuntimeContext.h"
 
 namespace cider::exec::nextgen::context {
@@ -131,6 +134,55 @@ jitlib::JITValuePointer CodegenContext::registerCiderSet(const std::string& name
   return ret;
 }
 
+jitlib::JITValuePointer CodegenContext::registerCiderSet(const std::string& name,
+                                                         const SQLTypeInfo& type,
+                                                         CiderSetCreator creator) {
+  int64_t id = acquireContextID();
+  JITValuePointer ret = jit_func_->createLocalJITValue([this, id]() {
+    auto index = this->jit_func_->createLiteral(JITTypeTag::INT64, id);
+    auto pointer = this->jit_func_->emitRuntimeFunctionCall(
+        "get_query_context_item_ptr",
+        JITFunctionEmitDescriptor{
+            .ret_type = JITTypeTag::POINTER,
+            .ret_sub_type = JITTypeTag::INT8,
+            .params_vector = {this->jit_func_->getArgument(0).get(), index.get()}});
+
+    return pointer;
+  });
+  ret->setName(name);
+
+  cider_set_descriptors_.emplace_back(
+      std::make_shared<CiderSetDescriptor>(id, name, type, std::move(creator)), ret);
+  return ret;
+}
+
+JITValuePointer CodegenContext::registerGroupByHashTable(
+    const std::string& name,
+    const std::vector<SQLTypeInfo>& key_types,
+    const std::vector<AggExprsInfo>& info,
+    const std::vector<int8_t>& init_state,
+    const std::vector<AggOutputColumn>& output_columns) {
+  int64_t id = acquireContextID();
+  JITValuePointer ret = jit_func_->createLocalJITValue([this, id]() {
+    auto index = this->jit_func_->createLiteral(JITTypeTag::INT64, id);
+    auto pointer = this->jit_func_->emitRuntimeFunctionCall(
+        "get_query_context_item_ptr",
+        JITFunctionEmitDescriptor{
+            .ret_type = JITTypeTag::POINTER,
+            .ret_sub_type = JITTypeTag::INT8,
+            .params_vector = {this->jit_func_->getArgument(0).get(), index.get()}});
+
+    return pointer;
+  });
+  ret->setName(name);
+
+  groupby_hashtable_descriptors_.emplace_back(
+      std::make_shared<GroupByHashTableDescriptor>(
+          id, name, key_types, info, init_state, output_columns),
+      ret);
+  return ret;
+}
+
 JITValuePointer CodegenContext::registerHashTable(const std::string& name) {
   int64_t id = acquireContextID();
   auto index = this->jit_func_->createLiteral(JITTypeTag::INT64, id);
@@ -152,6 +204,15 @@ JITValuePointer CodegenContext::registerHashTable(const std::string& name) {
   return ret;
 }
 
+JITValuePointer CodegenContext::registerSelectionVector(
+    const std::vector<int64_t>& input_column_ids) {
+  CHECK(nullptr == selection_descriptor_);
+  JITValuePointer ret = registerBatch(SQLTypeInfo(kINT, true), "selection", true);
+  selection_descriptor_ = std::make_shared<SelectionDescriptor>(
+      batch_descriptors_.back().first->ctx_id, input_column_ids);
+  return ret;
+}
+
 RuntimeCtxPtr CodegenContext::generateRuntimeCTX(
     const CiderAllocatorPtr& allocator) const {
   auto runtime_ctx = std::make_unique<RuntimeContext>(getNextContextID());
@@ -169,15 +230,122 @@ RuntimeCtxPtr CodegenContext::generateRuntimeCTX(
     runtime_ctx->addCiderSet(cider_set_desc.first);
   }
 
+  for (auto& groupby_hashtable_desc : groupby_hashtable_descriptors_) {
+    runtime_ctx->addGroupByHashTable(groupby_hashtable_desc.first);
+  }
+
+  if (selection_descriptor_) {
+    runtime_ctx->addSelection(selection_descriptor_);
+  }
+
+  if (sort_descriptor_) {
+    runtime_ctx->addSort(sort_descriptor_);
+  }
+
   runtime_ctx->instantiate(allocator);
   return runtime_ctx;
 }
 
-std::string AggExprsInfo::getAggName(SQLAgg agg_type, SQLTypes sql_type) {
+bool CodegenContext::hasSameRuntimeLayout(const CodegenContext& other) const {
+  auto same_descriptor = [](const auto& lhs, const auto& rhs) {
+    return lhs == rhs ||
+           (lhs && rhs && lhs->ctx_id == rhs->ctx_id && lhs->name == rhs->name);
+  };
+  auto same_descriptors = [&same_descriptor](const auto& lhs, const auto& rhs) {
+    return std::equal(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [&](auto& l, auto& r) {
+          return same_descriptor(l.first, r.first);
+        });
+  };
+  auto same_selection = [](const SelectionDescriptorPtr& lhs,
+                           const SelectionDescriptorPtr& rhs) {
+    return lhs == rhs || (lhs && rhs && lhs->ctx_id == rhs->ctx_id);
+  };
+  return getNextContextID() == other.getNextContextID() &&
+         same_descriptors(batch_descriptors_, other.batch_descriptors_) &&
+         same_descriptors(buffer_descriptors_, other.buffer_descriptors_) &&
+         same_descriptor(hashtable_descriptor_.first,
+                         other.hashtable_descriptor_.first) &&
+         same_descriptors(cider_set_descriptors_, other.cider_set_descriptors_) &&
+         same_descriptors(groupby_hashtable_descriptors_,
+                          other.groupby_hashtable_descriptors_) &&
+         same_selection(selection_descriptor_, other.selection_descriptor_) &&
+         !sort_descriptor_ == !other.sort_descriptor_;
+}
+
+jitlib::JITTypeTag AggExprsInfo::getSlotType(SQLAgg agg_type,
+                                             const SQLTypeInfo& sql_type_info,
+                                             const SQLTypeInfo& arg_type_info) {
+  switch (agg_type) {
+    case SQLAgg::kSUM:
+    case SQLAgg::kMIN:
+    case SQLAgg::kMAX:
+      return utils::getJITTypeTag(sql_type_info.get_type());
+    case SQLAgg::kCOUNT:
+      return JITTypeTag::INT64;
+    case SQLAgg::kAVG:
+      return arg_type_info.is_fp() ? JITTypeTag::DOUBLE : JITTypeTag::INT64;
+    default:
+      LOG(FATAL) << "unsupport agg function type: " << toString(agg_type);
+  }
+  return JITTypeTag::INVALID;
+}
+
+int32_t AggExprsInfo::getSlotSize(SQLAgg agg_type, jitlib::JITTypeTag slot_type) {
+  // AVG keeps an int64 count after the sum.
+  return agg_type == SQLAgg::kAVG ? getJITTypeSize(slot_type) + sizeof(int64_t)
+                                  : getJITTypeSize(slot_type);
+}
+
+static std::string getAggTypeSuffix(JITTypeTag type) {
+  switch (type) {
+    case JITTypeTag::INT8:
+      return "int8";
+    case JITTypeTag::INT16:
+      return "int16";
+    case JITTypeTag::INT32:
+      return "int32";
+    case JITTypeTag::INT64:
+      return "int64";
+    case JITTypeTag::FLOAT:
+      return "float";
+    case JITTypeTag::DOUBLE:
+      return "double";
+    default:
+      LOG(FATAL) << "unsupport agg value type: " << getJITTypeName(type);
+  }
+  return "";
+}
+
+std::string AggExprsInfo::getAggName(SQLAgg agg_type,
+                                     bool is_distinct,
+                                     jitlib::JITTypeTag slot_type,
+                                     const SQLTypeInfo& arg_type_info) {
   std::string agg_name = "nextgen_cider_agg";
   switch (agg_type) {
     case SQLAgg::kSUM: {
-      agg_name = agg_name + "_sum_" + utils::getSQLTypeName(sql_type);
+      agg_name = agg_name + "_sum_" + getAggTypeSuffix(slot_type);
+      break;
+    }
+    case SQLAgg::kMIN: {
+      agg_name = agg_name + "_min_" + getAggTypeSuffix(slot_type);
+      break;
+    }
+    case SQLAgg::kMAX: {
+      agg_name = agg_name + "_max_" + getAggTypeSuffix(slot_type);
+      break;
+    }
+    case SQLAgg::kAVG: {
+      agg_name = agg_name + "_avg_" + getAggTypeSuffix(slot_type);
+      break;
+    }
+    case SQLAgg::kCOUNT: {
+      if (is_distinct) {
+        agg_name = agg_name + "_count_distinct_" +
+                   getAggTypeSuffix(utils::getJITTypeTag(arg_type_info.get_type()));
+      } else {
+        agg_name = agg_name + "_count";
+      }
       break;
     }
     default:
@@ -251,6 +419,25 @@ jitlib::JITValuePointer allocateArrowArrayBuffer(jitlib::JITValuePointer& arrow_
   return getArrowArrayBuffer(arrow_array, index);
 }
 
+jitlib::JITValuePointer reserveArrowArrayBuffer(jitlib::JITValuePointer& arrow_array,
+                                                int64_t index,
+                                                jitlib::JITValuePointer& bytes) {
+  CHECK(arrow_array->getValueTypeTag() == JITTypeTag::POINTER);
+  CHECK(arrow_array->getValueSubTypeTag() == JITTypeTag::INT8);
+
+  auto& func = arrow_array->getParentJITFunction();
+  auto jit_index = func.createLiteral(JITTypeTag::INT64, index);
+  auto ret = func.emitRuntimeFunctionCall(
+      "reserve_arrow_array_buffer",
+      JITFunctionEmitDescriptor{
+          .ret_type = JITTypeTag::POINTER,
+          .ret_sub_type = JITTypeTag::INT8,
+          .params_vector = {arrow_array.get(), jit_index.get(), bytes.get()}});
+
+  ret->setName("array_buffer");
+  return ret;
+}
+
 void setArrowArrayLength(jitlib::JITValuePointer& arrow_array,
                          jitlib::JITValuePointer& len) {
   CHECK(arrow_array->getValueTypeTag() == JITTypeTag::POINTER);
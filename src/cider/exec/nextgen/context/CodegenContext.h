@@ -21,12 +21,15 @@
 #ifndef NEXTGEN_CONTEXT_CODEGENCONTEXT_H
 #define NEXTGEN_CONTEXT_CODEGENCONTEXT_H
 
+#include "cider/processor/JoinKeyFilter.h"
 #include "exec/nextgen/context/Buffer.h"
 #include "exec/nextgen/context/CiderSet.h"
 #include "exec/nextgen/jitlib/base/JITModule.h"
 #include "exec/nextgen/utils/JITExprValue.h"
 #include "exec/nextgen/utils/TypeUtils.h"
+#include "exec/operator/join/CiderJoinHashTable.h"
 #include "exec/operator/join/CiderLinearProbingHashTable.h"
+#include "exec/operator/sort/CiderSorter.h"
 #include "util/sqldefs.h"
 
 namespace cider::exec::nextgen::context {
@@ -50,36 +53,141 @@ struct murmurHash {
 };
 
 struct Equal {
-  bool operator()(int lhs, int rhs) { return lhs == rhs; }
+  bool operator()(int64_t lhs, int64_t rhs) { return lhs == rhs; }
 };
+
+// Hash table of join build side, maps a join key (sign-extended to int64) to the
+// build rows holding it.
+using JoinHashMap =
+    JoinProbeHashTable<int64_t, std::pair<Batch*, int64_t>, murmurHash, Equal>;
+
+// Join hash table radix-partitioned into sub-tables by the top bits of key hash, so that
+// sub-tables can be built concurrently. An entry is addressed by a slot, which is
+// (partition << 32) | entry index in the sub-table, -1 means no entry.
+class PartitionedJoinHashMap {
+ public:
+  explicit PartitionedJoinHashMap(size_t partition_bits = 0)
+      : partition_bits_(partition_bits) {
+    CHECK_LT(partition_bits, 32);
+    size_t partition_num = size_t(1) << partition_bits;
+    partitions_.reserve(partition_num);
+    for (size_t i = 0; i < partition_num; ++i) {
+      partitions_.emplace_back(std::make_unique<JoinHashMap>());
+    }
+  }
+
+  static size_t getPartition(int64_t key, size_t partition_bits) {
+    return partition_bits ? murmurHash()(key) >> (64 - partition_bits) : 0;
+  }
+
+  size_t getPartitionNum() const { return partitions_.size(); }
+
+  JoinHashMap& getPartitionTable(size_t partition) { return *partitions_[partition]; }
+
+  // Probe keys rejected by filter skip the lookup of sub-tables.
+  void setKeyFilter(const processor::JoinKeyFilter* filter) { key_filter_ = filter; }
+
+  int64_t probeFirst(int64_t key) const {
+    if (key_filter_ && !key_filter_->mayContain(key)) {
+      return -1;
+    }
+    size_t partition = getPartition(key, partition_bits_);
+    return toSlot(partition, partitions_[partition]->find_first(key));
+  }
+
+  // Duplicates of a key are chained, so key is not compared again.
+  int64_t probeNext(int64_t key, int64_t slot) const {
+    size_t partition = slot >> 32;
+    return toSlot(partition, partitions_[partition]->find_next(slot & kIndexMask));
+  }
+
+  const std::pair<Batch*, int64_t>& valueAt(int64_t slot) const {
+    return partitions_[slot >> 32]->value_at(slot & kIndexMask);
+  }
+
+ private:
+  static constexpr int64_t kIndexMask = 0xFFFFFFFFL;
+
+  static int64_t toSlot(size_t partition, JoinHashMap::entry_index index) {
+    if (index == JoinHashMap::npos) {
+      return -1;
+    }
+    return (static_cast<int64_t>(partition) << 32) | index;
+  }
+
+  size_t partition_bits_;
+  std::vector<std::unique_ptr<JoinHashMap>> partitions_;
+  const processor::JoinKeyFilter* key_filter_{nullptr};
+};
+
 struct AggExprsInfo {
  public:
   SQLTypeInfo sql_type_info_;
+  SQLTypeInfo arg_type_info_;
+  // Type of the value slot in aggregation buffer, which may differ from the output type
+  // (e.g. COUNT always counts in int64, AVG sums integers in int64).
   jitlib::JITTypeTag jit_value_type_;
   SQLAgg agg_type_;
-  int8_t start_offset_;
-  int8_t byte_size_;
-  int8_t null_offset_;
+  bool is_distinct_;
+  int32_t start_offset_;
+  int32_t byte_size_;
+  int32_t null_offset_;
   std::string agg_name_;
 
   AggExprsInfo(SQLTypeInfo sql_type_info,
+               SQLTypeInfo arg_type_info,
                SQLAgg agg_type,
-               int8_t start_offset,
-               int8_t byte_size)
+               bool is_distinct,
+               int32_t start_offset = 0)
       : sql_type_info_(sql_type_info)
-      , jit_value_type_(utils::getJITTypeTag(sql_type_info_.get_type()))
+      , arg_type_info_(arg_type_info)
+      , jit_value_type_(getSlotType(agg_type, sql_type_info_, arg_type_info_))
       , agg_type_(agg_type)
+      , is_distinct_(is_distinct)
       , start_offset_(start_offset)
-      , byte_size_(byte_size)
+      , byte_size_(getSlotSize(agg_type, jit_value_type_))
       , null_offset_(-1)
-      , agg_name_(getAggName(agg_type, sql_type_info_.get_type())) {}
+      , agg_name_(getAggName(agg_type, is_distinct, jit_value_type_, arg_type_info_)) {}
+
+  // Whether the null flag of state is tracked. MIN/MAX over zero rows are null even for
+  // NOT NULL input, COUNT is never null.
+  bool isNullable() const {
+    return agg_type_ != SQLAgg::kCOUNT &&
+           (!sql_type_info_.get_notnull() || agg_type_ == SQLAgg::kMIN ||
+            agg_type_ == SQLAgg::kMAX);
+  }
 
  private:
-  std::string getAggName(SQLAgg agg_type, SQLTypes sql_type);
+  static jitlib::JITTypeTag getSlotType(SQLAgg agg_type,
+                                        const SQLTypeInfo& sql_type_info,
+                                        const SQLTypeInfo& arg_type_info);
+
+  static int32_t getSlotSize(SQLAgg agg_type, jitlib::JITTypeTag slot_type);
+
+  static std::string getAggName(SQLAgg agg_type,
+                                bool is_distinct,
+                                jitlib::JITTypeTag slot_type,
+                                const SQLTypeInfo& arg_type_info);
 };
 
 using AggExprsInfoVector = std::vector<AggExprsInfo>;
 
+// Source of an aggregation output column, the group-by key or the aggregation at index.
+struct AggOutputColumn {
+  bool is_key;
+  size_t index;
+};
+
+struct CodegenOptions {
+  // Process input a block of 64 rows at a time: null and boolean bitmaps are loaded a
+  // word per block, and a filter is evaluated for the whole block into a selection
+  // vector before the selected rows are consumed.
+  bool enable_block_codegen = false;
+  // Don't copy input columns forwarded to output in generated code, record a selection
+  // vector instead and gather them when output batch is fetched.
+  bool enable_late_materialization = false;
+};
+
 class CodegenContext {
  public:
   CodegenContext() : jit_func_(nullptr) {}
@@ -91,6 +199,10 @@ class CodegenContext {
 
   jitlib::JITFunctionPointer getJITFunction() { return jit_func_; }
 
+  void setCodegenOptions(const CodegenOptions& cgo) { codegen_options_ = cgo; }
+
+  const CodegenOptions& getCodegenOptions() const { return codegen_options_; }
+
   std::pair<jitlib::JITValuePointer, utils::JITExprValue>& getArrowArrayValues(
       size_t local_offset) {
     return arrow_array_values_[local_offset - 1];
@@ -127,8 +239,34 @@ class CodegenContext {
                                            const SQLTypeInfo& type,
                                            CiderSetPtr c_set);
 
+  // Registers a set which is created for every RuntimeContext, used for the sets
+  // holding runtime states (e.g. COUNT DISTINCT).
+  jitlib::JITValuePointer registerCiderSet(const std::string& name,
+                                           const SQLTypeInfo& type,
+                                           CiderSetCreator creator);
+
+  // Registers a hash table which maps group-by keys to aggregation states, the states
+  // are laid out as described by info and initialized with init_state. output_columns
+  // are the sources of the output columns in target order.
+  jitlib::JITValuePointer registerGroupByHashTable(
+      const std::string& name,
+      const std::vector<SQLTypeInfo>& key_types,
+      const std::vector<AggExprsInfo>& info,
+      const std::vector<int8_t>& init_state,
+      const std::vector<AggOutputColumn>& output_columns);
+
+  // Registers a selection vector which records the input row index of every output
+  // row. input_column_ids[i] is the input column forwarded to output column i, or -1 if
+  // output column i is written by generated code.
+  jitlib::JITValuePointer registerSelectionVector(
+      const std::vector<int64_t>& input_column_ids);
+
   RuntimeCtxPtr generateRuntimeCTX(const CiderAllocatorPtr& allocator) const;
 
+  // Whether runtime contexts generated by both are laid out alike, so the query function
+  // of one can run on the runtime context of the other.
+  bool hasSameRuntimeLayout(const CodegenContext& other) const;
+
   struct BatchDescriptor {
     int64_t ctx_id;
     std::string name;
@@ -168,23 +306,15 @@ class CodegenContext {
   struct HashTableDescriptor {
     int64_t ctx_id;
     std::string name;
-    // TODO(qiuyang) : LinearProbeHashTable will provide the default template
-    LinearProbeHashTable<int, std::pair<Batch*, int64_t>, murmurHash, Equal>* hash_table;
-
-    HashTableDescriptor(
-        int64_t id,
-        const std::string& n,
-        // TODO(qiuyang) : LinearProbeHashTable will provide the default template
-        LinearProbeHashTable<int, std::pair<Batch*, int64_t>, murmurHash, Equal>* table =
-            new LinearProbeHashTable<int, std::pair<Batch*, int64_t>, murmurHash, Equal>(
-                16,
-                0))
+    PartitionedJoinHashMap* hash_table;
+
+    HashTableDescriptor(int64_t id,
+                        const std::string& n,
+                        PartitionedJoinHashMap* table = new PartitionedJoinHashMap())
         : ctx_id(id), name(n), hash_table(table) {}
   };
 
-  void setHashTable(
-      LinearProbeHashTable<int, std::pair<Batch*, int64_t>, murmurHash, Equal>&
-          LP_hash_table) {
+  void setHashTable(PartitionedJoinHashMap& LP_hash_table) {
     hashtable_descriptor_.first->hash_table = &LP_hash_table;
   }
 
@@ -193,19 +323,90 @@ class CodegenContext {
     std::string name;
     SQLTypeInfo type;
     CiderSetPtr cider_set;
+    CiderSetCreator creator;
     CiderSetDescriptor(int64_t id,
                        const std::string& n,
                        const SQLTypeInfo& t,
                        CiderSetPtr c_set)
         : ctx_id(id), name(n), type(t), cider_set(std::move(c_set)) {}
+    CiderSetDescriptor(int64_t id,
+                       const std::string& n,
+                       const SQLTypeInfo& t,
+                       CiderSetCreator c)
+        : ctx_id(id), name(n), type(t), cider_set(nullptr), creator(std::move(c)) {}
+  };
+
+  struct GroupByHashTableDescriptor {
+    int64_t ctx_id;
+    std::string name;
+    std::vector<SQLTypeInfo> key_types;
+    std::vector<AggExprsInfo> info_;
+    std::vector<int8_t> init_state;
+    std::vector<AggOutputColumn> output_columns;
+
+    GroupByHashTableDescriptor(int64_t id,
+                               const std::string& n,
+                               const std::vector<SQLTypeInfo>& types,
+                               const std::vector<AggExprsInfo>& info,
+                               const std::vector<int8_t>& state,
+                               const std::vector<AggOutputColumn>& columns)
+        : ctx_id(id)
+        , name(n)
+        , key_types(types)
+        , info_(info)
+        , init_state(state)
+        , output_columns(columns) {}
   };
 
   void setJITModule(jitlib::JITModulePointer jit_module) { jit_module_ = jit_module; }
 
+  jitlib::JITModulePointer getJITModule() const { return jit_module_; }
+
   using BatchDescriptorPtr = std::shared_ptr<BatchDescriptor>;
   using BufferDescriptorPtr = std::shared_ptr<BufferDescriptor>;
   using HashTableDescriptorPtr = std::shared_ptr<HashTableDescriptor>;
   using CiderSetDescriptorPtr = std::shared_ptr<CiderSetDescriptor>;
+  using GroupByHashTableDescriptorPtr = std::shared_ptr<GroupByHashTableDescriptor>;
+
+  struct SelectionDescriptor {
+    int64_t ctx_id;
+    std::vector<int64_t> input_column_ids;
+
+    SelectionDescriptor(int64_t id, const std::vector<int64_t>& ids)
+        : ctx_id(id), input_column_ids(ids) {}
+  };
+
+  using SelectionDescriptorPtr = std::shared_ptr<SelectionDescriptor>;
+
+  struct SortDescriptor {
+    sort::SortKeyLayout layout;
+    std::optional<size_t> limit;
+    size_t offset;
+    sort::CiderSorter::KeyEncodeFunc encode;
+    sort::CiderSorter::KeyCompareFunc compare;
+    // Module of encode and compare, which may outlive this context after tier-up.
+    jitlib::JITModulePointer module;
+
+    SortDescriptor(const sort::SortKeyLayout& l,
+                   std::optional<size_t> lim,
+                   size_t off,
+                   sort::CiderSorter::KeyEncodeFunc e,
+                   sort::CiderSorter::KeyCompareFunc c,
+                   jitlib::JITModulePointer m)
+        : layout(l)
+        , limit(lim)
+        , offset(off)
+        , encode(e)
+        , compare(c)
+        , module(std::move(m)) {}
+  };
+
+  using SortDescriptorPtr = std::shared_ptr<SortDescriptor>;
+
+  // Sets the sort applied to output rows.
+  void setSortDescriptor(const SortDescriptorPtr& descriptor) {
+    sort_descriptor_ = descriptor;
+  }
 
  private:
   std::vector<std::pair<BatchDescriptorPtr, jitlib::JITValuePointer>>
@@ -215,12 +416,17 @@ class CodegenContext {
   std::pair<HashTableDescriptorPtr, jitlib::JITValuePointer> hashtable_descriptor_;
   std::vector<std::pair<CiderSetDescriptorPtr, jitlib::JITValuePointer>>
       cider_set_descriptors_{};
+  std::vector<std::pair<GroupByHashTableDescriptorPtr, jitlib::JITValuePointer>>
+      groupby_hashtable_descriptors_{};
+  SelectionDescriptorPtr selection_descriptor_{nullptr};
+  SortDescriptorPtr sort_descriptor_{nullptr};
   std::vector<std::pair<jitlib::JITValuePointer, utils::JITExprValue>>
       arrow_array_values_{};
 
   jitlib::JITFunctionPointer jit_func_;
   int64_t id_counter_{0};
   jitlib::JITModulePointer jit_module_;
+  CodegenOptions codegen_options_;
 
   int64_t acquireContextID() { return id_counter_++; }
   int64_t getNextContextID() const { return id_counter_; }
@@ -247,6 +453,11 @@ jitlib::JITValuePointer getArrowArrayChild(jitlib::JITValuePointer& arrow_array,
 jitlib::JITValuePointer allocateArrowArrayBuffer(jitlib::JITValuePointer& arrow_array,
                                                  int64_t index,
                                                  jitlib::JITValuePointer& bytes);
+
+// Makes sure the buffer holds at least bytes, returns the (possibly reallocated) buffer.
+jitlib::JITValuePointer reserveArrowArrayBuffer(jitlib::JITValuePointer& arrow_array,
+                                                int64_t index,
+                                                jitlib::JITValuePointer& bytes);
 }  // namespace codegen_utils
 }  // namespace cider::exec::nextgen::context
 
@@ -21,6 +21,8 @@
 #ifndef NEXTGEN_CONTEXT_CONTEXTRUNTIMEFUNCTIONS_H
 #define NEXTGEN_CONTEXT_CONTEXTRUNTIMEFUNCTIONS_H
 
+#include <algorithm>
+
 #include "exec/module/batch/CiderArrowBufferHolder.h"
 #include "exec/nextgen/context/RuntimeContext.h"
 #include "type/data/funcannotations.h"
@@ -73,6 +75,21 @@ extern "C" ALWAYS_INLINE void allocate_arrow_array_buffer(int8_t* array,
   holder->allocBuffer(buffer_index, bytes);
 }
 
+// Grows the buffer geometrically if it is smaller than bytes, returns the buffer which
+// may be moved by reallocation.
+extern "C" ALWAYS_INLINE int8_t* reserve_arrow_array_buffer(int8_t* array,
+                                                            int64_t buffer_index,
+                                                            int64_t bytes) {
+  auto array_pointer = reinterpret_cast<ArrowArray*>(array);
+  auto holder =
+      reinterpret_cast<CiderArrowArrayBufferHolder*>(array_pointer->private_data);
+  size_t capacity = holder->getBufferSizeAt(buffer_index);
+  if (static_cast<size_t>(bytes) > capacity) {
+    holder->allocBuffer(buffer_index, std::max(static_cast<size_t>(bytes), capacity * 2));
+  }
+  return holder->getBufferAs<int8_t>(buffer_index);
+}
+
 extern "C" ALWAYS_INLINE int8_t* get_under_level_buffer_ptr(int8_t* buffer) {
   auto batch_ptr = reinterpret_cast<cider::exec::nextgen::context::Buffer*>(buffer);
   return batch_ptr->getBuffer();
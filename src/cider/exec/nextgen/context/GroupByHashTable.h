@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NEXTGEN_CONTEXT_GROUPBYHASHTABLE_H
+#define NEXTGEN_CONTEXT_GROUPBYHASHTABLE_H
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "cider/CiderAllocator.h"
+#include "exec/nextgen/context/AggStateStore.h"
+#include "function/hash/MurmurHash1Inl.h"
+#include "util/Logger.h"
+
+namespace cider::exec::nextgen::context {
+
+/// \brief Hash table which maps normalized group-by keys to aggregation states.
+///
+/// Keys are normalized into a fixed-width part, one 8-byte slot per key column followed
+/// by one null byte per key column (padded to 8 bytes). Fixed-size columns store their
+/// value in the slot, variable-size columns store their length in the slot and append
+/// their bytes after the fixed part. Entries are allocated from an arena, so the returned
+/// aggregation state pointers stay valid while the slot array grows. Entries, slots and
+/// stores are all allocated from the given allocator, which may track and limit them.
+///
+/// A single fixed-width key skips the normalized key comparison, its value is looked up
+/// in an AggStateStore picked by the key width (single_key_width, 0 for other layouts).
+class GroupByHashTable {
+ public:
+  static constexpr size_t kSlotBytes = 8;
+
+  GroupByHashTable(size_t key_num,
+                   const std::vector<int8_t>& init_state,
+                   const CiderAllocatorPtr& allocator,
+                   size_t single_key_width = 0,
+                   size_t initial_capacity = 1024)
+      : key_num_(key_num)
+      , fixed_key_size_(alignTo8(key_num * kSlotBytes + key_num))
+      , state_size_(init_state.size())
+      , init_state_(init_state)
+      , single_key_width_(key_num == 1 ? single_key_width : 0)
+      , key_buffer_(fixed_key_size_, 0)
+      , allocator_(allocator)
+      , slot_num_(nextPowerOfTwo(initial_capacity))
+      , arena_(allocator) {
+    switch (single_key_width_) {
+      case 0:
+        break;
+      case 1:
+        int8_store_ = std::make_unique<Int8AggStateStore>(allocator);
+        break;
+      case 2:
+        int16_store_ = std::make_unique<Int16AggStateStore>(allocator);
+        break;
+      default:
+        single_key_width_ = 8;
+        int64_store_ = std::make_unique<Int64AggStateStore>(allocator);
+    }
+    // Allocated last, so that nothing leaks if an allocation above exceeds the limit.
+    slots_ = allocateSlots(slot_num_);
+  }
+
+  GroupByHashTable(const GroupByHashTable&) = delete;
+  GroupByHashTable& operator=(const GroupByHashTable&) = delete;
+
+  ~GroupByHashTable() { freeSlots(slots_, slot_num_); }
+
+  /// \brief Fixed-width part of the key under construction, written by generated code.
+  int8_t* getKeyBuffer() { return key_buffer_.data(); }
+
+  size_t getKeyNum() const { return key_num_; }
+
+  size_t getFixedKeySize() const { return fixed_key_size_; }
+
+  size_t getStateSize() const { return state_size_; }
+
+  size_t getEntryNum() const { return entries_.size(); }
+
+  size_t getSingleKeyWidth() const { return single_key_width_; }
+
+  const std::vector<int8_t>& getInitState() const { return init_state_; }
+
+  void setFixedKey(size_t index, int64_t value, bool is_null) {
+    reinterpret_cast<int64_t*>(key_buffer_.data())[index] = is_null ? 0 : value;
+    key_buffer_[key_num_ * kSlotBytes + index] = is_null;
+  }
+
+  void appendVarlenKey(size_t index, const char* ptr, int32_t len, bool is_null) {
+    setFixedKey(index, is_null ? 0 : len, is_null);
+    if (!is_null) {
+      varlen_key_buffer_.insert(varlen_key_buffer_.end(), ptr, ptr + len);
+    }
+  }
+
+  /// \brief Looks up the key under construction and returns its aggregation state,
+  /// inserting a new initialized state if the key doesn't exist.
+  int8_t* findOrInsert() {
+    if (single_key_width_) {
+      return findOrInsertSingleKey();
+    }
+
+    uint64_t hash = MurmurHash64AImpl(key_buffer_.data(), fixed_key_size_, 0);
+    if (!varlen_key_buffer_.empty()) {
+      hash = MurmurHash64AImpl(
+          varlen_key_buffer_.data(), varlen_key_buffer_.size(), hash);
+    }
+    const uint32_t key_size = fixed_key_size_ + varlen_key_buffer_.size();
+
+    size_t mask = slot_num_ - 1;
+    size_t pos = hash & mask;
+    while (slots_[pos].entry) {
+      if (slots_[pos].hash == hash && isKeyEqual(slots_[pos].entry, key_size)) {
+        varlen_key_buffer_.clear();
+        return getEntryState(slots_[pos].entry);
+      }
+      pos = (pos + 1) & mask;
+    }
+
+    int8_t* entry = createEntry(key_size);
+    slots_[pos] = {hash, entry};
+    entries_.push_back(entry);
+    varlen_key_buffer_.clear();
+
+    if (entries_.size() * 2 > slot_num_) {
+      grow();
+    }
+    return getEntryState(entry);
+  }
+
+  /// \brief Looks up a key copied from another table with the same layout, see
+  /// getEntryKey() and getEntryKeySize().
+  int8_t* findOrInsert(const int8_t* key, uint32_t key_size) {
+    memcpy(key_buffer_.data(), key, fixed_key_size_);
+    varlen_key_buffer_.assign(key + fixed_key_size_, key + key_size);
+    return findOrInsert();
+  }
+
+  const int8_t* getEntryKey(size_t index) const {
+    return entries_[index] + sizeof(EntryHeader);
+  }
+
+  uint32_t getEntryKeySize(size_t index) const {
+    return reinterpret_cast<const EntryHeader*>(entries_[index])->key_size;
+  }
+
+  int8_t* getEntryState(size_t index) const { return getEntryState(entries_[index]); }
+
+  /// \brief Hash of the key of an entry, which is independent of the table, so equal keys
+  /// of different tables are placed into the same partition when merging.
+  uint64_t getEntryHash(size_t index) const {
+    const int8_t* key = getEntryKey(index);
+    uint32_t key_size = getEntryKeySize(index);
+    uint64_t hash = MurmurHash64AImpl(key, fixed_key_size_, 0);
+    if (key_size > fixed_key_size_) {
+      hash = MurmurHash64AImpl(key + fixed_key_size_, key_size - fixed_key_size_, hash);
+    }
+    return hash;
+  }
+
+  int64_t getKeySlot(const int8_t* key, size_t index) const {
+    return reinterpret_cast<const int64_t*>(key)[index];
+  }
+
+  bool isKeyNull(const int8_t* key, size_t index) const {
+    return key[key_num_ * kSlotBytes + index];
+  }
+
+  /// \brief Returns the bytes of a variable-size key column, is_varlen marks which key
+  /// columns have appended bytes.
+  const char* getVarlenKey(const int8_t* key,
+                           size_t index,
+                           const std::vector<bool>& is_varlen) const {
+    const char* ptr = reinterpret_cast<const char*>(key + fixed_key_size_);
+    for (size_t i = 0; i < index; ++i) {
+      if (is_varlen[i] && !isKeyNull(key, i)) {
+        ptr += getKeySlot(key, i);
+      }
+    }
+    return ptr;
+  }
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    int8_t* entry;
+  };
+
+  struct EntryHeader {
+    uint32_t key_size;
+    uint32_t reserved;
+  };
+
+  static size_t alignTo8(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+  static size_t nextPowerOfTwo(size_t size) {
+    size_t ret = 1;
+    while (ret < size) {
+      ret <<= 1;
+    }
+    return ret;
+  }
+
+  int8_t* getEntryState(int8_t* entry) const {
+    auto header = reinterpret_cast<EntryHeader*>(entry);
+    return entry + sizeof(EntryHeader) + alignTo8(header->key_size);
+  }
+
+  bool isKeyEqual(int8_t* entry, uint32_t key_size) const {
+    auto header = reinterpret_cast<EntryHeader*>(entry);
+    if (header->key_size != key_size) {
+      return false;
+    }
+    const int8_t* key = entry + sizeof(EntryHeader);
+    return !memcmp(key, key_buffer_.data(), fixed_key_size_) &&
+           !memcmp(key + fixed_key_size_,
+                   varlen_key_buffer_.data(),
+                   varlen_key_buffer_.size());
+  }
+
+  int8_t* createEntry(uint32_t key_size) {
+    // Keep entries 8-bytes aligned, so are the aggregation states.
+    int8_t* entry =
+        arena_.allocate(alignTo8(sizeof(EntryHeader) + alignTo8(key_size) + state_size_));
+    auto header = reinterpret_cast<EntryHeader*>(entry);
+    header->key_size = key_size;
+    header->reserved = 0;
+
+    int8_t* key = entry + sizeof(EntryHeader);
+    memcpy(key, key_buffer_.data(), fixed_key_size_);
+    memcpy(key + fixed_key_size_, varlen_key_buffer_.data(), varlen_key_buffer_.size());
+    memcpy(getEntryState(entry), init_state_.data(), state_size_);
+    return entry;
+  }
+
+  int8_t* createStoredEntry() {
+    int8_t* entry = createEntry(fixed_key_size_);
+    entries_.push_back(entry);
+    return getEntryState(entry);
+  }
+
+  int8_t* findOrInsertNullKey() {
+    if (!null_key_state_) {
+      null_key_state_ = createStoredEntry();
+    }
+    return null_key_state_;
+  }
+
+  int8_t* findOrInsertSingleKey() {
+    if (isKeyNull(key_buffer_.data(), 0)) {
+      return findOrInsertNullKey();
+    }
+    auto create = [this](auto) { return createStoredEntry(); };
+    const int64_t slot = getKeySlot(key_buffer_.data(), 0);
+    switch (single_key_width_) {
+      case 1:
+        return int8_store_->findOrInsert(static_cast<uint8_t>(slot), create);
+      case 2:
+        return int16_store_->findOrInsert(static_cast<uint16_t>(slot), create);
+      default:
+        return int64_store_->findOrInsert(static_cast<uint64_t>(slot), create);
+    }
+  }
+
+  Slot* allocateSlots(size_t num) {
+    auto slots = reinterpret_cast<Slot*>(allocator_->allocate(num * sizeof(Slot)));
+    memset(slots, 0, num * sizeof(Slot));
+    return slots;
+  }
+
+  void freeSlots(Slot* slots, size_t num) {
+    allocator_->deallocate(reinterpret_cast<int8_t*>(slots), num * sizeof(Slot));
+  }
+
+  void grow() {
+    size_t new_num = slot_num_ * 2;
+    Slot* new_slots = allocateSlots(new_num);
+    size_t mask = new_num - 1;
+    for (size_t i = 0; i < slot_num_; ++i) {
+      const Slot& slot = slots_[i];
+      if (slot.entry) {
+        size_t pos = slot.hash & mask;
+        while (new_slots[pos].entry) {
+          pos = (pos + 1) & mask;
+        }
+        new_slots[pos] = slot;
+      }
+    }
+    freeSlots(slots_, slot_num_);
+    slots_ = new_slots;
+    slot_num_ = new_num;
+  }
+
+  const size_t key_num_;
+  const size_t fixed_key_size_;
+  const size_t state_size_;
+  const std::vector<int8_t> init_state_;
+  size_t single_key_width_;
+
+  std::vector<int8_t> key_buffer_;
+  std::vector<char> varlen_key_buffer_;
+
+  CiderAllocatorPtr allocator_;
+  size_t slot_num_;
+  Slot* slots_{nullptr};
+  std::vector<int8_t*> entries_;
+  CiderArenaAllocator arena_;
+
+  std::unique_ptr<Int8AggStateStore> int8_store_;
+  std::unique_ptr<Int16AggStateStore> int16_store_;
+  std::unique_ptr<Int64AggStateStore> int64_store_;
+  int8_t* null_key_state_{nullptr};
+};
+
+using GroupByHashTablePtr = std::unique_ptr<GroupByHashTable>;
+
+}  // namespace cider::exec::nextgen::context
+
+#endif  // NEXTGEN_CONTEXT_GROUPBYHASHTABLE_H
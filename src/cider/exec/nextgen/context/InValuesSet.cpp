@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/nextgen/context/InValuesSet.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "util/Logger.h"
+
+namespace cider::exec::nextgen::context {
+
+namespace {
+uint64_t slotNumFor(size_t value_num) {
+  // keep the load factor at most 1/2 so probing sequences stay short
+  uint64_t slot_num = 16;
+  while (slot_num < value_num * 2) {
+    slot_num <<= 1;
+  }
+  return slot_num;
+}
+
+template <typename T>
+std::vector<T> distinctValues(std::vector<T> values) {
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+}  // namespace
+
+std::vector<int8_t> buildInBitmap(const std::vector<int64_t>& values) {
+  CHECK(!values.empty());
+  auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+  InBitmapHeader header{*min_it, static_cast<uint64_t>(*max_it - *min_it) + 1};
+
+  std::vector<int8_t> set(sizeof(InBitmapHeader) + (header.bits + 7) / 8, 0);
+  memcpy(set.data(), &header, sizeof(InBitmapHeader));
+  auto bitmap = reinterpret_cast<uint8_t*>(set.data() + sizeof(InBitmapHeader));
+  for (auto val : values) {
+    uint64_t offset = static_cast<uint64_t>(val - header.min);
+    bitmap[offset >> 3] |= 1 << (offset & 7);
+  }
+  return set;
+}
+
+std::vector<int8_t> buildInHashSet(const std::vector<int64_t>& values) {
+  auto keys = distinctValues(values);
+  InHashSetHeader header{slotNumFor(keys.size()) - 1,
+                         std::numeric_limits<int64_t>::min()};
+  // keys are sorted, so the first value not in the list is found in one pass
+  for (auto key : keys) {
+    if (key != header.empty_key) {
+      break;
+    }
+    ++header.empty_key;
+  }
+
+  std::vector<int8_t> set(sizeof(InHashSetHeader) + (header.mask + 1) * sizeof(int64_t));
+  memcpy(set.data(), &header, sizeof(InHashSetHeader));
+  auto slots = reinterpret_cast<int64_t*>(set.data() + sizeof(InHashSetHeader));
+  std::fill(slots, slots + header.mask + 1, header.empty_key);
+  for (auto key : keys) {
+    uint64_t i = in_set_hash(key) & header.mask;
+    while (slots[i] != header.empty_key) {
+      i = (i + 1) & header.mask;
+    }
+    slots[i] = key;
+  }
+  return set;
+}
+
+std::vector<int8_t> buildInStringSet(const std::vector<std::string>& values) {
+  auto keys = distinctValues(values);
+  InStringSetHeader header{slotNumFor(keys.size()) - 1};
+  size_t slots_size = (header.mask + 1) * sizeof(InStringSetSlot);
+  size_t payload_size = 0;
+  for (auto& key : keys) {
+    payload_size += key.size();
+  }
+  CHECK_LE(payload_size, size_t(std::numeric_limits<int32_t>::max()));
+
+  std::vector<int8_t> set(sizeof(InStringSetHeader) + slots_size + payload_size);
+  memcpy(set.data(), &header, sizeof(InStringSetHeader));
+  auto slots = reinterpret_cast<InStringSetSlot*>(set.data() + sizeof(InStringSetHeader));
+  auto payload = reinterpret_cast<char*>(slots + header.mask + 1);
+  std::fill(slots, slots + header.mask + 1, InStringSetSlot{0, -1, 0});
+  int32_t offset = 0;
+  for (auto& key : keys) {
+    int32_t len = key.size();
+    uint64_t prefix = in_set_string_prefix(key.data(), len);
+    uint64_t i = in_set_string_hash(prefix, len) & header.mask;
+    while (slots[i].len >= 0) {
+      i = (i + 1) & header.mask;
+    }
+    slots[i] = InStringSetSlot{prefix, len, offset};
+    memcpy(payload + offset, key.data(), len);
+    offset += len;
+  }
+  return set;
+}
+
+}  // namespace cider::exec::nextgen::context
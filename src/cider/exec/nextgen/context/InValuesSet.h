@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NEXTGEN_CONTEXT_INVALUESSET_H
+#define NEXTGEN_CONTEXT_INVALUESSET_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace cider::exec::nextgen::context {
+
+// Lookup structures for constant IN lists. They are built once at compile time into a
+// flat byte array, which is copied into a registered buffer, so that the generated code
+// only reads plain memory through the inlined lookups below.
+
+// Bitmap over [min, min + bits) for dense integer lists.
+struct InBitmapHeader {
+  int64_t min;
+  uint64_t bits;
+};
+
+// Open-addressing table of int64 keys (doubles are stored as their bit pattern), slots
+// holding empty_key are free. empty_key is not in the list, but may still be probed.
+struct InHashSetHeader {
+  uint64_t mask;
+  int64_t empty_key;
+};
+
+// Open-addressing table of strings keyed by the first 8 bytes and the length, the full
+// strings are stored after the slots and only compared when the prefix matches.
+struct InStringSetHeader {
+  uint64_t mask;
+};
+
+struct InStringSetSlot {
+  uint64_t prefix;
+  int32_t len;  // -1 for a free slot
+  int32_t offset;
+};
+
+inline uint64_t in_set_hash(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+inline int64_t in_set_double_key(double val) {
+  // +0.0 and -0.0 are equal
+  val = val == 0.0 ? 0.0 : val;
+  int64_t key;
+  memcpy(&key, &val, sizeof(key));
+  return key;
+}
+
+inline uint64_t in_set_string_prefix(const char* str, int32_t len) {
+  uint64_t prefix = 0;
+  for (int32_t i = 0; i < len && i < 8; ++i) {
+    prefix |= static_cast<uint64_t>(static_cast<uint8_t>(str[i])) << (i * 8);
+  }
+  return prefix;
+}
+
+inline uint64_t in_set_string_hash(uint64_t prefix, int32_t len) {
+  return in_set_hash(prefix ^ (static_cast<uint64_t>(len) << 56));
+}
+
+inline bool in_bitmap_contains(const int8_t* set, int64_t val) {
+  auto header = reinterpret_cast<const InBitmapHeader*>(set);
+  auto bitmap = reinterpret_cast<const uint8_t*>(set + sizeof(InBitmapHeader));
+  uint64_t offset = static_cast<uint64_t>(val) - static_cast<uint64_t>(header->min);
+  return offset < header->bits && (bitmap[offset >> 3] >> (offset & 7)) & 1;
+}
+
+inline bool in_hash_set_contains(const int8_t* set, int64_t val) {
+  auto header = reinterpret_cast<const InHashSetHeader*>(set);
+  auto slots = reinterpret_cast<const int64_t*>(set + sizeof(InHashSetHeader));
+  for (uint64_t i = in_set_hash(val) & header->mask;; i = (i + 1) & header->mask) {
+    if (slots[i] == header->empty_key) {
+      return false;
+    }
+    if (slots[i] == val) {
+      return true;
+    }
+  }
+}
+
+inline bool in_string_set_contains(const int8_t* set, const char* str, int32_t len) {
+  auto header = reinterpret_cast<const InStringSetHeader*>(set);
+  auto slots = reinterpret_cast<const InStringSetSlot*>(set + sizeof(InStringSetHeader));
+  auto payload = reinterpret_cast<const char*>(slots + header->mask + 1);
+  uint64_t prefix = in_set_string_prefix(str, len);
+  for (uint64_t i = in_set_string_hash(prefix, len) & header->mask;;
+       i = (i + 1) & header->mask) {
+    const auto& slot = slots[i];
+    if (slot.len < 0) {
+      return false;
+    }
+    if (slot.prefix == prefix && slot.len == len &&
+        (len <= 8 || !memcmp(payload + slot.offset + 8, str + 8, len - 8))) {
+      return true;
+    }
+  }
+}
+
+// Builders, duplicated values are allowed and NULLs must be filtered out by the caller.
+std::vector<int8_t> buildInBitmap(const std::vector<int64_t>& values);
+
+std::vector<int8_t> buildInHashSet(const std::vector<int64_t>& values);
+
+std::vector<int8_t> buildInStringSet(const std::vector<std::string>& values);
+
+}  // namespace cider::exec::nextgen::context
+
+#endif  // NEXTGEN_CONTEXT_INVALUESSET_H
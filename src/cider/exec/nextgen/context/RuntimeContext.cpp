@@ -20,10 +20,32 @@
  */
 
 #include "exec/nextgen/context/RuntimeContext.h"
+
+#include <algorithm>
+
 #include "exec/module/batch/CiderArrowBufferHolder.h"
+#include "exec/nextgen/context/AggStateMerger.h"
 #include "exec/nextgen/operators/extractor/AggExtractorBuilder.h"
 
 namespace cider::exec::nextgen::context {
+namespace {
+// Width of the single fixed-size group-by key, 0 if the keys need the generic layout.
+size_t getSingleKeyWidth(const std::vector<SQLTypeInfo>& key_types) {
+  if (key_types.size() != 1 || key_types[0].is_string()) {
+    return 0;
+  }
+  switch (key_types[0].get_type()) {
+    case kBOOLEAN:
+    case kTINYINT:
+      return 1;
+    case kSMALLINT:
+      return 2;
+    default:
+      return 8;
+  }
+}
+}  // namespace
+
 void RuntimeContext::addBatch(const CodegenContext::BatchDescriptorPtr& descriptor) {
   batch_holder_.emplace_back(descriptor, nullptr);
 }
@@ -42,7 +64,23 @@ void RuntimeContext::addCiderSet(
   cider_set_holder_.emplace_back(descriptor, nullptr);
 }
 
+void RuntimeContext::addGroupByHashTable(
+    const CodegenContext::GroupByHashTableDescriptorPtr& descriptor) {
+  groupby_hashtable_holder_.emplace_back(descriptor, nullptr);
+}
+
+void RuntimeContext::addSelection(
+    const CodegenContext::SelectionDescriptorPtr& descriptor) {
+  selection_holder_ = descriptor;
+}
+
+void RuntimeContext::addSort(const CodegenContext::SortDescriptorPtr& descriptor) {
+  sort_holder_ = descriptor;
+}
+
 void RuntimeContext::instantiate(const CiderAllocatorPtr& allocator) {
+  allocator_ = allocator;
+
   // Instantiation of batches.
   for (auto& batch_desc : batch_holder_) {
     if (nullptr == batch_desc.second) {
@@ -69,10 +107,39 @@ void RuntimeContext::instantiate(const CiderAllocatorPtr& allocator) {
 
   for (auto& cider_set_desc : cider_set_holder_) {
     if (nullptr == cider_set_desc.second) {
-      runtime_ctx_pointers_[cider_set_desc.first->ctx_id] =
-          cider_set_desc.first->cider_set.get();
+      if (cider_set_desc.first->creator) {
+        cider_set_desc.second = cider_set_desc.first->creator();
+        runtime_ctx_pointers_[cider_set_desc.first->ctx_id] =
+            cider_set_desc.second.get();
+      } else {
+        runtime_ctx_pointers_[cider_set_desc.first->ctx_id] =
+            cider_set_desc.first->cider_set.get();
+      }
     }
   }
+
+  // Instantiation of group-by hashtables.
+  for (auto& hashtable_desc : groupby_hashtable_holder_) {
+    if (nullptr == hashtable_desc.second) {
+      hashtable_desc.second = std::make_unique<GroupByHashTable>(
+          hashtable_desc.first->key_types.size(),
+          hashtable_desc.first->init_state,
+          allocator,
+          getSingleKeyWidth(hashtable_desc.first->key_types));
+      runtime_ctx_pointers_[hashtable_desc.first->ctx_id] = hashtable_desc.second.get();
+    }
+  }
+
+  // Instantiation of sorter, which sorts the rows of output batch.
+  if (sort_holder_ && nullptr == sorter_) {
+    sorter_ = std::make_unique<sort::CiderSorter>(sort_holder_->layout,
+                                                  sort_holder_->encode,
+                                                  sort_holder_->compare,
+                                                  sort_holder_->limit,
+                                                  sort_holder_->offset,
+                                                  batch_holder_.back().first->type,
+                                                  allocator);
+  }
 }
 
 void allocateBatchMem(ArrowArray* array,
@@ -95,6 +162,210 @@ void allocateBatchMem(ArrowArray* array,
   array->length = length;
 }
 
+namespace {
+int64_t getFixedWidth(const char* format) {
+  switch (format[0]) {
+    case 'c':
+    case 'C':
+      return 1;
+    case 's':
+    case 'S':
+      return 2;
+    case 'i':
+    case 'I':
+    case 'f':
+      return 4;
+    case 'l':
+    case 'L':
+    case 'g':
+      return 8;
+    case 't':
+      // date32 and time32 take 4 bytes, other temporal types take 8 bytes.
+      if ((format[1] == 'd' && format[2] == 'D') ||
+          (format[1] == 't' && (format[2] == 's' || format[2] == 'm'))) {
+        return 4;
+      }
+      return 8;
+    default:
+      LOG(FATAL) << "Unsupported format in late materialization: " << format;
+  }
+  return 0;
+}
+
+template <typename T>
+void gatherFixedWidth(const T* input,
+                      T* output,
+                      const int32_t* selection,
+                      int64_t length,
+                      int64_t offset) {
+  for (int64_t i = 0; i < length; ++i) {
+    output[i] = input[selection[i] + offset];
+  }
+}
+
+void gatherBits(const uint8_t* input,
+                uint8_t* output,
+                const int32_t* selection,
+                int64_t length,
+                int64_t offset) {
+  for (int64_t i = 0; i < length; ++i) {
+    if (CiderBitUtils::isBitSetAt(input, selection[i] + offset)) {
+      CiderBitUtils::setBitAt(output, i);
+    }
+  }
+}
+
+void gatherColumn(const ArrowArray* input,
+                  const ArrowSchema* schema,
+                  ArrowArray* output,
+                  const int32_t* selection,
+                  int64_t length) {
+  auto holder = reinterpret_cast<CiderArrowArrayBufferHolder*>(output->private_data);
+  const int64_t offset = input->offset;
+  const int64_t bitmap_bytes = (length + 7) / 8;
+
+  if (input->buffers[0]) {
+    holder->allocBuffer(0, bitmap_bytes);
+    auto nulls = holder->getBufferAs<uint8_t>(0);
+    memset(nulls, 0, bitmap_bytes);
+    gatherBits(reinterpret_cast<const uint8_t*>(input->buffers[0]),
+               nulls,
+               selection,
+               length,
+               offset);
+  }
+
+  switch (schema->format[0]) {
+    case 'b': {
+      holder->allocBuffer(1, bitmap_bytes);
+      auto values = holder->getBufferAs<uint8_t>(1);
+      memset(values, 0, bitmap_bytes);
+      gatherBits(reinterpret_cast<const uint8_t*>(input->buffers[1]),
+                 values,
+                 selection,
+                 length,
+                 offset);
+      break;
+    }
+    case 'u': {
+      auto input_offsets = reinterpret_cast<const int32_t*>(input->buffers[1]);
+      auto input_data = reinterpret_cast<const char*>(input->buffers[2]);
+      holder->allocBuffer(1, sizeof(int32_t) * (length + 1));
+      auto offsets = holder->getBufferAs<int32_t>(1);
+      offsets[0] = 0;
+      for (int64_t i = 0; i < length; ++i) {
+        int64_t row = selection[i] + offset;
+        offsets[i + 1] = offsets[i] + input_offsets[row + 1] - input_offsets[row];
+      }
+      holder->allocBuffer(2, offsets[length]);
+      auto data = holder->getBufferAs<char>(2);
+      for (int64_t i = 0; i < length; ++i) {
+        int64_t row = selection[i] + offset;
+        memcpy(data + offsets[i],
+               input_data + input_offsets[row],
+               offsets[i + 1] - offsets[i]);
+      }
+      break;
+    }
+    default: {
+      int64_t width = getFixedWidth(schema->format);
+      holder->allocBuffer(1, width * length);
+      switch (width) {
+        case 1:
+          gatherFixedWidth(reinterpret_cast<const int8_t*>(input->buffers[1]),
+                           holder->getBufferAs<int8_t>(1),
+                           selection,
+                           length,
+                           offset);
+          break;
+        case 2:
+          gatherFixedWidth(reinterpret_cast<const int16_t*>(input->buffers[1]),
+                           holder->getBufferAs<int16_t>(1),
+                           selection,
+                           length,
+                           offset);
+          break;
+        case 4:
+          gatherFixedWidth(reinterpret_cast<const int32_t*>(input->buffers[1]),
+                           holder->getBufferAs<int32_t>(1),
+                           selection,
+                           length,
+                           offset);
+          break;
+        default:
+          gatherFixedWidth(reinterpret_cast<const int64_t*>(input->buffers[1]),
+                           holder->getBufferAs<int64_t>(1),
+                           selection,
+                           length,
+                           offset);
+      }
+    }
+  }
+  output->length = length;
+}
+
+// Owns an input column moved to output, the original ArrowArray is kept in private_data
+// and released with the output.
+void releaseForwardedArray(ArrowArray* array) {
+  auto original = reinterpret_cast<ArrowArray*>(array->private_data);
+  if (original->release) {
+    original->release(original);
+  }
+  delete original;
+  array->private_data = nullptr;
+  array->release = nullptr;
+}
+
+void forwardColumn(ArrowArray* input, ArrowArray* output) {
+  if (output->release) {
+    output->release(output);
+  }
+  auto original = new ArrowArray(*input);
+  *output = *input;
+  output->private_data = original;
+  output->release = releaseForwardedArray;
+  input->release = nullptr;
+}
+}  // namespace
+
+void RuntimeContext::materializeOutputBatch(ArrowArray* input) {
+  if (nullptr == selection_holder_) {
+    return;
+  }
+  auto selection_array =
+      reinterpret_cast<Batch*>(runtime_ctx_pointers_[selection_holder_->ctx_id])
+          ->getArray();
+  auto selection = reinterpret_cast<const int32_t*>(selection_array->buffers[1]);
+
+  Batch* batch = batch_holder_.back().second.get();
+  auto output_array = batch->getArray();
+  auto output_schema = batch->getSchema();
+  const int64_t length = output_array->length;
+
+  bool select_all = length == input->length;
+  for (int64_t i = 0; select_all && i < length; ++i) {
+    select_all = selection[i] == i;
+  }
+
+  const auto& input_column_ids = selection_holder_->input_column_ids;
+  std::vector<bool> moved(input->n_children, false);
+  for (size_t i = 0; i < input_column_ids.size(); ++i) {
+    int64_t id = input_column_ids[i];
+    if (id < 0) {
+      continue;
+    }
+    ArrowArray* input_child = input->children[id];
+    ArrowArray* output_child = output_array->children[i];
+    if (select_all && !moved[id] && input_child->release) {
+      forwardColumn(input_child, output_child);
+      moved[id] = true;
+    } else {
+      gatherColumn(
+          input_child, output_schema->children[i], output_child, selection, length);
+    }
+  }
+}
+
 Batch* RuntimeContext::getNonGroupByAggOutputBatch() {
   AggExprsInfoVector& info = reinterpret_cast<CodegenContext::AggBufferDescriptor*>(
                                  buffer_holder_.back().first.get())
@@ -125,4 +396,208 @@ Batch* RuntimeContext::getNonGroupByAggOutputBatch() {
   return batch;
 }
 
+namespace {
+// keys are entry keys of hash tables sharing the layout of hash_table.
+void extractGroupByKey(const GroupByHashTable& hash_table,
+                       const std::vector<const int8_t*>& keys,
+                       const std::vector<SQLTypeInfo>& key_types,
+                       size_t key_index,
+                       ArrowArray* array) {
+  auto holder = reinterpret_cast<CiderArrowArrayBufferHolder*>(array->private_data);
+  const size_t entry_num = keys.size();
+  const auto& type = key_types[key_index];
+  const bool is_bool = type.get_type() == kBOOLEAN;
+  const bool is_varlen = type.is_string();
+
+  std::vector<bool> varlen_keys(key_types.size());
+  for (size_t i = 0; i < key_types.size(); ++i) {
+    varlen_keys[i] = key_types[i].is_string();
+  }
+
+  allocateBatchMem(array, entry_num, true);
+  uint8_t* null_buffer = holder->getBufferAs<uint8_t>(0);
+
+  if (is_varlen) {
+    holder->allocBuffer(1, sizeof(int32_t) * (entry_num + 1));
+    size_t total_len = 0;
+    for (size_t i = 0; i < entry_num; ++i) {
+      auto key = keys[i];
+      if (!hash_table.isKeyNull(key, key_index)) {
+        total_len += hash_table.getKeySlot(key, key_index);
+      }
+    }
+    holder->allocBuffer(2, total_len);
+    auto offsets = holder->getBufferAs<int32_t>(1);
+    auto data = holder->getBufferAs<char>(2);
+    offsets[0] = 0;
+    for (size_t i = 0; i < entry_num; ++i) {
+      auto key = keys[i];
+      int32_t len = 0;
+      if (hash_table.isKeyNull(key, key_index)) {
+        CiderBitUtils::clearBitAt(null_buffer, i);
+      } else {
+        len = hash_table.getKeySlot(key, key_index);
+        memcpy(data + offsets[i],
+               hash_table.getVarlenKey(key, key_index, varlen_keys),
+               len);
+      }
+      offsets[i + 1] = offsets[i] + len;
+    }
+    return;
+  }
+
+  if (is_bool) {
+    holder->allocBuffer(1, (entry_num + 7) / 8);
+  } else {
+    holder->allocBuffer(1, type.get_size() * entry_num);
+  }
+  auto values = holder->getBufferAs<int8_t>(1);
+  for (size_t i = 0; i < entry_num; ++i) {
+    auto key = keys[i];
+    if (hash_table.isKeyNull(key, key_index)) {
+      CiderBitUtils::clearBitAt(null_buffer, i);
+      continue;
+    }
+    int64_t slot = hash_table.getKeySlot(key, key_index);
+    if (is_bool) {
+      if (slot) {
+        CiderBitUtils::setBitAt(reinterpret_cast<uint8_t*>(values), i);
+      }
+    } else {
+      // Keys are normalized into the low bytes of the slot.
+      memcpy(values + i * type.get_size(), &slot, type.get_size());
+    }
+  }
+}
+}  // namespace
+
+namespace {
+// Estimated output bytes of a group excluding variable-size keys.
+size_t getFixedGroupBytes(const std::vector<SQLTypeInfo>& key_types,
+                          const AggExprsInfoVector& info,
+                          const std::vector<AggOutputColumn>& output_columns) {
+  size_t bytes = 0;
+  for (const auto& column : output_columns) {
+    if (column.is_key) {
+      const auto& type = key_types[column.index];
+      bytes += type.is_string() ? sizeof(int32_t) : std::max(type.get_size(), 1);
+    } else {
+      bytes += info[column.index].sql_type_info_.get_size();
+    }
+  }
+  return bytes;
+}
+}  // namespace
+
+Batch* RuntimeContext::getGroupByAggOutputBatch(size_t max_rows, size_t max_bytes) {
+  auto& descriptor = groupby_hashtable_holder_.back().first;
+  AggExprsInfoVector& info = descriptor->info_;
+  const auto& key_types = descriptor->key_types;
+  const auto& output_columns = descriptor->output_columns;
+  Batch* batch = batch_holder_.back().second.get();
+  if (!batch->getArray()->release) {
+    // Previous output has been moved out.
+    batch->reset(batch_holder_.back().first->type, allocator_);
+  }
+
+  auto hash_tables = getGroupByHashTables();
+  const size_t fixed_group_bytes = getFixedGroupBytes(key_types, info, output_columns);
+  std::vector<const int8_t*> keys;
+  std::vector<const int8_t*> states;
+  size_t bytes = 0;
+  while (groupby_output_table_ < hash_tables.size()) {
+    auto hash_table = hash_tables[groupby_output_table_];
+    if (groupby_output_entry_ == hash_table->getEntryNum()) {
+      ++groupby_output_table_;
+      groupby_output_entry_ = 0;
+      continue;
+    }
+    const size_t group_bytes = fixed_group_bytes +
+                               hash_table->getEntryKeySize(groupby_output_entry_) -
+                               hash_table->getFixedKeySize();
+    if ((max_rows && keys.size() == max_rows) ||
+        (max_bytes && !keys.empty() && bytes + group_bytes > max_bytes)) {
+      break;
+    }
+    bytes += group_bytes;
+    keys.push_back(hash_table->getEntryKey(groupby_output_entry_));
+    states.push_back(hash_table->getEntryState(groupby_output_entry_));
+    ++groupby_output_entry_;
+  }
+  const size_t entry_num = states.size();
+
+  auto arrow_array = batch->getArray();
+  allocateBatchMem(arrow_array, entry_num);
+
+  for (size_t i = 0; i < output_columns.size(); ++i) {
+    auto child_array = arrow_array->children[i];
+    const size_t index = output_columns[i].index;
+    if (output_columns[i].is_key) {
+      extractGroupByKey(*hash_tables.front(), keys, key_types, index, child_array);
+      continue;
+    }
+    allocateBatchMem(
+        child_array, entry_num, false, info[index].sql_type_info_.get_size());
+    std::unique_ptr<operators::NextgenAggExtractor> extractor =
+        operators::NextgenAggExtractorBuilder::buildNextgenAggExtractor(
+            states.empty() ? nullptr : states.front(), info[index]);
+    extractor->extract(states, child_array);
+  }
+
+  return batch;
+}
+
+std::vector<const GroupByHashTable*> RuntimeContext::getGroupByHashTables() const {
+  std::vector<const GroupByHashTable*> hash_tables;
+  if (merged_groupby_hashtables_.empty()) {
+    hash_tables.push_back(groupby_hashtable_holder_.back().second.get());
+  }
+  for (auto& hash_table : merged_groupby_hashtables_) {
+    hash_tables.push_back(hash_table.get());
+  }
+  return hash_tables;
+}
+
+void RuntimeContext::mergePartialAggStates(const std::vector<RuntimeContext*>& partials,
+                                           const CiderAllocatorPtr& allocator,
+                                           size_t partition_num) {
+  if (groupby_hashtable_holder_.empty()) {
+    AggExprsInfoVector& info = reinterpret_cast<CodegenContext::AggBufferDescriptor*>(
+                                   buffer_holder_.back().first.get())
+                                   ->info_;
+    int8_t* buf = buffer_holder_.back().second->getBuffer();
+    for (auto partial : partials) {
+      mergeAggStates(buf, partial->buffer_holder_.back().second->getBuffer(), info);
+    }
+    return;
+  }
+
+  auto hash_tables = getGroupByHashTables();
+  for (auto partial : partials) {
+    auto partial_tables = partial->getGroupByHashTables();
+    hash_tables.insert(hash_tables.end(), partial_tables.begin(), partial_tables.end());
+  }
+  auto merged = mergeGroupByHashTables(hash_tables,
+                                       groupby_hashtable_holder_.back().first->info_,
+                                       allocator,
+                                       partition_num);
+  merged_groupby_hashtables_.swap(merged);
+  groupby_output_table_ = 0;
+  groupby_output_entry_ = 0;
+}
+
+bool RuntimeContext::hasMoreAggOutput() const {
+  if (groupby_hashtable_holder_.empty()) {
+    return false;
+  }
+  auto hash_tables = getGroupByHashTables();
+  size_t entry = groupby_output_entry_;
+  for (size_t i = groupby_output_table_; i < hash_tables.size(); ++i, entry = 0) {
+    if (entry < hash_tables[i]->getEntryNum()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace cider::exec::nextgen::context
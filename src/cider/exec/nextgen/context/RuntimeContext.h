@@ -24,6 +24,7 @@
 #include "exec/nextgen/context/Buffer.h"
 #include "exec/nextgen/context/CiderSet.h"
 #include "exec/nextgen/context/CodegenContext.h"
+#include "exec/nextgen/context/GroupByHashTable.h"
 #include "exec/nextgen/context/StringHeap.h"
 #include "exec/nextgen/utils/FunctorUtils.h"
 #include "util/CiderBitUtils.h"
@@ -45,9 +46,20 @@ class RuntimeContext {
 
   void addHashTable(const CodegenContext::HashTableDescriptorPtr& descriptor);
   void addCiderSet(const CodegenContext::CiderSetDescriptorPtr& descriptor);
+  void addGroupByHashTable(
+      const CodegenContext::GroupByHashTableDescriptorPtr& descriptor);
+  void addSelection(const CodegenContext::SelectionDescriptorPtr& descriptor);
+  void addSort(const CodegenContext::SortDescriptorPtr& descriptor);
 
   void instantiate(const CiderAllocatorPtr& allocator);
 
+  // Replaces the join hash table probed by generated code with the one built from
+  // build side, the table must outlive this context.
+  void setJoinHashTable(PartitionedJoinHashMap* hash_table) {
+    CHECK(hashtable_holder_);
+    runtime_ctx_pointers_[hashtable_holder_->ctx_id] = hash_table;
+  }
+
   // TBD: Currently, last batch would be output batch under all known scenarios.
   Batch* getOutputBatch() {
     if (batch_holder_.empty()) {
@@ -76,16 +88,59 @@ class RuntimeContext {
     return batch;
   }
 
+  // Fills output columns forwarded from input according to the selection vector. The
+  // input columns are moved to output without copy if all input rows are selected, so
+  // this should be called before output batch is fetched and input is released.
+  void materializeOutputBatch(ArrowArray* input);
+
   Batch* getNonGroupByAggOutputBatch();
 
+  // Converts the groups of the group-by hash table following the last output into
+  // output batch, whose columns are the keys and aggregations in the order of targets.
+  // The batch holds at most max_rows groups of about max_bytes bytes, 0 means unbounded.
+  Batch* getGroupByAggOutputBatch(size_t max_rows = 0, size_t max_bytes = 0);
+
+  // Merges aggregation states of partial contexts compiled from the same query into
+  // this one. Group-by states are merged into partition_num tables concurrently, the
+  // output batch then holds the groups of all partitions.
+  void mergePartialAggStates(const std::vector<RuntimeContext*>& partials,
+                             const CiderAllocatorPtr& allocator,
+                             size_t partition_num);
+
+  Batch* getAggOutputBatch(size_t max_rows = 0, size_t max_bytes = 0) {
+    return groupby_hashtable_holder_.empty()
+               ? getNonGroupByAggOutputBatch()
+               : getGroupByAggOutputBatch(max_rows, max_bytes);
+  }
+
+  // Whether some groups are left after the last getAggOutputBatch().
+  bool hasMoreAggOutput() const;
+
+  // Sorter of output rows, null if the query has no sort.
+  sort::CiderSorter* getSorter() { return sorter_.get(); }
+
  private:
+  // Tables holding the group-by states, the merged partitions if any.
+  std::vector<const GroupByHashTable*> getGroupByHashTables() const;
+
   std::vector<void*> runtime_ctx_pointers_;
   std::vector<std::pair<CodegenContext::BatchDescriptorPtr, BatchPtr>> batch_holder_;
   std::vector<std::pair<CodegenContext::BufferDescriptorPtr, BufferPtr>> buffer_holder_;
   std::vector<std::pair<CodegenContext::CiderSetDescriptorPtr, CiderSetPtr>>
       cider_set_holder_;
+  std::vector<
+      std::pair<CodegenContext::GroupByHashTableDescriptorPtr, GroupByHashTablePtr>>
+      groupby_hashtable_holder_;
+  std::vector<GroupByHashTablePtr> merged_groupby_hashtables_;
+  // Position of the next group to output, as table index and entry index.
+  size_t groupby_output_table_{0};
+  size_t groupby_output_entry_{0};
+  CiderAllocatorPtr allocator_;
   std::shared_ptr<StringHeap> string_heap_ptr_;
   CodegenContext::HashTableDescriptorPtr hashtable_holder_;
+  CodegenContext::SelectionDescriptorPtr selection_holder_;
+  CodegenContext::SortDescriptorPtr sort_holder_;
+  sort::CiderSorterPtr sorter_;
 };
 
 using RuntimeCtxPtr = std::unique_ptr<RuntimeContext>;
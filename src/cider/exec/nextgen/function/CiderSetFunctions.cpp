@@ -19,28 +19,27 @@
  * under the License.
  */
 
-#include "exec/nextgen/context/CiderSet.h"
+#include "exec/nextgen/context/InValuesSet.h"
 
-#define DEF_CIDER_INT64_SET_CONTAINS(type)                                        \
-  extern "C" ALWAYS_INLINE bool cider_set_contains_##type##_val(int8_t* set_ptr,  \
-                                                                const type val) { \
-    auto cider_set =                                                              \
-        reinterpret_cast<cider::exec::nextgen::context::CiderInt64Set*>(set_ptr); \
-    return cider_set->contains(val);                                              \
-  }
+// Lookups of constant IN lists, see InValuesSet.h for the layouts.
+extern "C" ALWAYS_INLINE bool cider_in_bitmap_contains(int8_t* set_ptr,
+                                                       const int64_t val) {
+  return cider::exec::nextgen::context::in_bitmap_contains(set_ptr, val);
+}
 
-DEF_CIDER_INT64_SET_CONTAINS(int8_t)
-DEF_CIDER_INT64_SET_CONTAINS(int16_t)
-DEF_CIDER_INT64_SET_CONTAINS(int32_t)
-DEF_CIDER_INT64_SET_CONTAINS(int64_t)
+extern "C" ALWAYS_INLINE bool cider_in_hash_set_contains(int8_t* set_ptr,
+                                                         const int64_t val) {
+  return cider::exec::nextgen::context::in_hash_set_contains(set_ptr, val);
+}
 
-#define DEF_CIDER_DOUBLE_SET_CONTAINS(type)                                        \
-  extern "C" ALWAYS_INLINE bool cider_set_contains_##type##_val(int8_t* set_ptr,   \
-                                                                const type val) {  \
-    auto cider_set =                                                               \
-        reinterpret_cast<cider::exec::nextgen::context::CiderDoubleSet*>(set_ptr); \
-    return cider_set->contains(val);                                               \
-  }
+extern "C" ALWAYS_INLINE bool cider_in_hash_set_contains_double(int8_t* set_ptr,
+                                                                const double val) {
+  using namespace cider::exec::nextgen::context;
+  return in_hash_set_contains(set_ptr, in_set_double_key(val));
+}
 
-DEF_CIDER_DOUBLE_SET_CONTAINS(float)
-DEF_CIDER_DOUBLE_SET_CONTAINS(double)
+extern "C" ALWAYS_INLINE bool cider_in_string_set_contains(int8_t* set_ptr,
+                                                           const char* str,
+                                                           const int32_t len) {
+  return cider::exec::nextgen::context::in_string_set_contains(set_ptr, str, len);
+}
@@ -36,14 +36,13 @@ extern "C" RUNTIME_EXPORT int64_t cider_substring(const char* str, int pos, int
   return pack_string((const int8_t*)ret_ptr, (const int32_t)len);
 }
 
-// pos parameter starts from 1 rather than 0
+// pos parameter starts from 1 rather than 0. The substring refers to str, which stays
+// valid while the row is evaluated, so nothing is copied into the string heap.
 extern "C" RUNTIME_EXPORT int64_t cider_substring_extra(char* string_heap_ptr,
                                                         const char* str,
                                                         int pos,
                                                         int len) {
-  StringHeap* ptr = reinterpret_cast<StringHeap*>(string_heap_ptr);
-  string_t s = ptr->addString(str + pos - 1, len);
-  return pack_string_t(s);
+  return pack_string((const int8_t*)str + pos - 1, (const int32_t)len);
 }
 
 // pos starts with 1. A negative starting position is interpreted as being relative
@@ -31,6 +31,9 @@ class JITModule {
  public:
   virtual void finish() = 0;
 
+  // Optimized IR of the module, only available if it's kept by compilation options.
+  virtual const std::string& getIR() const = 0;
+
  protected:
   virtual JITFunctionPointer createJITFunction(
       const JITFunctionDescriptor& descriptor) = 0;
@@ -109,6 +109,15 @@ static llvm::SubtargetFeatures buildTargetFeatures(const CompilationOptions& co)
   return features;
 }
 
+static llvm::CodeGenOpt::Level getCodeGenOptLevel(const CompilationOptions& co) {
+  if (LLVMJITOptimizeLevel::DEBUG == co.optimize_level) {
+    // cheapest codegen, mainly relies on FastISel
+    return llvm::CodeGenOpt::None;
+  }
+  return co.aggressive_jit_compile ? llvm::CodeGenOpt::Aggressive
+                                   : llvm::CodeGenOpt::Default;
+}
+
 llvm::TargetMachine* LLVMJITEngineBuilder::buildTargetMachine() {
   return host_target->createTargetMachine(process_triple,
                                           process_name,
@@ -116,14 +125,12 @@ llvm::TargetMachine* LLVMJITEngineBuilder::buildTargetMachine() {
                                           buildTargetOptions(),
                                           llvm::None,
                                           llvm::None,
-                                          module_.co_.aggressive_jit_compile
-                                              ? llvm::CodeGenOpt::Aggressive
-                                              : llvm::CodeGenOpt::Default,
+                                          getCodeGenOptLevel(module_.co_),
                                           true);
 }
 
 void LLVMJITEngineBuilder::dumpASM(LLVMJITEngine& engine) {
-  const std::string fname = llvm_module_->getModuleIdentifier() + ".s";
+  const std::string fname = module_.dump_file_prefix_ + ".s";
 
   std::error_code error_code;
   llvm::raw_fd_ostream file(fname, error_code, llvm::sys::fs::F_None);
@@ -143,6 +150,25 @@ void LLVMJITEngineBuilder::dumpASM(LLVMJITEngine& engine) {
   }
 }
 
+void LLVMJITEngineBuilder::setObjectCache(LLVMJITEngine& engine) {
+  const auto& co = module_.co_;
+  std::string ir = module_.ir_;
+  if (ir.empty()) {
+    llvm::raw_string_ostream os(ir);
+    os << *llvm_module_;
+    os.flush();
+  }
+  auto key = LLVMJITObjectCache::makeKey(
+      ir,
+      process_triple,
+      process_name,
+      engine.engine->getTargetMachine()->getTargetFeatureString().str());
+
+  engine.object_cache = std::make_unique<LLVMJITObjectCache>(
+      co.object_cache_dir, key, co.object_cache_max_size);
+  engine.engine->setObjectCache(engine.object_cache.get());
+}
+
 std::unique_ptr<LLVMJITEngine> LLVMJITEngineBuilder::build() {
   std::string error;
   llvm::EngineBuilder eb(std::move(module_.module_));
@@ -159,6 +185,11 @@ std::unique_ptr<LLVMJITEngine> LLVMJITEngineBuilder::build() {
   LOG(INFO) << "Enabled features: "
             << engine->engine->getTargetMachine()->getTargetFeatureString().str();
 
+  // Must be set before finalizeObject, where the object is either loaded or emitted.
+  if (!module_.co_.object_cache_dir.empty()) {
+    setObjectCache(*engine);
+  }
+
   engine->engine->finalizeObject();
 
   if (module_.getCompilationOptions().dump_ir) {
@@ -23,6 +23,11 @@
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 
+#include <memory>
+#include <string>
+
+#include "exec/nextgen/jitlib/llvmjit/LLVMJITObjectCache.h"
+
 namespace cider::jitlib {
 class LLVMJITModule;
 
@@ -39,10 +44,19 @@ struct CompilationOptions {
   bool dump_ir = false;
   bool enable_avx2 = true;
   bool enable_avx512 = false;
+  // Directory of dumped IR/ASM files, current working directory if empty.
+  std::string dump_dir = "";
+  // Keep optimized IR in memory, which can be retrieved by JITModule::getIR().
+  bool keep_ir = false;
+  // Directory of persistent object cache, disabled if empty.
+  std::string object_cache_dir = "";
+  // Objects are evicted in LRU order once the cache directory exceeds this size.
+  size_t object_cache_max_size = 1UL << 30;
 };
 
 struct LLVMJITEngine {
   llvm::ExecutionEngine* engine{nullptr};
+  std::unique_ptr<LLVMJITObjectCache> object_cache;
 
   ~LLVMJITEngine();
 };
@@ -58,6 +72,8 @@ class LLVMJITEngineBuilder {
 
   void dumpASM(LLVMJITEngine& engine);
 
+  void setObjectCache(LLVMJITEngine& engine);
+
   LLVMJITModule& module_;
   llvm::Module* llvm_module_;
 };
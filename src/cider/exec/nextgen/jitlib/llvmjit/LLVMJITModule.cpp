@@ -20,6 +20,9 @@
  */
 #include "exec/nextgen/jitlib/llvmjit/LLVMJITModule.h"
 
+#include <unistd.h>
+#include <atomic>
+
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
@@ -36,8 +39,8 @@
 
 namespace cider::jitlib {
 
-static void dumpModuleIR(llvm::Module* module, const std::string& module_name) {
-  const std::string fname = module_name + ".ll";
+static void dumpModuleIR(llvm::Module* module, const std::string& file_prefix) {
+  const std::string fname = file_prefix + ".ll";
 
   std::error_code error_code;
   llvm::raw_fd_ostream file(fname, error_code, llvm::sys::fs::F_None);
@@ -49,9 +52,18 @@ static void dumpModuleIR(llvm::Module* module, const std::string& module_name) {
     pass_mgr.run(*module);
 
     file << *module;
+    LOG(INFO) << "Module IR is dumped to " << fname;
   }
 }
 
+static std::string getDumpFilePrefix(const std::string& name,
+                                     const CompilationOptions& co) {
+  static std::atomic<uint64_t> module_counter{0};
+  std::string prefix = co.dump_dir.empty() ? "" : co.dump_dir + "/";
+  return prefix + name + "_" + std::to_string(::getpid()) + "_" +
+         std::to_string(module_counter++);
+}
+
 static llvm::MemoryBuffer* getRuntimeBuffer() {
   static std::once_flag has_set_buffer;
   static std::unique_ptr<llvm::MemoryBuffer> runtime_function_buffer;
@@ -87,6 +99,10 @@ LLVMJITModule::LLVMJITModule(const std::string& name,
     module_ = std::make_unique<llvm::Module>(name, *context_);
   }
   CHECK(module_);
+
+  if (co_.dump_ir) {
+    dump_file_prefix_ = getDumpFilePrefix(name, co_);
+  }
 }
 
 static llvm::FunctionType* getFunctionSignature(const JITFunctionDescriptor& descriptor,
@@ -136,7 +152,7 @@ JITFunctionPointer LLVMJITModule::createJITFunction(
 
 void LLVMJITModule::finish() {
   if (co_.dump_ir) {
-    dumpModuleIR(module_.get(), module_->getModuleIdentifier());
+    dumpModuleIR(module_.get(), dump_file_prefix_);
   }
 
   LLVMJITEngineBuilder builder(*this);
@@ -144,7 +160,12 @@ void LLVMJITModule::finish() {
   // IR optimization
   optimizeIR(module_.get());
   if (co_.dump_ir) {
-    dumpModuleIR(module_.get(), module_->getModuleIdentifier() + "_opt");
+    dumpModuleIR(module_.get(), dump_file_prefix_ + "_opt");
+  }
+  if (co_.keep_ir) {
+    llvm::raw_string_ostream os(ir_);
+    os << *module_;
+    os.flush();
   }
 
   engine_ = builder.build();
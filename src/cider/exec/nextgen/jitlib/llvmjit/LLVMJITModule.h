@@ -51,6 +51,8 @@ class LLVMJITModule final : public JITModule {
 
   void finish() override;
 
+  const std::string& getIR() const override { return ir_; }
+
  protected:
   void* getFunctionPtrImpl(LLVMJITFunction& function);
   void optimizeIR(llvm::Module* module);
@@ -69,6 +71,10 @@ class LLVMJITModule final : public JITModule {
   llvm::ValueToValueMapTy vmap_;
   std::unique_ptr<llvm::Module> runtime_module_;
   CompilationOptions co_;
+
+  // Path prefix of dumped files, unique for every module.
+  std::string dump_file_prefix_;
+  std::string ir_;
 };
 };  // namespace cider::jitlib
 
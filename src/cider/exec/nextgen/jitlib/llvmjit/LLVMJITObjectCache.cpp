@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "exec/nextgen/jitlib/llvmjit/LLVMJITObjectCache.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "util/Logger.h"
+
+namespace cider::jitlib {
+
+namespace {
+// File layout: [magic][md5 of object][object]
+constexpr char kMagic[] = "CIDEROBJ";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+constexpr size_t kDigestSize = sizeof(llvm::MD5::MD5Result);
+constexpr size_t kHeaderSize = kMagicSize + kDigestSize;
+constexpr char kFileSuffix[] = ".o";
+
+llvm::MD5::MD5Result computeDigest(llvm::StringRef data) {
+  llvm::MD5 hash;
+  hash.update(data);
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  return result;
+}
+}  // namespace
+
+LLVMJITObjectCache::LLVMJITObjectCache(const std::string& cache_dir,
+                                       const std::string& key,
+                                       size_t max_size)
+    : cache_dir_(cache_dir)
+    , file_path_(cache_dir + "/" + key + kFileSuffix)
+    , max_size_(max_size) {}
+
+std::string LLVMJITObjectCache::makeKey(const std::string& ir,
+                                        const std::string& triple,
+                                        const std::string& cpu,
+                                        const std::string& features) {
+  llvm::MD5 hash;
+  for (const std::string* part : {&ir, &triple, &cpu, &features}) {
+    hash.update(*part);
+    // separator, avoids collision of different splits
+    hash.update(llvm::StringRef("\0", 1));
+  }
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  return result.digest().str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::getObject(
+    const llvm::Module* module) {
+  auto buffer_or_error = llvm::MemoryBuffer::getFile(file_path_);
+  if (!buffer_or_error) {
+    return nullptr;
+  }
+  auto buffer = std::move(buffer_or_error.get());
+  auto data = buffer->getBuffer();
+
+  bool valid = data.size() > kHeaderSize &&
+               data.startswith(llvm::StringRef(kMagic, kMagicSize));
+  auto obj = data.drop_front(kHeaderSize);
+  if (valid) {
+    auto digest = computeDigest(obj);
+    valid = 0 == std::memcmp(data.data() + kMagicSize, digest.Bytes.data(), kDigestSize);
+  }
+  if (!valid) {
+    LOG(WARNING) << "Corrupted JIT object cache file is removed: " << file_path_;
+    boost::system::error_code ec;
+    boost::filesystem::remove(file_path_, ec);
+    return nullptr;
+  }
+
+  // refresh the access time for LRU eviction
+  boost::system::error_code ec;
+  boost::filesystem::last_write_time(file_path_, std::time(nullptr), ec);
+
+  hit_ = true;
+  return llvm::MemoryBuffer::getMemBufferCopy(obj, module->getModuleIdentifier());
+}
+
+void LLVMJITObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef obj) {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(cache_dir_, ec);
+  if (ec) {
+    LOG(WARNING) << "Unable to create JIT object cache directory " << cache_dir_ << ": "
+                 << ec.message();
+    return;
+  }
+
+  // Write to a temporary file and rename, so readers never see partial files.
+  static std::atomic<uint64_t> tmp_counter{0};
+  auto tmp_path = file_path_ + ".tmp." + std::to_string(::getpid()) + "_" +
+                  std::to_string(tmp_counter++);
+  {
+    std::error_code error_code;
+    llvm::raw_fd_ostream file(tmp_path, error_code, llvm::sys::fs::F_None);
+    if (error_code) {
+      LOG(WARNING) << "Unable to write JIT object cache file " << tmp_path;
+      return;
+    }
+    auto digest = computeDigest(obj.getBuffer());
+    file.write(kMagic, kMagicSize);
+    file.write(reinterpret_cast<const char*>(digest.Bytes.data()), kDigestSize);
+    file << obj.getBuffer();
+  }
+  boost::filesystem::rename(tmp_path, file_path_, ec);
+  if (ec) {
+    boost::filesystem::remove(tmp_path, ec);
+    return;
+  }
+
+  evict();
+}
+
+void LLVMJITObjectCache::evict() {
+  struct CacheFile {
+    boost::filesystem::path path;
+    std::time_t last_access;
+    uintmax_t size;
+  };
+  std::vector<CacheFile> files;
+  uintmax_t total_size = 0;
+
+  boost::system::error_code ec;
+  for (boost::filesystem::directory_iterator iter(cache_dir_, ec), end;
+       !ec && iter != end;
+       iter.increment(ec)) {
+    const auto& path = iter->path();
+    if (path.extension() != kFileSuffix) {
+      continue;
+    }
+    boost::system::error_code file_ec;
+    auto size = boost::filesystem::file_size(path, file_ec);
+    auto last_access = boost::filesystem::last_write_time(path, file_ec);
+    if (!file_ec) {
+      files.push_back({path, last_access, size});
+      total_size += size;
+    }
+  }
+  if (total_size <= max_size_) {
+    return;
+  }
+
+  std::sort(files.begin(), files.end(), [](const CacheFile& lhs, const CacheFile& rhs) {
+    return lhs.last_access < rhs.last_access;
+  });
+  for (auto& file : files) {
+    if (total_size <= max_size_) {
+      break;
+    }
+    // file of current module is never evicted, it may be larger than the cap alone
+    if (file.path == file_path_) {
+      continue;
+    }
+    // other processes may have removed it already
+    boost::filesystem::remove(file.path, ec);
+    total_size -= file.size;
+  }
+}
+};  // namespace cider::jitlib
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef JITLIB_LLVMJIT_LLVMJITOBJECTCACHE_H
+#define JITLIB_LLVMJIT_LLVMJITOBJECTCACHE_H
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+#include <string>
+
+namespace cider::jitlib {
+
+// Persistent cache of emitted object files, shared by processes through a local
+// directory. Each instance serves a single module whose key is given by the builder,
+// i.e. hash of optimized IR, target triple, CPU name and features. Every file carries a
+// checksum of the object and is dropped if it doesn't match. Least recently used files
+// are evicted once the directory exceeds the size cap.
+class LLVMJITObjectCache final : public llvm::ObjectCache {
+ public:
+  LLVMJITObjectCache(const std::string& cache_dir,
+                     const std::string& key,
+                     size_t max_size);
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef obj) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+  bool isHit() const { return hit_; }
+
+  static std::string makeKey(const std::string& ir,
+                             const std::string& triple,
+                             const std::string& cpu,
+                             const std::string& features);
+
+ private:
+  void evict();
+
+  std::string cache_dir_;
+  std::string file_path_;
+  size_t max_size_;
+  bool hit_{false};
+};
+};  // namespace cider::jitlib
+
+#endif  // JITLIB_LLVMJIT_LLVMJITOBJECTCACHE_H
@@ -21,6 +21,9 @@
 
 #include "exec/nextgen/operators/AggregationNode.h"
 
+#include <limits>
+#include <numeric>
+
 namespace cider::exec::nextgen::operators {
 TranslatorPtr AggNode::toTranslator(const TranslatorPtr& succ) {
   return createOpTranslator<AggTranslator>(shared_from_this(), succ);
@@ -32,46 +35,88 @@ void AggTranslator::consume(context::CodegenContext& context) {
 
 context::AggExprsInfoVector initExpersInfo(ExprPtrVector& exprs) {
   context::AggExprsInfoVector infos;
-  int8_t start_addr = 0;
+  infos.reserve(exprs.size());
   for (const auto& expr : exprs) {
-    int8_t size = 0;
     auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(expr.get());
-    // get value size in buffer
-    switch (expr->get_type_info().get_size()) {
-      case 1:
-      case 2:
-      case 4:
-      case 8:
-        size = 8;
-        break;
-      default:
-        size = 8;
-        break;
-    }
-    infos.emplace_back(
-        agg_expr->get_type_info(), agg_expr->get_aggtype(), start_addr, size);
-    start_addr += size;
+    CHECK(agg_expr);
+    auto arg = agg_expr->get_arg();
+    infos.emplace_back(agg_expr->get_type_info(),
+                       arg ? arg->get_type_info() : SQLTypeInfo(),
+                       agg_expr->get_aggtype(),
+                       agg_expr->get_is_distinct());
+  }
+
+  // Slots are sized by their value types and placed from wide to narrow, so that every
+  // slot is naturally aligned without padding.
+  std::vector<size_t> order(infos.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&infos](size_t lhs, size_t rhs) {
+    return infos[lhs].byte_size_ > infos[rhs].byte_size_;
+  });
+  int32_t start_addr = 0;
+  for (auto index : order) {
+    infos[index].start_offset_ = start_addr;
+    start_addr += infos[index].byte_size_;
   }
   return infos;
 }
 
+template <typename T>
+void initSlotValue(int8_t* slot, SQLAgg agg_type) {
+  T value = 0;
+  switch (agg_type) {
+    case SQLAgg::kMIN:
+      value = std::numeric_limits<T>::max();
+      break;
+    case SQLAgg::kMAX:
+      value = std::numeric_limits<T>::lowest();
+      break;
+    default:
+      break;
+  }
+  memcpy(slot, &value, sizeof(T));
+}
+
 std::vector<int8_t> initOriginValue(context::AggExprsInfoVector& exprs_info) {
-  std::vector<int8_t> origin_vector(exprs_info.back().start_offset_ +
-                                    exprs_info.back().byte_size_ + exprs_info.size());
+  int32_t null_buffer_offset = 0;
+  for (const auto& info : exprs_info) {
+    null_buffer_offset =
+        std::max(null_buffer_offset, info.start_offset_ + info.byte_size_);
+  }
+  std::vector<int8_t> origin_vector(null_buffer_offset + exprs_info.size(), 0);
   int8_t* raw_memory = origin_vector.data();
   for (const auto& info : exprs_info) {
+    int8_t* slot = raw_memory + info.start_offset_;
     switch (info.agg_type_) {
       case SQLAgg::kSUM:
-      case SQLAgg::kCOUNT: {
-        switch (info.byte_size_) {
-          case 8: {
-            auto cast_memory =
-                reinterpret_cast<int64_t*>(raw_memory + info.start_offset_);
-            *cast_memory = 0;
+      case SQLAgg::kCOUNT:
+      case SQLAgg::kAVG:
+        // Zero initialized.
+        break;
+      case SQLAgg::kMIN:
+      case SQLAgg::kMAX: {
+        switch (info.jit_value_type_) {
+          case jitlib::JITTypeTag::INT8:
+            initSlotValue<int8_t>(slot, info.agg_type_);
+            break;
+          case jitlib::JITTypeTag::INT16:
+            initSlotValue<int16_t>(slot, info.agg_type_);
+            break;
+          case jitlib::JITTypeTag::INT32:
+            initSlotValue<int32_t>(slot, info.agg_type_);
+            break;
+          case jitlib::JITTypeTag::INT64:
+            initSlotValue<int64_t>(slot, info.agg_type_);
+            break;
+          case jitlib::JITTypeTag::FLOAT:
+            initSlotValue<float>(slot, info.agg_type_);
+            break;
+          case jitlib::JITTypeTag::DOUBLE:
+            initSlotValue<double>(slot, info.agg_type_);
             break;
-          }
           default:
-            LOG(FATAL) << info.byte_size_ << " size is not support for sum yet";
+            LOG(FATAL) << jitlib::getJITTypeName(info.jit_value_type_)
+                       << " is not support for min/max yet";
             break;
         }
         break;
@@ -81,17 +126,83 @@ std::vector<int8_t> initOriginValue(context::AggExprsInfoVector& exprs_info) {
         break;
     }
   }
-  // init null value (1--null, 0--not null)
-  auto null_buffer_offset =
-      exprs_info.back().start_offset_ + exprs_info.back().byte_size_;
+  // init null value (1--null, 0--not null), states stay null until they get a value.
   for (size_t i = 0; i < exprs_info.size(); i++) {
     exprs_info[i].null_offset_ = null_buffer_offset + i;
     auto null_value = reinterpret_cast<int8_t*>(raw_memory + exprs_info[i].null_offset_);
-    *null_value = exprs_info[i].sql_type_info_.get_notnull() ? 0 : 1;
+    *null_value = exprs_info[i].isNullable() ? 1 : 0;
   }
   return origin_vector;
 }
 
+static std::string getGroupBySetKeyFuncName(jitlib::JITTypeTag type) {
+  switch (type) {
+    case jitlib::JITTypeTag::BOOL:
+      return "nextgen_groupby_set_key_bool";
+    case jitlib::JITTypeTag::INT8:
+      return "nextgen_groupby_set_key_int8";
+    case jitlib::JITTypeTag::INT16:
+      return "nextgen_groupby_set_key_int16";
+    case jitlib::JITTypeTag::INT32:
+      return "nextgen_groupby_set_key_int32";
+    case jitlib::JITTypeTag::INT64:
+      return "nextgen_groupby_set_key_int64";
+    case jitlib::JITTypeTag::FLOAT:
+      return "nextgen_groupby_set_key_float";
+    case jitlib::JITTypeTag::DOUBLE:
+      return "nextgen_groupby_set_key_double";
+    default:
+      LOG(FATAL) << "Unsupported group-by key type: " << jitlib::getJITTypeName(type);
+  }
+  return "";
+}
+
+jitlib::JITValuePointer AggTranslator::codegenGroupByKeys(
+    context::CodegenContext& context,
+    const std::vector<SQLTypeInfo>& key_types,
+    const context::AggExprsInfoVector& exprs_info,
+    const std::vector<int8_t>& origin_value,
+    const std::vector<context::AggOutputColumn>& output_columns) {
+  auto func = context.getJITFunction();
+  auto agg_node = dynamic_cast<AggNode*>(node_.get());
+  auto& groupby_exprs = agg_node->getGroupByExprs();
+
+  auto hash_table = context.registerGroupByHashTable(
+      "groupby_hash_table", key_types, exprs_info, origin_value, output_columns);
+
+  // Normalize every key into the key buffer of hash table.
+  for (size_t i = 0; i < groupby_exprs.size(); ++i) {
+    auto index = func->createLiteral(jitlib::JITTypeTag::INT64, static_cast<int64_t>(i));
+    auto& key_value = groupby_exprs[i]->codegen(context);
+    if (key_types[i].is_string()) {
+      utils::VarSizeJITExprValue values(key_value);
+      func->emitRuntimeFunctionCall(
+          "nextgen_groupby_append_varlen_key",
+          jitlib::JITFunctionEmitDescriptor{.ret_type = jitlib::JITTypeTag::VOID,
+                                            .params_vector = {hash_table.get(),
+                                                              index.get(),
+                                                              values.getValue().get(),
+                                                              values.getLength().get(),
+                                                              values.getNull().get()}});
+    } else {
+      utils::FixSizeJITExprValue values(key_value);
+      func->emitRuntimeFunctionCall(
+          getGroupBySetKeyFuncName(values.getValue()->getValueTypeTag()),
+          jitlib::JITFunctionEmitDescriptor{.ret_type = jitlib::JITTypeTag::VOID,
+                                            .params_vector = {hash_table.get(),
+                                                              index.get(),
+                                                              values.getValue().get(),
+                                                              values.getNull().get()}});
+    }
+  }
+
+  return func->emitRuntimeFunctionCall(
+      "nextgen_groupby_find_or_insert",
+      jitlib::JITFunctionEmitDescriptor{.ret_type = jitlib::JITTypeTag::POINTER,
+                                        .ret_sub_type = jitlib::JITTypeTag::INT8,
+                                        .params_vector = {hash_table.get()}});
+}
+
 void AggTranslator::codegen(context::CodegenContext& context) {
   auto func = context.getJITFunction();
 
@@ -102,62 +213,140 @@ void AggTranslator::codegen(context::CodegenContext& context) {
 
   std::vector<int8_t> origin_value = initOriginValue(exprs_info);
 
-  // Groupby
-  // TODO(Yanting): support group-by
   auto agg_node = dynamic_cast<AggNode*>(node_.get());
   auto& groupby_exprs = agg_node->getGroupByExprs();
-  if (groupby_exprs.size() != 0) {
-    LOG(FATAL) << "group-by is not supported now.";
+
+  std::vector<SQLTypeInfo> key_types;
+  key_types.reserve(groupby_exprs.size());
+  for (auto& expr : groupby_exprs) {
+    key_types.emplace_back(expr->get_type_info());
+  }
+
+  // Output columns follow the order of targets.
+  const auto& output_columns = agg_node->getOutputColumns();
+  std::vector<SQLTypeInfo> output_types;
+  output_types.reserve(output_columns.size());
+  for (auto& column : output_columns) {
+    output_types.emplace_back(column.is_key ? key_types[column.index]
+                                            : exprs[column.index]->get_type_info());
+  }
+  auto batch = context.registerBatch(SQLTypeInfo(kSTRUCT, false, output_types));
+
+  jitlib::JITValuePointer buffer(nullptr);
+  if (groupby_exprs.empty()) {
+    // non-groupby Agg, every target is an aggregation in order.
+    CHECK_EQ(output_columns.size(), exprs.size());
+    buffer.replace(context.registerBuffer(
+        origin_value.size(),
+        exprs_info,
+        "output_buffer",
+        [origin_value](context::Buffer* buf) {
+          auto raw_buf = buf->getBuffer();
+          memcpy(raw_buf, origin_value.data(), buf->getCapacity());
+        }));
+  } else {
+    // Groupby Agg, aggregate into the state of current key.
+    buffer.replace(codegenGroupByKeys(
+        context, key_types, exprs_info, origin_value, output_columns));
   }
 
-  ExprPtrVector& output_exprs = exprs;
-  auto batch = context.registerBatch(SQLTypeInfo(kSTRUCT, false, [&output_exprs]() {
-    std::vector<SQLTypeInfo> output_types;
-    output_types.reserve(output_exprs.size());
-    for (auto& expr : output_exprs) {
-      output_types.emplace_back(expr->get_type_info());
+  auto cast_buffer = buffer->castPointerSubType(jitlib::JITTypeTag::INT8);
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(exprs[i].get());
+    auto& info = exprs_info[i];
+
+    auto val_addr_initial = cast_buffer + info.start_offset_;
+    auto val_addr = val_addr_initial->castPointerSubType(info.jit_value_type_);
+
+    if (info.agg_type_ == SQLAgg::kCOUNT) {
+      codegenCount(context, agg_expr, info, val_addr);
+      continue;
     }
-    return output_types;
-  }()));
-
-  // non-groupby Agg
-  auto buffer =
-      context.registerBuffer(origin_value.size(),
-                             exprs_info,
-                             "output_buffer",
-                             [origin_value](context::Buffer* buf) {
-                               auto raw_buf = buf->getBuffer();
-                               memcpy(raw_buf, origin_value.data(), buf->getCapacity());
-                             });
-
-  int32_t current_expr_idx = 0;
-  for (const auto& expr : exprs) {
-    auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(expr.get());
-    utils::FixSizeJITExprValue values(agg_expr->get_arg()->get_expr_value());
 
-    auto cast_buffer = buffer->castPointerSubType(jitlib::JITTypeTag::INT8);
-    auto val_addr_initial = cast_buffer + exprs_info[current_expr_idx].start_offset_;
-    auto val_addr = val_addr_initial->castPointerSubType(
-        exprs_info[current_expr_idx].jit_value_type_);
+    utils::FixSizeJITExprValue values(agg_expr->get_arg()->get_expr_value());
+    auto value = values.getValue();
+    if (value->getValueTypeTag() != info.jit_value_type_) {
+      value.replace(value->castJITValuePrimitiveType(info.jit_value_type_));
+    }
 
-    if (exprs_info[current_expr_idx].sql_type_info_.get_notnull()) {
+    if (!info.isNullable()) {
       func->emitRuntimeFunctionCall(
-          exprs_info[current_expr_idx].agg_name_,
+          info.agg_name_,
           jitlib::JITFunctionEmitDescriptor{
-              .ret_type = exprs_info[current_expr_idx].jit_value_type_,
-              .params_vector = {val_addr.get(), values.getValue().get()}});
+              .ret_type = jitlib::JITTypeTag::VOID,
+              .params_vector = {val_addr.get(), value.get()}});
     } else {
-      auto null_addr = cast_buffer + exprs_info[current_expr_idx].null_offset_;
+      // NOT NULL input still clears the null flag of MIN/MAX once it gets a value.
+      auto is_null = info.sql_type_info_.get_notnull()
+                         ? func->createLiteral(jitlib::JITTypeTag::BOOL, false)
+                         : values.getNull();
+      auto null_addr = cast_buffer + info.null_offset_;
       func->emitRuntimeFunctionCall(
-          exprs_info[current_expr_idx].agg_name_ + "_nullable",
+          info.agg_name_ + "_nullable",
           jitlib::JITFunctionEmitDescriptor{
-              .ret_type = exprs_info[current_expr_idx].jit_value_type_,
-              .params_vector = {val_addr.get(),
-                                values.getValue().get(),
-                                null_addr.get(),
-                                values.getNull().get()}});
+              .ret_type = jitlib::JITTypeTag::VOID,
+              .params_vector = {
+                  val_addr.get(), value.get(), null_addr.get(), is_null.get()}});
     }
-    current_expr_idx += 1;
+  }
+}
+
+void AggTranslator::codegenCount(context::CodegenContext& context,
+                                 const Analyzer::AggExpr* agg_expr,
+                                 const context::AggExprsInfo& info,
+                                 jitlib::JITValuePointer& val_addr) {
+  auto func = context.getJITFunction();
+  auto arg = agg_expr->get_arg();
+
+  // COUNT(*)
+  if (!arg) {
+    func->emitRuntimeFunctionCall(
+        info.agg_name_,
+        jitlib::JITFunctionEmitDescriptor{.ret_type = jitlib::JITTypeTag::VOID,
+                                          .params_vector = {val_addr.get()}});
+    return;
+  }
+
+  utils::FixSizeJITExprValue values(arg->get_expr_value());
+  bool arg_nullable = !arg->get_type_info().get_notnull();
+
+  if (info.is_distinct_) {
+    auto set_ptr = context.registerCiderSet(
+        "count_distinct_set",
+        arg->get_type_info(),
+        []() -> context::CiderSetPtr {
+          return std::make_unique<context::CiderCountDistinctSet>();
+        });
+    if (arg_nullable) {
+      func->emitRuntimeFunctionCall(
+          info.agg_name_ + "_nullable",
+          jitlib::JITFunctionEmitDescriptor{.ret_type = jitlib::JITTypeTag::VOID,
+                                            .params_vector = {val_addr.get(),
+                                                              set_ptr.get(),
+                                                              values.getValue().get(),
+                                                              values.getNull().get()}});
+    } else {
+      func->emitRuntimeFunctionCall(
+          info.agg_name_,
+          jitlib::JITFunctionEmitDescriptor{
+              .ret_type = jitlib::JITTypeTag::VOID,
+              .params_vector = {
+                  val_addr.get(), set_ptr.get(), values.getValue().get()}});
+    }
+    return;
+  }
+
+  if (arg_nullable) {
+    func->emitRuntimeFunctionCall(
+        info.agg_name_ + "_nullable",
+        jitlib::JITFunctionEmitDescriptor{
+            .ret_type = jitlib::JITTypeTag::VOID,
+            .params_vector = {val_addr.get(), values.getNull().get()}});
+  } else {
+    func->emitRuntimeFunctionCall(
+        info.agg_name_,
+        jitlib::JITFunctionEmitDescriptor{.ret_type = jitlib::JITTypeTag::VOID,
+                                          .params_vector = {val_addr.get()}});
   }
 }
 
@@ -49,22 +49,35 @@ struct AggExprsInfo {
 
 using AggExprsInfoVector = std::vector<AggExprsInfo>;
 
+// Output exprs are the aggregations, output_columns map every target to a group-by key
+// or an aggregation, so the output batch follows the order of targets.
 class AggNode : public OpNode {
  public:
-  AggNode(ExprPtrVector&& groupby_exprs, ExprPtrVector&& output_exprs)
+  AggNode(ExprPtrVector&& groupby_exprs,
+          ExprPtrVector&& output_exprs,
+          std::vector<context::AggOutputColumn>&& output_columns)
       : OpNode("AggNode", std::move(output_exprs), JITExprValueType::ROW)
-      , groupby_exprs_(std::move(groupby_exprs)) {}
+      , groupby_exprs_(std::move(groupby_exprs))
+      , output_columns_(std::move(output_columns)) {}
 
-  AggNode(const ExprPtrVector& groupby_exprs, const ExprPtrVector& output_exprs)
+  AggNode(const ExprPtrVector& groupby_exprs,
+          const ExprPtrVector& output_exprs,
+          const std::vector<context::AggOutputColumn>& output_columns)
       : OpNode("AggNode", output_exprs, JITExprValueType::ROW)
-      , groupby_exprs_(std::move(groupby_exprs)) {}
+      , groupby_exprs_(groupby_exprs)
+      , output_columns_(output_columns) {}
 
   ExprPtrVector& getGroupByExprs() { return groupby_exprs_; }
 
+  const std::vector<context::AggOutputColumn>& getOutputColumns() const {
+    return output_columns_;
+  }
+
   TranslatorPtr toTranslator(const TranslatorPtr& succ = nullptr) override;
 
  private:
   ExprPtrVector groupby_exprs_;
+  std::vector<context::AggOutputColumn> output_columns_;
 };
 
 class AggTranslator : public Translator {
@@ -76,6 +89,19 @@ class AggTranslator : public Translator {
 
  private:
   void codegen(context::CodegenContext& context);
+
+  // Codegen group-by keys and returns the address of aggregation state of current row.
+  jitlib::JITValuePointer codegenGroupByKeys(
+      context::CodegenContext& context,
+      const std::vector<SQLTypeInfo>& key_types,
+      const context::AggExprsInfoVector& exprs_info,
+      const std::vector<int8_t>& origin_value,
+      const std::vector<context::AggOutputColumn>& output_columns);
+
+  void codegenCount(context::CodegenContext& context,
+                    const Analyzer::AggExpr* agg_expr,
+                    const context::AggExprsInfo& info,
+                    jitlib::JITValuePointer& val_addr);
 };
 
 }  // namespace cider::exec::nextgen::operators
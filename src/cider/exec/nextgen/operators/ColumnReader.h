@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NEXTGEN_OPERATORS_COLUMNREADER_H
+#define NEXTGEN_OPERATORS_COLUMNREADER_H
+
+#include "exec/nextgen/context/CodegenContext.h"
+#include "exec/nextgen/jitlib/JITLib.h"
+#include "exec/nextgen/operators/OpNode.h"
+#include "exec/nextgen/utils/TypeUtils.h"
+#include "util/Logger.h"
+
+namespace cider::exec::nextgen::operators {
+using namespace cider::jitlib;
+
+// Bitmaps of a column loaded a word (64 rows) at a time, see
+// CodegenOptions::enable_block_codegen.
+struct BitmapWords {
+  BitmapWords() : null_word(nullptr), value_word(nullptr), offset(nullptr) {}
+
+  // validity bitmap, only for nullable columns
+  JITValuePointer null_word;
+  // value bitmap, only for boolean columns
+  JITValuePointer value_word;
+  // offset of current row in the block
+  JITValuePointer offset;
+};
+
+// Reads the value of a column at index into its expr, buffers of the column are taken
+// from the ArrowArray values registered for the expr's local index.
+class ColumnReader {
+ public:
+  ColumnReader(context::CodegenContext& ctx,
+               ExprPtr& expr,
+               JITValuePointer& index,
+               const BitmapWords* words = nullptr)
+      : context_(ctx), expr_(expr), index_(index), words_(words) {}
+
+  void read() {
+    switch (expr_->get_type_info().get_type()) {
+      case kBOOLEAN:
+      case kTINYINT:
+      case kSMALLINT:
+      case kINT:
+      case kBIGINT:
+      case kFLOAT:
+      case kDOUBLE:
+      case kDATE:
+      case kTIME:
+      case kTIMESTAMP:
+        readFixSizedTypeCol();
+        break;
+      case kVARCHAR:
+      case kCHAR:
+      case kTEXT:
+        readVariableSizeTypeCol();
+        break;
+      default:
+        LOG(FATAL) << "Unsupported data type in ColumnReader: "
+                   << expr_->get_type_info().get_type_name();
+    }
+  }
+
+ private:
+  void readVariableSizeTypeCol() {
+    auto&& [batch, buffers] = context_.getArrowArrayValues(expr_->getLocalIndex());
+    utils::VarSizeJITExprValue varsize_values(buffers);
+
+    auto& func = batch->getParentJITFunction();
+    // offset buffer
+    auto offset_pointer =
+        varsize_values.getLength()->castPointerSubType(JITTypeTag::INT32);
+    auto len = offset_pointer[index_ + 1] - offset_pointer[index_];
+    auto cur_offset = offset_pointer[index_];
+    // data buffer
+    auto value_pointer = varsize_values.getValue()->castPointerSubType(JITTypeTag::INT8);
+    auto row_data = value_pointer + cur_offset;  // still char*
+
+    if (expr_->get_type_info().get_notnull()) {
+      expr_->set_expr_value(func.createConstant(JITTypeTag::BOOL, false), len, row_data);
+    } else {
+      // null buffer decoder
+      // TBD: Null representation, bit-array or bool-array.
+      auto row_null_data = readNull(func, varsize_values.getNull());
+      expr_->set_expr_value(row_null_data, len, row_data);
+    }
+  }
+
+  void readFixSizedTypeCol() {
+    auto&& [batch, buffers] = context_.getArrowArrayValues(expr_->getLocalIndex());
+    utils::FixSizeJITExprValue fixsize_values(buffers);
+
+    auto& func = batch->getParentJITFunction();
+    auto row_data = getFixSizeRowData(func, fixsize_values);
+    if (expr_->get_type_info().get_notnull()) {
+      expr_->set_expr_value(func.createConstant(JITTypeTag::BOOL, false), row_data);
+    } else {
+      // null buffer decoder
+      // TBD: Null representation, bit-array or bool-array.
+      auto row_null_data = readNull(func, fixsize_values.getNull());
+      expr_->set_expr_value(row_null_data, row_data);
+    }
+  }
+
+  JITValuePointer getFixSizeRowData(JITFunction& func,
+                                    utils::FixSizeJITExprValue& fixsize_val) {
+    if (expr_->get_type_info().get_type() == kBOOLEAN) {
+      if (words_) {
+        return func.emitRuntimeFunctionCall(
+            "nextgen_check_bitmap_word_set",
+            JITFunctionEmitDescriptor{
+                .ret_type = JITTypeTag::BOOL,
+                .params_vector = {{words_->value_word.get(), words_->offset.get()}}});
+      }
+      auto row_data = func.emitRuntimeFunctionCall(
+          "check_bit_vector_set",
+          JITFunctionEmitDescriptor{
+              .ret_type = JITTypeTag::BOOL,
+              .params_vector = {{fixsize_val.getValue().get(), index_.get()}}});
+      return row_data;
+    } else {
+      JITTypeTag tag = utils::getJITTypeTag(expr_->get_type_info().get_type());
+      // data buffer decoder
+      auto data_pointer = fixsize_val.getValue()->castPointerSubType(tag);
+      auto row_data = data_pointer[index_];
+      return row_data;
+    }
+  }
+
+  JITValuePointer readNull(JITFunction& func, JITValuePointer& null_buffer) {
+    // null buffer decoder
+    // TBD: Null representation, bit-array or bool-array.
+    if (words_) {
+      return func.emitRuntimeFunctionCall(
+          "nextgen_check_bitmap_word_clear",
+          JITFunctionEmitDescriptor{
+              .ret_type = JITTypeTag::BOOL,
+              .params_vector = {{words_->null_word.get(), words_->offset.get()}}});
+    }
+    return func.emitRuntimeFunctionCall(
+        "nextgen_check_validity_bit_clear",
+        JITFunctionEmitDescriptor{.ret_type = JITTypeTag::BOOL,
+                                  .params_vector = {{null_buffer.get(), index_.get()}}});
+  }
+
+ private:
+  context::CodegenContext& context_;
+  ExprPtr& expr_;
+  JITValuePointer& index_;
+  const BitmapWords* words_;
+};
+}  // namespace cider::exec::nextgen::operators
+#endif  // NEXTGEN_OPERATORS_COLUMNREADER_H
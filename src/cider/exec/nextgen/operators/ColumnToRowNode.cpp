@@ -22,117 +22,14 @@
 #include "exec/nextgen/operators/ColumnToRowNode.h"
 
 #include "exec/nextgen/context/CodegenContext.h"
+#include "exec/nextgen/operators/ColumnReader.h"
+#include "exec/nextgen/operators/FilterNode.h"
 #include "exec/nextgen/operators/OpNode.h"
-#include "exec/nextgen/utils/TypeUtils.h"
 #include "util/Logger.h"
 
 namespace cider::exec::nextgen::operators {
 using namespace cider::jitlib;
 
-class ColumnReader {
- public:
-  ColumnReader(context::CodegenContext& ctx, ExprPtr& expr, JITValuePointer& index)
-      : context_(ctx), expr_(expr), index_(index) {}
-
-  void read() {
-    switch (expr_->get_type_info().get_type()) {
-      case kBOOLEAN:
-      case kTINYINT:
-      case kSMALLINT:
-      case kINT:
-      case kBIGINT:
-      case kFLOAT:
-      case kDOUBLE:
-      case kDATE:
-      case kTIME:
-      case kTIMESTAMP:
-        readFixSizedTypeCol();
-        break;
-      case kVARCHAR:
-      case kCHAR:
-      case kTEXT:
-        readVariableSizeTypeCol();
-        break;
-      default:
-        LOG(FATAL) << "Unsupported data type in ColumnReader: "
-                   << expr_->get_type_info().get_type_name();
-    }
-  }
-
- private:
-  void readVariableSizeTypeCol() {
-    auto&& [batch, buffers] = context_.getArrowArrayValues(expr_->getLocalIndex());
-    utils::VarSizeJITExprValue varsize_values(buffers);
-
-    auto& func = batch->getParentJITFunction();
-    // offset buffer
-    auto offset_pointer =
-        varsize_values.getLength()->castPointerSubType(JITTypeTag::INT32);
-    auto len = offset_pointer[index_ + 1] - offset_pointer[index_];
-    auto cur_offset = offset_pointer[index_];
-    // data buffer
-    auto value_pointer = varsize_values.getValue()->castPointerSubType(JITTypeTag::INT8);
-    auto row_data = value_pointer + cur_offset;  // still char*
-
-    if (expr_->get_type_info().get_notnull()) {
-      expr_->set_expr_value(func.createConstant(JITTypeTag::BOOL, false), len, row_data);
-    } else {
-      // null buffer decoder
-      // TBD: Null representation, bit-array or bool-array.
-      auto row_null_data = func.emitRuntimeFunctionCall(
-          "check_bit_vector_clear",
-          JITFunctionEmitDescriptor{
-              .ret_type = JITTypeTag::BOOL,
-              .params_vector = {{varsize_values.getNull().get(), index_.get()}}});
-      expr_->set_expr_value(row_null_data, len, row_data);
-    }
-  }
-
-  void readFixSizedTypeCol() {
-    auto&& [batch, buffers] = context_.getArrowArrayValues(expr_->getLocalIndex());
-    utils::FixSizeJITExprValue fixsize_values(buffers);
-
-    auto& func = batch->getParentJITFunction();
-    auto row_data = getFixSizeRowData(func, fixsize_values);
-    if (expr_->get_type_info().get_notnull()) {
-      expr_->set_expr_value(func.createConstant(JITTypeTag::BOOL, false), row_data);
-    } else {
-      // null buffer decoder
-      // TBD: Null representation, bit-array or bool-array.
-      auto row_null_data = func.emitRuntimeFunctionCall(
-          "check_bit_vector_clear",
-          JITFunctionEmitDescriptor{
-              .ret_type = JITTypeTag::BOOL,
-              .params_vector = {{fixsize_values.getNull().get(), index_.get()}}});
-
-      expr_->set_expr_value(row_null_data, row_data);
-    }
-  }
-
-  JITValuePointer getFixSizeRowData(JITFunction& func,
-                                    utils::FixSizeJITExprValue& fixsize_val) {
-    if (expr_->get_type_info().get_type() == kBOOLEAN) {
-      auto row_data = func.emitRuntimeFunctionCall(
-          "check_bit_vector_set",
-          JITFunctionEmitDescriptor{
-              .ret_type = JITTypeTag::BOOL,
-              .params_vector = {{fixsize_val.getValue().get(), index_.get()}}});
-      return row_data;
-    } else {
-      JITTypeTag tag = utils::getJITTypeTag(expr_->get_type_info().get_type());
-      // data buffer decoder
-      auto data_pointer = fixsize_val.getValue()->castPointerSubType(tag);
-      auto row_data = data_pointer[index_];
-      return row_data;
-    }
-  }
-
- private:
-  context::CodegenContext& context_;
-  ExprPtr& expr_;
-  JITValuePointer& index_;
-};
-
 TranslatorPtr ColumnToRowNode::toTranslator(const TranslatorPtr& succ) {
   return createOpTranslator<ColumnToRowTranslator>(shared_from_this(), succ);
 }
@@ -146,9 +43,6 @@ void ColumnToRowTranslator::codegen(context::CodegenContext& context) {
   auto&& [type, exprs] = node_->getOutputExprs();
   ExprPtrVector& inputs = exprs;
 
-  // for row loop
-  auto index = func->createVariable(JITTypeTag::INT64, "index", 0);
-
   // get input row num from input arrow array
   // assumes signature be like: query_func(context, array)
   auto input_array = func->getArgument(1);  // array
@@ -157,16 +51,23 @@ void ColumnToRowTranslator::codegen(context::CodegenContext& context) {
   });
   static_cast<ColumnToRowNode*>(node_.get())->setColumnRowNum(len);
 
-  func->createLoopBuilder()
-      ->condition([&index, &len]() { return index < len; })
-      ->loop([&]() {
-        for (auto& input : inputs) {
-          ColumnReader(context, input, index).read();
-        }
-        successor_->consume(context);
-      })
-      ->update([&index]() { index = index + 1l; })
-      ->build();
+  if (context.getCodegenOptions().enable_block_codegen) {
+    codegenBlockLoop(context, inputs, len);
+  } else {
+    // for row loop
+    auto index = func->createVariable(JITTypeTag::INT64, "index", 0);
+    static_cast<ColumnToRowNode*>(node_.get())->setColumnRowIndex(index);
+    func->createLoopBuilder()
+        ->condition([&index, &len]() { return index < len; })
+        ->loop([&]() {
+          for (auto& input : inputs) {
+            ColumnReader(context, input, index).read();
+          }
+          successor_->consume(context);
+        })
+        ->update([&index]() { index = index + 1l; })
+        ->build();
+  }
 
   // Execute defer build functions.
   auto c2r_node = static_cast<ColumnToRowNode*>(node_.get());
@@ -174,4 +75,128 @@ void ColumnToRowTranslator::codegen(context::CodegenContext& context) {
     defer_func();
   }
 }
+
+void ColumnToRowTranslator::codegenBlockLoop(context::CodegenContext& context,
+                                             ExprPtrVector& inputs,
+                                             JITValuePointer& len) {
+  // rows covered by a bitmap word
+  constexpr int64_t kBlockSize = 64;
+  auto func = context.getJITFunction();
+  auto block_begin = func->createVariable(JITTypeTag::INT64, "block_begin", 0);
+  auto block_end = func->createVariable(JITTypeTag::INT64, "block_end", 0);
+  auto index = func->createVariable(JITTypeTag::INT64, "index", 0);
+  static_cast<ColumnToRowNode*>(node_.get())->setColumnRowIndex(index);
+
+  std::vector<BitmapWords> words(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto& type = inputs[i]->get_type_info();
+    if (!type.get_notnull()) {
+      words[i].null_word.replace(func->createVariable(JITTypeTag::INT64, "null_word", 0));
+    }
+    if (kBOOLEAN == type.get_type()) {
+      words[i].value_word.replace(
+          func->createVariable(JITTypeTag::INT64, "value_word", 0));
+    }
+  }
+
+  // A filter right after this translator is evaluated for the whole block first, the
+  // offsets of rows satisfying it are recorded in a selection vector, and only those rows
+  // are read again and consumed by the rest of pipeline.
+  auto filter = std::dynamic_pointer_cast<FilterTranslator>(successor_);
+  if (filter && !filter->hasCondition()) {
+    filter = nullptr;
+  }
+  JITValuePointer selection(nullptr);
+  JITValuePointer selected_num(nullptr);
+  JITValuePointer selected_index(nullptr);
+  if (filter) {
+    selection.replace(
+        context.registerBuffer(kBlockSize * sizeof(int64_t), "selection_vector")
+            ->castPointerSubType(JITTypeTag::INT64));
+    selected_num.replace(func->createVariable(JITTypeTag::INT64, "selected_num", 0));
+    selected_index.replace(func->createVariable(JITTypeTag::INT64, "selected_index", 0));
+  }
+
+  auto load_word = [&](JITValuePointer& word, JITValuePointer& bitmap) {
+    word = func->emitRuntimeFunctionCall(
+        "nextgen_load_bitmap_word",
+        JITFunctionEmitDescriptor{
+            .ret_type = JITTypeTag::INT64,
+            .params_vector = {{bitmap.get(), block_begin.get(), len.get()}}});
+  };
+
+  // Reads the row at index, whose offset in the block is offset.
+  auto read_row = [&](JITValuePointer& offset) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      words[i].offset.replace(offset);
+      ColumnReader(context, inputs[i], index, &words[i]).read();
+    }
+  };
+
+  // Loops over the rows of current block.
+  auto row_loop = [&](const std::function<void()>& body) {
+    index = *block_begin;
+    func->createLoopBuilder()
+        ->condition([&]() { return (index < len) && (index < block_end); })
+        ->loop([&]() {
+          auto offset = index - block_begin;
+          read_row(offset);
+          body();
+        })
+        ->update([&index]() { index = index + 1l; })
+        ->build();
+  };
+
+  func->createLoopBuilder()
+      ->condition([&block_begin, &len]() { return block_begin < len; })
+      ->loop([&]() {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+          auto&& [batch, buffers] =
+              context.getArrowArrayValues(inputs[i]->getLocalIndex());
+          if (words[i].null_word.get()) {
+            utils::JITExprValueAdaptor values(buffers);
+            load_word(words[i].null_word, values.getNull());
+          }
+          if (words[i].value_word.get()) {
+            utils::FixSizeJITExprValue values(buffers);
+            load_word(words[i].value_word, values.getValue());
+          }
+        }
+        block_end = block_begin + kBlockSize;
+
+        if (!filter) {
+          row_loop([&]() { successor_->consume(context); });
+          return;
+        }
+
+        selected_num = func->createLiteral(JITTypeTag::INT64, 0);
+        row_loop([&]() {
+          auto selected = filter->codegenCondition(context);
+          auto offset = index - block_begin;
+          selected_num = func->emitRuntimeFunctionCall(
+              "nextgen_select_row",
+              JITFunctionEmitDescriptor{
+                  .ret_type = JITTypeTag::INT64,
+                  .params_vector = {{selection.get(),
+                                     selected_num.get(),
+                                     offset.get(),
+                                     selected.get()}}});
+        });
+        filter->clearConditionValues();
+
+        selected_index = func->createLiteral(JITTypeTag::INT64, 0);
+        func->createLoopBuilder()
+            ->condition([&]() { return selected_index < selected_num; })
+            ->loop([&]() {
+              auto offset = selection[selected_index];
+              index = *block_begin + *offset;
+              read_row(offset);
+              filter->consumeSelected(context);
+            })
+            ->update([&]() { selected_index = selected_index + 1l; })
+            ->build();
+      })
+      ->update([&]() { block_begin = block_begin + kBlockSize; })
+      ->build();
+}
 }  // namespace cider::exec::nextgen::operators
@@ -42,6 +42,14 @@ class ColumnToRowNode : public OpNode {
     column_row_num_.replace(row_num);
   }
 
+  // Index of the input row currently being consumed by the loop body.
+  jitlib::JITValuePointer getColumnRowIndex() { return column_row_index_; }
+
+  void setColumnRowIndex(jitlib::JITValuePointer& index) {
+    CHECK(column_row_index_.get() == nullptr);
+    column_row_index_.replace(index);
+  }
+
   using DeferFunc = void (*)(void*);
 
   template <typename FuncT>
@@ -53,6 +61,7 @@ class ColumnToRowNode : public OpNode {
 
  private:
   jitlib::JITValuePointer column_row_num_;
+  jitlib::JITValuePointer column_row_index_;
   std::vector<std::function<void()>> defer_func_list_;
 };
 
@@ -64,6 +73,10 @@ class ColumnToRowTranslator : public Translator {
 
  private:
   void codegen(context::CodegenContext& context);
+
+  void codegenBlockLoop(context::CodegenContext& context,
+                        ExprPtrVector& inputs,
+                        jitlib::JITValuePointer& len);
 };
 
 }  // namespace cider::exec::nextgen::operators
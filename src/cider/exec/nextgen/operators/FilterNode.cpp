@@ -36,17 +36,40 @@ void FilterTranslator::consume(context::CodegenContext& context) {
 void FilterTranslator::codegen(context::CodegenContext& context) {
   auto func = context.getJITFunction();
   func->createIfBuilder()
-      ->condition([&]() {
-        auto bool_init = func->createVariable(JITTypeTag::BOOL, "bool_init");
-        *bool_init = func->createLiteral(JITTypeTag::BOOL, true);
-        auto&& [expr_type, exprs] = node_->getOutputExprs();
-        for (const auto& expr : exprs) {
-          utils::FixSizeJITExprValue cond(expr->codegen(context));
-          bool_init = bool_init && cond.getValue() && !cond.getNull();
-        }
-        return bool_init;
-      })
+      ->condition([&]() { return codegenCondition(context); })
       ->ifTrue([&]() { successor_->consume(context); })
       ->build();
 }
+
+JITValuePointer FilterTranslator::codegenCondition(context::CodegenContext& context) {
+  auto func = context.getJITFunction();
+  auto bool_init = func->createVariable(JITTypeTag::BOOL, "bool_init");
+  *bool_init = func->createLiteral(JITTypeTag::BOOL, true);
+  auto&& [expr_type, exprs] = node_->getOutputExprs();
+  for (const auto& expr : exprs) {
+    utils::FixSizeJITExprValue cond(expr->codegen(context));
+    bool_init = bool_init && cond.getValue() && !cond.getNull();
+  }
+  return bool_init;
+}
+
+static void clearExprValues(ExprPtr& expr) {
+  expr->get_expr_value().clear();
+  if (dynamic_cast<Analyzer::ColumnVar*>(expr.get())) {
+    return;
+  }
+  for (ExprPtr* child : expr->get_children_reference()) {
+    // optional args (e.g. escape in LIKE) may be null
+    if (child && child->get()) {
+      clearExprValues(*child);
+    }
+  }
+}
+
+void FilterTranslator::clearConditionValues() {
+  auto&& [expr_type, exprs] = node_->getOutputExprs();
+  for (auto& expr : exprs) {
+    clearExprValues(expr);
+  }
+}
 }  // namespace cider::exec::nextgen::operators
@@ -42,6 +42,23 @@ class FilterTranslator : public Translator {
 
   void consume(context::CodegenContext& context) override;
 
+  bool hasCondition() { return !node_->getOutputExprs().second.empty(); }
+
+  // The following are used by ColumnToRowTranslator in block mode, which evaluates the
+  // condition of a whole block into a selection vector before consuming selected rows.
+
+  // Evaluates the condition of the current row.
+  jitlib::JITValuePointer codegenCondition(context::CodegenContext& context);
+
+  // Drops the values cached in condition exprs, which are only valid inside the loop
+  // where codegenCondition() was called.
+  void clearConditionValues();
+
+  // Consumes the current row, which is known to satisfy the condition.
+  void consumeSelected(context::CodegenContext& context) {
+    successor_->consume(context);
+  }
+
  private:
   void codegen(context::CodegenContext& context);
 };
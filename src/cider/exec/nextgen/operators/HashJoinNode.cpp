@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "exec/nextgen/operators/HashJoinNode.h"
+
+#include "exec/nextgen/jitlib/JITLib.h"
+#include "exec/nextgen/operators/ColumnReader.h"
+
+namespace cider::exec::nextgen::operators {
+using namespace jitlib;
+
+TranslatorPtr HashJoinNode::toTranslator(const TranslatorPtr& succ) {
+  return createOpTranslator<HashJoinTranslator>(shared_from_this(), succ);
+}
+
+void HashJoinTranslator::consume(context::CodegenContext& context) {
+  codegen(context);
+}
+
+void HashJoinTranslator::codegen(context::CodegenContext& context) {
+  auto func = context.getJITFunction();
+  auto join_node = static_cast<HashJoinNode*>(node_.get());
+  auto&& [type, exprs] = node_->getOutputExprs();
+  ExprPtrVector& build_exprs = exprs;
+
+  auto hash_table = context.registerHashTable("join_hash_table");
+
+  // Null keys never match in inner join.
+  utils::FixSizeJITExprValue key(join_node->getProbeKey()->codegen(context));
+  func->createIfBuilder()
+      ->condition([&key]() { return !key.getNull(); })
+      ->ifTrue([&]() {
+        auto key_value = key.getValue()->castJITValuePrimitiveType(JITTypeTag::INT64);
+        auto slot = func->createVariable(JITTypeTag::INT64, "join_slot", -1);
+        slot = func->emitRuntimeFunctionCall(
+            "nextgen_join_probe_first",
+            JITFunctionEmitDescriptor{
+                .ret_type = JITTypeTag::INT64,
+                .params_vector = {hash_table.get(), key_value.get()}});
+
+        func->createLoopBuilder()
+            ->condition([&slot]() { return slot >= 0l; })
+            ->loop([&]() {
+              auto build_array = func->emitRuntimeFunctionCall(
+                  "nextgen_join_get_build_array",
+                  JITFunctionEmitDescriptor{
+                      .ret_type = JITTypeTag::POINTER,
+                      .ret_sub_type = JITTypeTag::INT8,
+                      .params_vector = {hash_table.get(), slot.get()}});
+              auto build_row = func->emitRuntimeFunctionCall(
+                  "nextgen_join_get_build_row",
+                  JITFunctionEmitDescriptor{
+                      .ret_type = JITTypeTag::INT64,
+                      .params_vector = {hash_table.get(), slot.get()}});
+
+              // Matches may come from different build batches, so buffers of build
+              // columns are loaded for every match.
+              for (auto& expr : build_exprs) {
+                auto col_var = dynamic_cast<Analyzer::ColumnVar*>(expr.get());
+                CHECK(col_var);
+                auto child_array = context::codegen_utils::getArrowArrayChild(
+                    build_array, col_var->get_column_id());
+
+                int64_t buffer_num =
+                    utils::getBufferNum(col_var->get_type_info().get_type());
+                utils::JITExprValue buffer_values(buffer_num, JITExprValueType::BATCH);
+                for (int64_t i = 0; i < buffer_num; ++i) {
+                  buffer_values.append(
+                      context::codegen_utils::getArrowArrayBuffer(child_array, i));
+                }
+                size_t local_offset =
+                    context.appendArrowArrayValues(child_array, std::move(buffer_values));
+                expr->setLocalIndex(local_offset);
+
+                ColumnReader(context, expr, build_row).read();
+              }
+
+              successor_->consume(context);
+            })
+            ->update([&]() {
+              slot = func->emitRuntimeFunctionCall(
+                  "nextgen_join_probe_next",
+                  JITFunctionEmitDescriptor{
+                      .ret_type = JITTypeTag::INT64,
+                      .params_vector = {hash_table.get(), key_value.get(), slot.get()}});
+            })
+            ->build();
+      })
+      ->build();
+}
+}  // namespace cider::exec::nextgen::operators
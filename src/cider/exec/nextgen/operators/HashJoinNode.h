@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NEXTGEN_OPERATORS_HASHJOINNODE_H
+#define NEXTGEN_OPERATORS_HASHJOINNODE_H
+
+#include "exec/nextgen/operators/OpNode.h"
+
+namespace cider::exec::nextgen::operators {
+// Inner hash join which probes the join hash table of CodegenContext with probe_key for
+// every input row, and produces the build side columns (output exprs) of each match.
+class HashJoinNode : public OpNode {
+ public:
+  HashJoinNode(const ExprPtr& probe_key, const ExprPtr& build_key)
+      : OpNode("HashJoinNode", ExprPtrVector{}, JITExprValueType::ROW)
+      , probe_key_(probe_key)
+      , build_key_(build_key) {}
+
+  ExprPtr& getProbeKey() { return probe_key_; }
+
+  ExprPtr& getBuildKey() { return build_key_; }
+
+  void setBuildExprs(ExprPtrVector&& build_exprs) {
+    output_exprs_ = std::move(build_exprs);
+  }
+
+  TranslatorPtr toTranslator(const TranslatorPtr& successor = nullptr) override;
+
+ private:
+  ExprPtr probe_key_;
+  ExprPtr build_key_;
+};
+
+class HashJoinTranslator : public Translator {
+ public:
+  using Translator::Translator;
+
+  void consume(context::CodegenContext& context) override;
+
+ private:
+  void codegen(context::CodegenContext& context);
+};
+}  // namespace cider::exec::nextgen::operators
+#endif  // NEXTGEN_OPERATORS_HASHJOINNODE_H
@@ -58,6 +58,8 @@ class OpNode : public std::enable_shared_from_this<OpNode> {
 
   void setInputOpNode(const OpNodePtr& input) { input_ = input; }
 
+  const OpNodePtr& getInputOpNode() const { return input_; }
+
   std::pair<JITExprValueType, ExprPtrVector&> getOutputExprs() {
     return {output_type_, output_exprs_};
   }
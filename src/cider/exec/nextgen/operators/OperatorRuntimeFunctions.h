@@ -23,6 +23,7 @@
 #define NEXTEGN_CIDER_FUNCTION_RUNTIME_FUNCTIONS_H
 
 #include "exec/nextgen/context/RuntimeContext.h"
+#include "exec/operator/sort/CiderSortKeysInl.h"
 #include "type/data/funcannotations.h"
 
 /******************* Simple Aggregation Functions For Nextgen ************************/
@@ -58,10 +59,272 @@
   DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(32, aggName, aggFunc)    \
   DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(64, aggName, aggFunc)
 
+#define DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP(type, aggname, aggfunc)                       \
+  extern "C" ALWAYS_INLINE void nextgen_cider_agg_##aggname##_##type(type* agg_val_addr, \
+                                                                     const type val) {   \
+    aggfunc(*agg_val_addr, val);                                                         \
+  }
+
+#define DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP_NULLABLE(type, aggname, aggfunc)          \
+  extern "C" ALWAYS_INLINE void nextgen_cider_agg_##aggname##_##type##_nullable( \
+      type* agg_val_addr, const type val, uint8_t* agg_null_addr, bool is_null) { \
+    if (!is_null) {                                                               \
+      aggfunc(*agg_val_addr, val);                                                \
+      *agg_null_addr = 0;                                                         \
+    }                                                                             \
+  }
+
+#define DEF_NEXTEGN_CIDER_SIMPLE_AGG_ALL_TYPES(aggName, aggFunc)  \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(8, aggName, aggFunc)           \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(16, aggName, aggFunc)          \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(32, aggName, aggFunc)          \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(64, aggName, aggFunc)          \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(8, aggName, aggFunc)  \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(16, aggName, aggFunc) \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(32, aggName, aggFunc) \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(64, aggName, aggFunc) \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP(float, aggName, aggFunc)        \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP(double, aggName, aggFunc)       \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP_NULLABLE(float, aggName, aggFunc) \
+  DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP_NULLABLE(double, aggName, aggFunc)
+
 template <typename T>
 ALWAYS_INLINE void nextgen_cider_agg_sum(T& agg_val, const T& val) {
   agg_val += val;
 }
 DEF_NEXTEGN_CIDER_SIMPLE_AGG_FUNCS(sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(8, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(16, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(8, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(16, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP(float, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP(double, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP_NULLABLE(float, sum, nextgen_cider_agg_sum)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP_NULLABLE(double, sum, nextgen_cider_agg_sum)
+
+// MIN/MAX slots are initialized with the max/lowest value of the type, so no special
+// handling is needed for the first value.
+template <typename T>
+ALWAYS_INLINE void nextgen_cider_agg_min(T& agg_val, const T& val) {
+  agg_val = val < agg_val ? val : agg_val;
+}
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_ALL_TYPES(min, nextgen_cider_agg_min)
+
+template <typename T>
+ALWAYS_INLINE void nextgen_cider_agg_max(T& agg_val, const T& val) {
+  agg_val = val > agg_val ? val : agg_val;
+}
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_ALL_TYPES(max, nextgen_cider_agg_max)
+
+// AVG slot is a 8 bytes sum followed by an int64 count.
+template <typename T>
+ALWAYS_INLINE void nextgen_cider_agg_avg(T& agg_val, const T& val) {
+  agg_val += val;
+  *reinterpret_cast<int64_t*>(&agg_val + 1) += 1;
+}
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT(64, avg, nextgen_cider_agg_avg)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_INT_NULLABLE(64, avg, nextgen_cider_agg_avg)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP(double, avg, nextgen_cider_agg_avg)
+DEF_NEXTEGN_CIDER_SIMPLE_AGG_FP_NULLABLE(double, avg, nextgen_cider_agg_avg)
+
+extern "C" ALWAYS_INLINE void nextgen_cider_agg_count(int64_t* agg_val_addr) {
+  *agg_val_addr += 1;
+}
+
+extern "C" ALWAYS_INLINE void nextgen_cider_agg_count_nullable(int64_t* agg_val_addr,
+                                                               bool is_null) {
+  if (!is_null) {
+    *agg_val_addr += 1;
+  }
+}
+
+#define DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(type, name)                              \
+  extern "C" ALWAYS_INLINE void nextgen_cider_agg_count_distinct_##name(             \
+      int64_t* agg_val_addr, int8_t* set_ptr, const type val) {                       \
+    int64_t key = 0;                                                                  \
+    memcpy(&key, &val, sizeof(type));                                                 \
+    auto cider_set =                                                                  \
+        reinterpret_cast<cider::exec::nextgen::context::CiderCountDistinctSet*>(     \
+            set_ptr);                                                                 \
+    if (cider_set->insertDistinct(reinterpret_cast<int8_t*>(agg_val_addr), key)) {   \
+      *agg_val_addr += 1;                                                             \
+    }                                                                                 \
+  }                                                                                   \
+                                                                                      \
+  extern "C" ALWAYS_INLINE void nextgen_cider_agg_count_distinct_##name##_nullable(  \
+      int64_t* agg_val_addr, int8_t* set_ptr, const type val, bool is_null) {         \
+    if (!is_null) {                                                                   \
+      nextgen_cider_agg_count_distinct_##name(agg_val_addr, set_ptr, val);            \
+    }                                                                                 \
+  }
+
+DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(int8_t, int8)
+DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(int16_t, int16)
+DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(int32_t, int32)
+DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(int64_t, int64)
+DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(float, float)
+DEF_NEXTGEN_CIDER_AGG_COUNT_DISTINCT(double, double)
+
+/******************* Group-by Hash Table Functions For Nextgen ***********************/
+#define DEF_NEXTGEN_GROUPBY_SET_KEY(type, name)                               \
+  extern "C" ALWAYS_INLINE void nextgen_groupby_set_key_##name(               \
+      int8_t* hash_table, const int64_t index, const type val, bool is_null) { \
+    int64_t slot = 0;                                                          \
+    memcpy(&slot, &val, sizeof(type));                                         \
+    reinterpret_cast<cider::exec::nextgen::context::GroupByHashTable*>(       \
+        hash_table)                                                            \
+        ->setFixedKey(index, slot, is_null);                                   \
+  }
+
+DEF_NEXTGEN_GROUPBY_SET_KEY(bool, bool)
+DEF_NEXTGEN_GROUPBY_SET_KEY(int8_t, int8)
+DEF_NEXTGEN_GROUPBY_SET_KEY(int16_t, int16)
+DEF_NEXTGEN_GROUPBY_SET_KEY(int32_t, int32)
+DEF_NEXTGEN_GROUPBY_SET_KEY(int64_t, int64)
+DEF_NEXTGEN_GROUPBY_SET_KEY(float, float)
+DEF_NEXTGEN_GROUPBY_SET_KEY(double, double)
+
+extern "C" ALWAYS_INLINE void nextgen_groupby_append_varlen_key(int8_t* hash_table,
+                                                                const int64_t index,
+                                                                const char* ptr,
+                                                                const int32_t len,
+                                                                bool is_null) {
+  reinterpret_cast<cider::exec::nextgen::context::GroupByHashTable*>(hash_table)
+      ->appendVarlenKey(index, ptr, len, is_null);
+}
+
+extern "C" RUNTIME_EXPORT int8_t* nextgen_groupby_find_or_insert(int8_t* hash_table) {
+  return reinterpret_cast<cider::exec::nextgen::context::GroupByHashTable*>(hash_table)
+      ->findOrInsert();
+}
+
+/******************* Hash Join Functions For Nextgen *********************************/
+// Matches of a probe key are iterated by slot of the join hash table, -1 means there are
+// no more matches.
+extern "C" ALWAYS_INLINE int64_t nextgen_join_probe_first(int8_t* hash_table,
+                                                          const int64_t key) {
+  return reinterpret_cast<cider::exec::nextgen::context::PartitionedJoinHashMap*>(
+             hash_table)
+      ->probeFirst(key);
+}
+
+extern "C" ALWAYS_INLINE int64_t nextgen_join_probe_next(int8_t* hash_table,
+                                                         const int64_t key,
+                                                         const int64_t slot) {
+  return reinterpret_cast<cider::exec::nextgen::context::PartitionedJoinHashMap*>(
+             hash_table)
+      ->probeNext(key, slot);
+}
+
+extern "C" ALWAYS_INLINE int8_t* nextgen_join_get_build_array(int8_t* hash_table,
+                                                              const int64_t slot) {
+  auto& entry =
+      reinterpret_cast<cider::exec::nextgen::context::PartitionedJoinHashMap*>(hash_table)
+          ->valueAt(slot);
+  return reinterpret_cast<int8_t*>(entry.first->getArray());
+}
+
+extern "C" ALWAYS_INLINE int64_t nextgen_join_get_build_row(int8_t* hash_table,
+                                                            const int64_t slot) {
+  return reinterpret_cast<cider::exec::nextgen::context::PartitionedJoinHashMap*>(
+             hash_table)
+      ->valueAt(slot)
+      .second;
+}
+
+/******************* Sort Key Functions For Nextgen **********************************/
+// Generated encoders of normalized sort keys clear the key, encode every key column at
+// its offset, and finish the key into words, see cider::exec::sort::SortKeyLayout.
+extern "C" ALWAYS_INLINE void nextgen_sort_key_clear(int8_t* key, const int64_t bytes) {
+  memset(key, 0, bytes);
+}
+
+#define DEF_NEXTGEN_SORT_KEY_ENCODE(name, width, encoder)                               \
+  extern "C" ALWAYS_INLINE void nextgen_sort_key_encode_##name(                         \
+      int8_t* key, int8_t* column, const int64_t row, bool is_desc, bool nulls_first) { \
+    cider::exec::sort::encodeSortKey(reinterpret_cast<const ArrowArray*>(column),       \
+                                     row,                                               \
+                                     width,                                             \
+                                     is_desc,                                           \
+                                     nulls_first,                                       \
+                                     reinterpret_cast<uint8_t*>(key),                   \
+                                     encoder);                                          \
+  }
+
+#define DEF_NEXTGEN_SORT_KEY_ENCODE_INT(type, name)                                \
+  DEF_NEXTGEN_SORT_KEY_ENCODE(                                                     \
+      name,                                                                        \
+      sizeof(type),                                                                \
+      (cider::exec::sort::encodeIntegerSortKey<type, std::make_unsigned_t<type>>))
+
+#define DEF_NEXTGEN_SORT_KEY_ENCODE_FP(type, bits_type)                 \
+  DEF_NEXTGEN_SORT_KEY_ENCODE(                                          \
+      type,                                                             \
+      sizeof(type),                                                     \
+      (cider::exec::sort::encodeFloatingPointSortKey<type, bits_type>))
+
+DEF_NEXTGEN_SORT_KEY_ENCODE(bool, 1, cider::exec::sort::encodeBooleanSortKey)
+DEF_NEXTGEN_SORT_KEY_ENCODE_INT(int8_t, int8)
+DEF_NEXTGEN_SORT_KEY_ENCODE_INT(int16_t, int16)
+DEF_NEXTGEN_SORT_KEY_ENCODE_INT(int32_t, int32)
+DEF_NEXTGEN_SORT_KEY_ENCODE_INT(int64_t, int64)
+DEF_NEXTGEN_SORT_KEY_ENCODE_FP(float, uint32_t)
+DEF_NEXTGEN_SORT_KEY_ENCODE_FP(double, uint64_t)
+DEF_NEXTGEN_SORT_KEY_ENCODE(string,
+                            cider::exec::sort::kStringKeyPrefixBytes,
+                            cider::exec::sort::encodeStringSortKey)
+
+extern "C" ALWAYS_INLINE void nextgen_sort_key_finish(int8_t* key, const int64_t words) {
+  cider::exec::sort::finishSortKey(reinterpret_cast<int64_t*>(key), words);
+}
+
+/******************* Bitmap Functions For Vectorized ColumnToRow *********************/
+// Loads the 64 bits of bitmap covering rows [row_offset, row_offset + 64), row_offset
+// must be a multiple of 64. Bytes beyond row_num are never read, and a null bitmap means
+// all bits are set.
+extern "C" ALWAYS_INLINE int64_t nextgen_load_bitmap_word(const uint8_t* bitmap,
+                                                          const int64_t row_offset,
+                                                          const int64_t row_num) {
+  if (!bitmap) {
+    return -1;
+  }
+  const uint8_t* ptr = bitmap + (row_offset >> 3);
+  int64_t remain_rows = row_num - row_offset;
+  uint64_t word = 0;
+  if (remain_rows >= 64) {
+    memcpy(&word, ptr, sizeof(word));
+  } else {
+    for (int64_t i = 0; i < ((remain_rows + 7) >> 3); ++i) {
+      word |= static_cast<uint64_t>(ptr[i]) << (i << 3);
+    }
+  }
+  return static_cast<int64_t>(word);
+}
+
+extern "C" ALWAYS_INLINE bool nextgen_check_bitmap_word_set(const int64_t word,
+                                                            const int64_t offset) {
+  return (static_cast<uint64_t>(word) >> offset) & 1;
+}
+
+extern "C" ALWAYS_INLINE bool nextgen_check_bitmap_word_clear(const int64_t word,
+                                                              const int64_t offset) {
+  return !nextgen_check_bitmap_word_set(word, offset);
+}
+
+// Appends offset to the selection vector if the row is selected, returns the number of
+// selected rows. The offset is always stored, so that no branch depends on selected.
+extern "C" ALWAYS_INLINE int64_t nextgen_select_row(int64_t* selection,
+                                                    const int64_t selected_num,
+                                                    const int64_t offset,
+                                                    const bool selected) {
+  selection[selected_num] = offset;
+  return selected_num + selected;
+}
+
+// Arrow may omit the validity bitmap of a column without nulls.
+extern "C" ALWAYS_INLINE bool nextgen_check_validity_bit_clear(const uint8_t* bitmap,
+                                                               const int64_t index) {
+  return bitmap && !CiderBitUtils::isBitSetAt(bitmap, index);
+}
 
 #endif  // NEXTEGN_CIDER_FUNCTION_RUNTIME_FUNCTIONS_H
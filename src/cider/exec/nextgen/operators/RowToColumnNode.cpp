@@ -23,6 +23,7 @@
 
 #include "exec/nextgen/context/CodegenContext.h"
 #include "exec/nextgen/jitlib/JITLib.h"
+#include "exec/nextgen/operators/HashJoinNode.h"
 #include "exec/nextgen/utils/JITExprValue.h"
 
 namespace cider::exec::nextgen::operators {
@@ -31,16 +32,21 @@ using namespace context;
 
 class ColumnWriter {
  public:
+  // Initial data buffer size per row of string columns.
+  static constexpr int64_t kEstimatedBytesPerString = 8;
+
   ColumnWriter(context::CodegenContext& ctx,
                ExprPtr& expr,
                JITValuePointer& arrow_array,
                JITValuePointer& index,
-               JITValuePointer& arrow_array_len)
+               JITValuePointer& arrow_array_len,
+               bool grow_on_demand = false)
       : context_(ctx)
       , expr_(expr)
       , arrow_array_(arrow_array)
       , index_(index)
-      , arrow_array_len_(arrow_array_len) {}
+      , arrow_array_len_(arrow_array_len)
+      , grow_on_demand_(grow_on_demand) {}
 
   void write() {
     // TBD: Whether input ColumnVar's ArrowArray could be overwriten.
@@ -82,20 +88,25 @@ class ColumnWriter {
       // TODO: should set memory to 0.
       return allocateRawDataBuffer(1, bytes);
     });
+    auto offset_num = index_ + 2l;
     auto actual_raw_length_buffer =
-        raw_length_buffer->castPointerSubType(JITTypeTag::INT32);
-    actual_raw_length_buffer[index_ + 1] =
-        actual_raw_length_buffer[index_] + *values.getLength();
+        reserveBuffer(raw_length_buffer, 1, offset_num, 4)
+            ->castPointerSubType(JITTypeTag::INT32);
+    auto cur_offset = actual_raw_length_buffer[index_];
+    auto next_offset = cur_offset + *values.getLength();
+    actual_raw_length_buffer[index_ + 1] = *next_offset;
 
-    // value, buffer size is variable.
+    // value, buffer starts with an estimated size and grows geometrically when it runs
+    // out of capacity.
     auto raw_data_buffer = context_.getJITFunction()->createLocalJITValue([this]() {
-      // FIXME(jikunshang): try add re-allocate for string type buffer.
-      auto bytes = arrow_array_len_ *
-                   context_.getJITFunction()->createLiteral(JITTypeTag::INT64, 10);
+      auto bytes = arrow_array_len_ * context_.getJITFunction()->createLiteral(
+                                          JITTypeTag::INT64, kEstimatedBytesPerString);
       return allocateRawDataBuffer(2, bytes);
     });
-    auto actual_raw_data_buffer = raw_data_buffer->castPointerSubType(JITTypeTag::INT8);
-    auto cur_pointer = actual_raw_data_buffer + *actual_raw_length_buffer[index_];
+    auto required_bytes = next_offset->castJITValuePrimitiveType(JITTypeTag::INT64);
+    auto actual_raw_data_buffer =
+        codegen_utils::reserveArrowArrayBuffer(arrow_array_, 2, required_bytes);
+    auto cur_pointer = actual_raw_data_buffer + *cur_offset;
     context_.getJITFunction()->emitRuntimeFunctionCall(
         "do_memcpy",
         JITFunctionEmitDescriptor{
@@ -132,13 +143,15 @@ class ColumnWriter {
     if (expr_->get_type_info().get_type() == kBOOLEAN) {
       auto raw_data_buffer = context_.getJITFunction()->createLocalJITValue(
           [this]() { return allocateBitwiseBuffer(1); });
+      auto row_num = index_ + 1l;
+      auto actual_raw_data_buffer = reserveBuffer(raw_data_buffer, 1, row_num, 1);
       // leverage existing set_null_vector but need opposite value as input
       // TODO: (yma11) need check in UT
       context_.getJITFunction()->emitRuntimeFunctionCall(
           "set_null_vector_bit",
           JITFunctionEmitDescriptor{
               .ret_type = JITTypeTag::VOID,
-              .params_vector = {{raw_data_buffer.get(),
+              .params_vector = {{actual_raw_data_buffer.get(),
                                  index_.get(),
                                  (!fixsize_val.getValue()).get()}}});
       return raw_data_buffer;
@@ -147,8 +160,11 @@ class ColumnWriter {
         return allocateRawDataBuffer(1, expr_->get_type_info().get_type());
       });
       // Write value
-      auto actual_raw_data_buffer = raw_data_buffer->castPointerSubType(
-          utils::getJITTypeTag(expr_->get_type_info().get_type()));
+      auto type = expr_->get_type_info().get_type();
+      auto row_num = index_ + 1l;
+      auto actual_raw_data_buffer =
+          reserveBuffer(raw_data_buffer, 1, row_num, utils::getTypeBytes(type))
+              ->castPointerSubType(utils::getJITTypeTag(type));
       actual_raw_data_buffer[index_] = *fixsize_val.getValue();
       return raw_data_buffer;
     }
@@ -163,17 +179,34 @@ class ColumnWriter {
       // TBD: Null representation, bit-array or bool-array.
       null_buffer.replace(context_.getJITFunction()->createLocalJITValue(
           [this]() { return allocateBitwiseBuffer(0); }));
+      auto row_num = index_ + 1l;
+      auto actual_null_buffer = reserveBuffer(null_buffer, 0, row_num, 1);
 
       context_.getJITFunction()->emitRuntimeFunctionCall(
           "set_null_vector_bit",
           JITFunctionEmitDescriptor{
               .ret_type = JITTypeTag::VOID,
-              .params_vector = {{null_buffer.get(), index_.get(), null_val.get()}}});
+              .params_vector = {
+                  {actual_null_buffer.get(), index_.get(), null_val.get()}}});
     }
     return null_buffer;
   }
 
  private:
+  // Buffers are sized by input rows. If output rows may outnumber input rows (e.g. join),
+  // returns the buffer grown to hold elements * element_bytes bytes.
+  JITValuePointer reserveBuffer(JITValuePointer& buffer,
+                                int64_t index,
+                                JITValuePointer& elements,
+                                int64_t element_bytes) {
+    if (!grow_on_demand_) {
+      return buffer;
+    }
+    auto bytes = elements * context_.getJITFunction()->createLiteral(JITTypeTag::INT64,
+                                                                     element_bytes);
+    return codegen_utils::reserveArrowArrayBuffer(arrow_array_, index, bytes);
+  }
+
   JITValuePointer allocateBitwiseBuffer(int64_t index = 0) {
     return allocateRawDataBuffer(index, SQLTypes::kTINYINT);
   }
@@ -194,8 +227,48 @@ class ColumnWriter {
   JITValuePointer& arrow_array_;
   JITValuePointer& index_;
   JITValuePointer& arrow_array_len_;
+  bool grow_on_demand_;
 };
 
+namespace {
+// Returns the input column forwarded by expr, or -1 if expr needs to be evaluated.
+int64_t getForwardedColumnId(const ExprPtr& expr) {
+  auto col_var = dynamic_cast<Analyzer::ColumnVar*>(expr.get());
+  if (nullptr == col_var) {
+    return -1;
+  }
+  switch (expr->get_type_info().get_type()) {
+    case kBOOLEAN:
+    case kTINYINT:
+    case kSMALLINT:
+    case kINT:
+    case kBIGINT:
+    case kFLOAT:
+    case kDOUBLE:
+    case kDATE:
+    case kTIMESTAMP:
+    case kTIME:
+    case kVARCHAR:
+    case kCHAR:
+    case kTEXT:
+      // Only columns of the input batch could be forwarded.
+      return col_var->get_rte_idx() == 0 ? col_var->get_column_id() : -1;
+    default:
+      return -1;
+  }
+}
+
+// Whether an operator before R2C may output more rows than its input rows.
+bool mayExpandRows(const OpNodePtr& node) {
+  for (auto op = node; op; op = op->getInputOpNode()) {
+    if (std::dynamic_pointer_cast<HashJoinNode>(op)) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
 TranslatorPtr RowToColumnNode::toTranslator(const TranslatorPtr& succ) {
   return createOpTranslator<RowToColumnTranslator>(shared_from_this(), succ);
 }
@@ -209,6 +282,34 @@ void RowToColumnTranslator::codegen(context::CodegenContext& context) {
   auto&& [type, exprs] = node_->getOutputExprs();
   ExprPtrVector& output_exprs = exprs;
 
+  // Get input ArrowArray length from previous C2RNode
+  auto prev_c2r_node = static_cast<RowToColumnNode*>(node_.get())->getColumnToRowNode();
+  auto input_array_len = prev_c2r_node->getColumnRowNum();
+  bool grow_on_demand = mayExpandRows(node_->getInputOpNode());
+
+  // With late materialization, input columns forwarded to output are not written here,
+  // only the input row index of every output row is recorded. Selection batch is
+  // registered before output batch as the last batch is taken as output.
+  std::vector<int64_t> forwarded_column_ids(output_exprs.size(), -1);
+  JITValuePointer selection_array(nullptr);
+  JITValuePointer selection_buffer(nullptr);
+  if (context.getCodegenOptions().enable_late_materialization) {
+    bool has_forwarded_column = false;
+    for (size_t i = 0; i < output_exprs.size(); ++i) {
+      forwarded_column_ids[i] = getForwardedColumnId(output_exprs[i]);
+      has_forwarded_column |= forwarded_column_ids[i] >= 0;
+    }
+    if (has_forwarded_column) {
+      selection_array.replace(context.registerSelectionVector(forwarded_column_ids));
+      selection_buffer.replace(
+          func->createLocalJITValue([func, &selection_array, &input_array_len]() {
+            auto bytes = input_array_len * func->createLiteral(JITTypeTag::INT64, 4);
+            return codegen_utils::allocateArrowArrayBuffer(selection_array, 1, bytes)
+                ->castPointerSubType(JITTypeTag::INT32);
+          }));
+    }
+  }
+
   // construct output Batch
   auto output_arrow_array = context.registerBatch(
       SQLTypeInfo(kSTRUCT,
@@ -226,19 +327,31 @@ void RowToColumnTranslator::codegen(context::CodegenContext& context) {
 
   auto output_index = func->createVariable(JITTypeTag::INT64, "output_index", 0);
 
-  // Get input ArrowArray length from previous C2RNode
-  auto prev_c2r_node = static_cast<RowToColumnNode*>(node_.get())->getColumnToRowNode();
-  auto input_array_len = prev_c2r_node->getColumnRowNum();
+  if (selection_buffer.get()) {
+    auto input_index = prev_c2r_node->getColumnRowIndex();
+    if (grow_on_demand) {
+      auto bytes = (output_index + 1l) * func->createLiteral(JITTypeTag::INT64, 4);
+      selection_buffer.replace(
+          codegen_utils::reserveArrowArrayBuffer(selection_array, 1, bytes)
+              ->castPointerSubType(JITTypeTag::INT32));
+    }
+    selection_buffer[output_index] =
+        *(input_index->castJITValuePrimitiveType(JITTypeTag::INT32));
+  }
 
   for (int64_t i = 0; i < exprs.size(); ++i) {
     ExprPtr& expr = exprs[i];
+    if (forwarded_column_ids[i] >= 0) {
+      continue;
+    }
 
     auto child_arrow_array = func->createLocalJITValue([&output_arrow_array, &i]() {
       return codegen_utils::getArrowArrayChild(output_arrow_array, i);
     });
 
     // Write rows
-    ColumnWriter writer(context, expr, child_arrow_array, output_index, input_array_len);
+    ColumnWriter writer(
+        context, expr, child_arrow_array, output_index, input_array_len, grow_on_demand);
     writer.write();
   }
   // Update index
@@ -246,10 +359,22 @@ void RowToColumnTranslator::codegen(context::CodegenContext& context) {
 
   // Execute length field updating build function after C2R loop finished.
   prev_c2r_node->registerDeferFunc(
-      [output_index, output_arrow_array, &output_exprs, &context]() mutable {
+      [output_index,
+       output_arrow_array,
+       selection_array,
+       forwarded_column_ids,
+       &output_exprs,
+       &context]() mutable {
         codegen_utils::setArrowArrayLength(output_arrow_array, output_index);
-        for (auto& expr : output_exprs) {
-          size_t local_offset = expr->getLocalIndex();
+        if (selection_array.get()) {
+          codegen_utils::setArrowArrayLength(selection_array, output_index);
+        }
+        for (size_t i = 0; i < output_exprs.size(); ++i) {
+          if (forwarded_column_ids[i] >= 0) {
+            // filled by RuntimeContext::materializeOutputBatch
+            continue;
+          }
+          size_t local_offset = output_exprs[i]->getLocalIndex();
           CHECK_NE(local_offset, 0);
 
           auto&& [arrow_array, _] = context.getArrowArrayValues(local_offset);
@@ -38,7 +38,7 @@ class NextgenAggExtractor {
   std::string getName() { return name_; }
 
  protected:
-  int8_t null_offset_;
+  int32_t null_offset_;
   bool is_nullable_;
   const std::string name_;
 };
@@ -52,7 +52,7 @@ class NextgenBasicAggExtractor : public NextgenAggExtractor {
       : NextgenAggExtractor(name) {
     offset_ = info.start_offset_;
     null_offset_ = info.null_offset_;
-    is_nullable_ = !info.sql_type_info_.get_notnull();
+    is_nullable_ = info.isNullable();
   }
 
   void extract(const std::vector<const int8_t*>& rowAddrs, ArrowArray* output) override {
@@ -86,6 +86,45 @@ class NextgenBasicAggExtractor : public NextgenAggExtractor {
   size_t offset_;
   size_t index_in_null_vector_;
 };
+
+// AVG slot is a sum of type ST followed by an int64 count.
+template <typename ST, typename TT>
+class NextgenAvgAggExtractor : public NextgenAggExtractor {
+ public:
+  NextgenAvgAggExtractor(const std::string& name,
+                         const int8_t* buffer,
+                         context::AggExprsInfo& info)
+      : NextgenAggExtractor(name) {
+    offset_ = info.start_offset_;
+    null_offset_ = info.null_offset_;
+    is_nullable_ = info.isNullable();
+  }
+
+  void extract(const std::vector<const int8_t*>& rowAddrs, ArrowArray* output) override {
+    size_t rowNum = rowAddrs.size();
+    void** no_const_buffer = const_cast<void**>(output->buffers);
+
+    uint8_t* null_buffer = reinterpret_cast<uint8_t*>(no_const_buffer[0]);
+    TT* buffer = reinterpret_cast<TT*>(no_const_buffer[1]);
+
+    int64_t null_count_num = 0;
+    for (size_t i = 0; i < rowNum; ++i) {
+      const int8_t* rowPtr = rowAddrs[i];
+      ST sum = *reinterpret_cast<const ST*>(rowPtr + offset_);
+      int64_t count = *reinterpret_cast<const int64_t*>(rowPtr + offset_ + sizeof(ST));
+      if (count == 0) {
+        CiderBitUtils::clearBitAt(null_buffer, i);
+        ++null_count_num;
+      } else {
+        buffer[i] = static_cast<TT>(static_cast<double>(sum) / count);
+      }
+    }
+    output->null_count = null_count_num;
+  }
+
+ private:
+  size_t offset_;
+};
 }  // namespace cider::exec::nextgen::operators
 
 #endif  // NEXTGEN_AGG_EXTRACTOR_H
@@ -21,81 +21,28 @@
 #include "exec/nextgen/operators/extractor/AggExtractorBuilder.h"
 
 namespace cider::exec::nextgen::operators {
-std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildNextgenAggExtractor(
-    const int8_t* buffer,
-    context::AggExprsInfo& info) {
-  switch (info.agg_type_) {
-    case SQLAgg::kAVG:
-      return buildAVGAggExtractor(buffer);
-    case SQLAgg::kCOUNT:
-      return buildCountAggExtractor(buffer);
-    default:
-      return buildBasicAggExtractor(buffer, info);
-  }
-}
-
-std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildBasicAggExtractor(
+namespace {
+template <template <typename, typename> class ExtractorT, typename ST>
+std::unique_ptr<NextgenAggExtractor> buildExtractorWithSlotType(
     const int8_t* buffer,
     context::AggExprsInfo& info) {
-  size_t actual_size = info.byte_size_;
-
+  std::string name = std::string(jitlib::getJITTypeName(info.jit_value_type_)) + "_";
   switch (info.sql_type_info_.get_type()) {
     case kTINYINT:
-      switch (actual_size) {
-        case 4:
-          return std::make_unique<NextgenBasicAggExtractor<int32_t, int8_t>>(
-              "INT32_INT8", buffer, info);
-        case 8:
-          return std::make_unique<NextgenBasicAggExtractor<int64_t, int8_t>>(
-              "INT64_INT8", buffer, info);
-      }
+      return std::make_unique<ExtractorT<ST, int8_t>>(name + "INT8", buffer, info);
     case kSMALLINT:
-      switch (actual_size) {
-        case 4:
-          return std::make_unique<NextgenBasicAggExtractor<int32_t, int16_t>>(
-              "INT32_INT16", buffer, info);
-        case 8:
-          return std::make_unique<NextgenBasicAggExtractor<int64_t, int16_t>>(
-              "INT64_INT16", buffer, info);
-      }
+      return std::make_unique<ExtractorT<ST, int16_t>>(name + "INT16", buffer, info);
     case kINT:
-      switch (actual_size) {
-        case 4:
-          return std::make_unique<NextgenBasicAggExtractor<int32_t, int32_t>>(
-              "INT32_INT32", buffer, info);
-        case 8:
-          return std::make_unique<NextgenBasicAggExtractor<int64_t, int32_t>>(
-              "INT64_INT32", buffer, info);
-      }
-
+    case kDATE:
+      return std::make_unique<ExtractorT<ST, int32_t>>(name + "INT32", buffer, info);
     case kBIGINT:
-      switch (actual_size) {
-        case 4:
-          return std::make_unique<NextgenBasicAggExtractor<int32_t, int64_t>>(
-              "INT32_INT64", buffer, info);
-        case 8:
-          return std::make_unique<NextgenBasicAggExtractor<int64_t, int64_t>>(
-              "INT64_INT64", buffer, info);
-      }
+    case kTIME:
+    case kTIMESTAMP:
+      return std::make_unique<ExtractorT<ST, int64_t>>(name + "INT64", buffer, info);
     case kFLOAT:
-      switch (actual_size) {
-        case 4:
-          return std::make_unique<NextgenBasicAggExtractor<float, float>>(
-              "FLOAT_FLOAT", buffer, info);
-        case 8:
-          return std::make_unique<NextgenBasicAggExtractor<double, float>>(
-              "DOUBLE_FLOAT", buffer, info);
-      }
+      return std::make_unique<ExtractorT<ST, float>>(name + "FLOAT", buffer, info);
     case kDOUBLE:
-      switch (actual_size) {
-        case 4:
-          return std::make_unique<NextgenBasicAggExtractor<float, double>>(
-              "FLOAT_DOUBLE", buffer, info);
-
-        case 8:
-          return std::make_unique<NextgenBasicAggExtractor<double, double>>(
-              "DOUBLE_DOUBLE", buffer, info);
-      }
+      return std::make_unique<ExtractorT<ST, double>>(name + "DOUBLE", buffer, info);
     case kBOOLEAN:
     case kDECIMAL:
     case kTEXT:
@@ -106,15 +53,58 @@ std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildBasicAggEx
   }
 }
 
+template <template <typename, typename> class ExtractorT>
+std::unique_ptr<NextgenAggExtractor> buildExtractor(const int8_t* buffer,
+                                                    context::AggExprsInfo& info) {
+  switch (info.jit_value_type_) {
+    case jitlib::JITTypeTag::INT8:
+      return buildExtractorWithSlotType<ExtractorT, int8_t>(buffer, info);
+    case jitlib::JITTypeTag::INT16:
+      return buildExtractorWithSlotType<ExtractorT, int16_t>(buffer, info);
+    case jitlib::JITTypeTag::INT32:
+      return buildExtractorWithSlotType<ExtractorT, int32_t>(buffer, info);
+    case jitlib::JITTypeTag::INT64:
+      return buildExtractorWithSlotType<ExtractorT, int64_t>(buffer, info);
+    case jitlib::JITTypeTag::FLOAT:
+      return buildExtractorWithSlotType<ExtractorT, float>(buffer, info);
+    case jitlib::JITTypeTag::DOUBLE:
+      return buildExtractorWithSlotType<ExtractorT, double>(buffer, info);
+    default:
+      LOG(ERROR) << "Unsupported slot type. ";
+      return nullptr;
+  }
+}
+}  // namespace
+
+std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildNextgenAggExtractor(
+    const int8_t* buffer,
+    context::AggExprsInfo& info) {
+  switch (info.agg_type_) {
+    case SQLAgg::kAVG:
+      return buildAVGAggExtractor(buffer, info);
+    case SQLAgg::kCOUNT:
+      return buildCountAggExtractor(buffer, info);
+    default:
+      return buildBasicAggExtractor(buffer, info);
+  }
+}
+
+std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildBasicAggExtractor(
+    const int8_t* buffer,
+    context::AggExprsInfo& info) {
+  return buildExtractor<NextgenBasicAggExtractor>(buffer, info);
+}
+
 std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildAVGAggExtractor(
-    const int8_t* buffer) {
-  LOG(FATAL) << "Avg agg extractor is not support yet";
-  return nullptr;
+    const int8_t* buffer,
+    context::AggExprsInfo& info) {
+  return buildExtractor<NextgenAvgAggExtractor>(buffer, info);
 }
 
 std::unique_ptr<NextgenAggExtractor> NextgenAggExtractorBuilder::buildCountAggExtractor(
-    const int8_t* buffer) {
-  LOG(FATAL) << "Sum agg extractor is not support yet";
-  return nullptr;
+    const int8_t* buffer,
+    context::AggExprsInfo& info) {
+  // COUNT is counted in int64 slot and never null.
+  return buildExtractor<NextgenBasicAggExtractor>(buffer, info);
 }
 }  // namespace cider::exec::nextgen::operators
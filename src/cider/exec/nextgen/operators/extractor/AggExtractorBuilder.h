@@ -37,10 +37,13 @@ class NextgenAggExtractorBuilder {
       const int8_t* buffer,
       context::AggExprsInfo& info);
 
-  static std::unique_ptr<NextgenAggExtractor> buildAVGAggExtractor(const int8_t* buffer);
+  static std::unique_ptr<NextgenAggExtractor> buildAVGAggExtractor(
+      const int8_t* buffer,
+      context::AggExprsInfo& info);
 
   static std::unique_ptr<NextgenAggExtractor> buildCountAggExtractor(
-      const int8_t* buffer);
+      const int8_t* buffer,
+      context::AggExprsInfo& info);
 };
 }  // namespace cider::exec::nextgen::operators
 
@@ -24,6 +24,7 @@
 #include "exec/nextgen/operators/AggregationNode.h"
 #include "exec/nextgen/operators/ArrowSourceNode.h"
 #include "exec/nextgen/operators/FilterNode.h"
+#include "exec/nextgen/operators/HashJoinNode.h"
 #include "exec/nextgen/operators/ProjectNode.h"
 #include "util/Logger.h"
 
@@ -31,16 +32,118 @@ namespace cider::exec::nextgen::parsers {
 
 using namespace cider::exec::nextgen::operators;
 
+// Returns the index of the integer equi-join qual between the probe table (rte_idx 0)
+// and the build table, or -1 if there is no such qual.
+static int getJoinKeyQualIndex(const JoinCondition& condition) {
+  int index = 0;
+  for (auto& qual : condition.quals) {
+    auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual.get());
+    if (bin_oper && bin_oper->get_optype() == kEQ) {
+      auto lhs = dynamic_cast<const Analyzer::ColumnVar*>(
+          bin_oper->get_own_left_operand().get());
+      auto rhs = dynamic_cast<const Analyzer::ColumnVar*>(
+          bin_oper->get_own_right_operand().get());
+      if (lhs && rhs && lhs->get_rte_idx() != rhs->get_rte_idx() &&
+          (lhs->get_rte_idx() == 0 || rhs->get_rte_idx() == 0) &&
+          lhs->get_type_info().is_integer() && rhs->get_type_info().is_integer()) {
+        return index;
+      }
+    }
+    ++index;
+  }
+  return -1;
+}
+
+static bool hasGroupBy(const RelAlgExecutionUnit& eu) {
+  return !eu.groupby_exprs.empty() && eu.groupby_exprs.front();
+}
+
+static bool isAggregation(const RelAlgExecutionUnit& eu) {
+  return hasGroupBy(eu) || std::any_of(eu.shared_target_exprs.begin(),
+                                       eu.shared_target_exprs.end(),
+                                       [](const ExprPtr& target) {
+                                         return target->get_contains_agg();
+                                       });
+}
+
+static bool isParseableTargets(const RelAlgExecutionUnit& eu) {
+  if (!isAggregation(eu)) {
+    return true;
+  }
+  for (auto& target : eu.shared_target_exprs) {
+    if (target->get_contains_agg()) {
+      if (!dynamic_cast<const Analyzer::AggExpr*>(target.get())) {
+        LOG(ERROR) << "Expressions over aggregations are not supported in "
+                      "RelAlgExecutionUnitParser.";
+        return false;
+      }
+    } else if (!hasGroupBy(eu)) {
+      LOG(ERROR) << "Non-aggregated targets without GROUP BY are not supported in "
+                    "RelAlgExecutionUnitParser.";
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the index of the group-by key which target refers to, or -1 if there is no
+// such key.
+static int getGroupByKeyIndex(const ExprPtr& target, const ExprPtrVector& groupbys) {
+  if (auto var = dynamic_cast<const Analyzer::Var*>(target.get())) {
+    if (var->get_which_row() == Analyzer::Var::kGROUPBY) {
+      // varno starts from 1.
+      CHECK_GT(var->get_varno(), 0);
+      CHECK_LE(static_cast<size_t>(var->get_varno()), groupbys.size());
+      return var->get_varno() - 1;
+    }
+  }
+  for (size_t i = 0; i < groupbys.size(); ++i) {
+    if (*groupbys[i] == *target) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Replaces the group-by Vars in expr with the group-by exprs they refer to.
+static ExprPtr resolveGroupByVars(const ExprPtr& expr, const ExprPtrVector& groupbys) {
+  if (auto var = dynamic_cast<const Analyzer::Var*>(expr.get())) {
+    if (var->get_which_row() == Analyzer::Var::kGROUPBY) {
+      return groupbys[getGroupByKeyIndex(expr, groupbys)];
+    }
+  }
+  auto copy = expr->deep_copy();
+  for (ExprPtr* child : copy->get_children_reference()) {
+    if (child && child->get()) {
+      *child = resolveGroupByVars(*child, groupbys);
+    }
+  }
+  return copy;
+}
+
 static bool isParseable(const RelAlgExecutionUnit& eu) {
-  if (!eu.join_quals.empty()) {
-    LOG(ERROR) << "JOIN is not supported in RelAlgExecutionUnitParser.";
+  if (!isParseableTargets(eu)) {
     return false;
   }
-  if (eu.groupby_exprs.size() > 1 || *eu.groupby_exprs.begin() != nullptr) {
-    LOG(ERROR) << "GroupBy is not supported in RelAlgExecutionUnitParser.";
+  if (eu.join_quals.empty()) {
+    return true;
+  }
+  // TODO: Support multi-level joins and other join types.
+  if (eu.join_quals.size() > 1) {
+    LOG(ERROR) << "Multi-level JOIN is not supported in RelAlgExecutionUnitParser.";
+    return false;
+  }
+  auto& condition = eu.join_quals.front();
+  if (condition.type != JoinType::INNER) {
+    LOG(ERROR) << toString(condition.type)
+               << " JOIN is not supported in RelAlgExecutionUnitParser.";
+    return false;
+  }
+  if (getJoinKeyQualIndex(condition) < 0) {
+    LOG(ERROR) << "JOIN without integer equi-join key is not supported in "
+                  "RelAlgExecutionUnitParser.";
     return false;
   }
-
   return true;
 }
 
@@ -61,11 +164,22 @@ class InputAnalyzer {
       input_desc_to_index_.insert({input_desc_[i], i});
     }
 
+    std::shared_ptr<HashJoinNode> join_node = nullptr;
     for (auto& op : pipeline_) {
+      if (auto node = std::dynamic_pointer_cast<HashJoinNode>(op)) {
+        join_node = node;
+        traverse(&join_node->getProbeKey());
+        continue;
+      }
       auto&& [type, exprs] = op->getOutputExprs();
       for (auto& expr : exprs) {
         traverse(&expr);
       }
+      if (auto agg_node = std::dynamic_pointer_cast<AggNode>(op)) {
+        for (auto& expr : agg_node->getGroupByExprs()) {
+          traverse(&expr);
+        }
+      }
     }
 
     input_exprs_.erase(
@@ -74,6 +188,22 @@ class InputAnalyzer {
                        [](const ExprPtr& input_expr) { return input_expr == nullptr; }),
         input_exprs_.end());
 
+    // Columns of build table are read by HashJoinNode from matched build rows.
+    if (join_node) {
+      ExprPtrVector probe_exprs;
+      ExprPtrVector build_exprs;
+      for (auto& expr : input_exprs_) {
+        auto col_var = dynamic_cast<Analyzer::ColumnVar*>(expr.get());
+        if (col_var->get_rte_idx() == 0) {
+          probe_exprs.push_back(expr);
+        } else {
+          build_exprs.push_back(expr);
+        }
+      }
+      join_node->setBuildExprs(std::move(build_exprs));
+      input_exprs_ = std::move(probe_exprs);
+    }
+
     pipeline_.insert(pipeline_.begin(), createOpNode<ArrowSourceNode>(input_exprs_));
   }
 
@@ -131,6 +261,25 @@ OpPipeline toOpPipeline(const RelAlgExecutionUnit& eu) {
   OpPipeline ops;
 
   ExprPtrVector filters;
+  if (!eu.join_quals.empty()) {
+    auto& condition = eu.join_quals.front();
+    int key_index = getJoinKeyQualIndex(condition);
+    int index = 0;
+    for (auto& qual : condition.quals) {
+      if (index++ != key_index) {
+        filters.push_back(qual);
+        continue;
+      }
+      auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual.get());
+      auto probe_key = bin_oper->get_own_left_operand();
+      auto build_key = bin_oper->get_own_right_operand();
+      if (std::dynamic_pointer_cast<Analyzer::ColumnVar>(probe_key)->get_rte_idx() != 0) {
+        std::swap(probe_key, build_key);
+      }
+      ops.emplace_back(createOpNode<operators::HashJoinNode>(probe_key, build_key));
+    }
+  }
+
   for (auto& filter_expr : eu.simple_quals) {
     filters.push_back(filter_expr);
   }
@@ -142,24 +291,37 @@ OpPipeline toOpPipeline(const RelAlgExecutionUnit& eu) {
   ExprPtrVector projs;
   ExprPtrVector aggs;
   ExprPtrVector groupbys;
+  std::vector<context::AggOutputColumn> agg_output_columns;
+
+  if (hasGroupBy(eu)) {
+    for (auto& groupby_expr : eu.groupby_exprs) {
+      groupbys.push_back(groupby_expr);
+    }
+  }
 
+  const bool is_aggregation = isAggregation(eu);
   for (auto& targets_expr : eu.shared_target_exprs) {
-    if (targets_expr->get_contains_agg()) {
+    if (!is_aggregation) {
+      projs.push_back(targets_expr);
+    } else if (targets_expr->get_contains_agg()) {
+      agg_output_columns.push_back({false, aggs.size()});
       aggs.push_back(targets_expr);
     } else {
-      projs.push_back(targets_expr);
+      // Other targets depend on group-by keys only. An expression over keys is added as
+      // an extra key, which doesn't split any group, so it's output like a key.
+      int key_index = getGroupByKeyIndex(targets_expr, groupbys);
+      if (key_index < 0) {
+        key_index = groupbys.size();
+        groupbys.push_back(resolveGroupByVars(targets_expr, groupbys));
+      }
+      agg_output_columns.push_back({true, static_cast<size_t>(key_index)});
     }
   }
   ops.emplace_back(createOpNode<operators::ProjectNode>(projs));
 
-  if (!eu.groupby_exprs.empty() && eu.groupby_exprs.front()) {
-    for (auto& groupby_expr : eu.groupby_exprs) {
-      groupbys.push_back(groupby_expr);
-    }
-  }
-
-  if (!groupbys.empty() || !aggs.empty()) {
-    ops.emplace_back(createOpNode<operators::AggNode>(groupbys, aggs));
+  if (is_aggregation) {
+    ops.emplace_back(
+        createOpNode<operators::AggNode>(groupbys, aggs, agg_output_columns));
   }
 
   insertSourceNode(eu, ops);
@@ -38,6 +38,7 @@
 #include "function/scalar/RuntimeFunctions.h"
 
 #include "exec/operator/aggregate/CiderAggHashTable.h"
+#include "exec/operator/aggregate/CiderAggSpillBufferMgr.h"
 
 std::vector<CiderHasher::kColumnInfo> CiderHasher::initColsRange(
     const std::vector<SQLTypeInfo>& key_types) {
@@ -691,8 +692,23 @@ void CiderAggHashTable::updateBufferCapacity(size_t memory_usage_upper) {
   buffer_width_ = buffer_entry_num_ * row_width_;
 }
 
+namespace {
+// Memory which can still be allocated, unbounded unless the allocator tracks memory.
+size_t getAvailableMemory(const std::shared_ptr<CiderAllocator>& allocator) {
+  auto tracker = std::dynamic_pointer_cast<CiderTrackingAllocator>(allocator);
+  return tracker ? tracker->getAvailable() : kMaxMemory;
+}
+}  // namespace
+
 bool CiderAggHashTable::rehash() {
   uint64_t buffer_entry_limit = buffer_memory_limit_;
+  if (hasher_.getHashMode() == CiderHasher::kDirectHash) {
+    // Don't grow beyond the memory left in allocator, so that the table spills before
+    // allocation fails.
+    buffer_entry_limit = std::min<uint64_t>(
+        buffer_entry_limit,
+        std::max<uint64_t>(buffer_width_, getAvailableMemory(allocator_)));
+  }
   buffer_entry_limit /= row_width_;
 
   if (hasher_.getHashMode() == CiderHasher::kDirectHash &&
@@ -729,6 +745,248 @@ bool CiderAggHashTable::rehash() {
   return true;
 }
 
+namespace {
+constexpr size_t kSpillPartitionNum = 16;
+// 64KB per spill chunk, so staging rows of all partitions takes 1MB.
+constexpr size_t kSpillPagesPerChunk = 16;
+constexpr uint32_t kSpillHashSeed = 0x5bd1e995;
+
+template <typename T>
+void mergeAggSlot(SQLAgg agg_type, int8_t* slot, const int8_t* spilled_slot) {
+  T& value = *reinterpret_cast<T*>(slot);
+  const T spilled_value = *reinterpret_cast<const T*>(spilled_slot);
+  switch (agg_type) {
+    case kAVG:
+    case kSUM:
+    case kCOUNT:
+      value += spilled_value;
+      break;
+    case kMIN:
+      value = std::min(value, spilled_value);
+      break;
+    case kMAX:
+      value = std::max(value, spilled_value);
+      break;
+    default:
+      // kSAMPLE and kSINGLE_VALUE keep any of the values.
+      break;
+  }
+}
+}  // namespace
+
+bool CiderAggHashTable::canSpill() const {
+  // Null states of targets are only tracked by null vectors in Cider data format.
+  if (!query_mem_desc_->useCiderDataFormat() || query_mem_desc_->hasCountDistinct() ||
+      hasher_.getHashMode() != CiderHasher::kDirectHash) {
+    return false;
+  }
+  for (size_t i = key_columns_num_; i < columns_num_; ++i) {
+    switch (cols_info_[i].agg_type) {
+      case kAVG:
+      case kMIN:
+      case kMAX:
+      case kSUM:
+      case kCOUNT:
+      case kSAMPLE:
+      case kSINGLE_VALUE:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+CiderAggHashTable::SpillWriter CiderAggHashTable::makeSpillWriter(
+    size_t level,
+    std::vector<SpillPartition>& partitions) {
+  if (!spill_buffer_mgr_) {
+    spill_buffer_mgr_ = std::make_unique<CiderAggSpillBufferMgr>(
+        CiderAggSpillBufferMgr::RWMODE, true, nullptr, 0, kSpillPagesPerChunk);
+  }
+  partitions.resize(kSpillPartitionNum, SpillPartition{level, {}});
+  return SpillWriter{
+      level, std::vector<std::vector<int8_t>>(kSpillPartitionNum), partitions};
+}
+
+void CiderAggHashTable::spillBuffer(SpillWriter& writer) {
+  const int8_t* buffer_ptr = getBuffersPtrAt(0);
+  const uint8_t* empty_map_ptr = getBufferEmptyMapAt(0);
+  for (size_t i = 0; i < buffer_entry_num_; ++i) {
+    if (CiderBitUtils::isBitSetAt(empty_map_ptr, i)) {
+      appendSpillRow(writer, buffer_ptr + row_width_ * i);
+    }
+  }
+  resetBuffer(0);
+  runtime_state_[0].bufferCleared();
+}
+
+void CiderAggHashTable::appendSpillRow(SpillWriter& writer, const int8_t* row) {
+  // Hash keys with another seed per level, so that an oversized partition is split by
+  // spilling it again.
+  const size_t partition_index =
+      MurmurHash3(row, group_target_offset_, kSpillHashSeed + writer.level) %
+      kSpillPartitionNum;
+  auto& staging = writer.staging[partition_index];
+  staging.insert(staging.end(), row, row + row_width_);
+  if (staging.size() + row_width_ > spill_buffer_mgr_->getPartitionSize()) {
+    flushSpillChunk(writer, partition_index);
+  }
+}
+
+void CiderAggHashTable::flushSpillChunk(SpillWriter& writer, size_t partition_index) {
+  auto& staging = writer.staging[partition_index];
+  if (staging.empty()) {
+    return;
+  }
+
+  auto spill_file = spill_buffer_mgr_->getSpillFile();
+  const size_t chunk_index = spill_chunk_num_++;
+  if (chunk_index >= spill_file->getPartitionNum()) {
+    spill_file->resizeSpillFile(chunk_index + 1);
+  }
+  auto chunk = spill_buffer_mgr_->toPartitionAt(chunk_index);
+  CHECK(chunk);
+  memcpy(chunk, staging.data(), staging.size());
+
+  writer.partitions[partition_index].chunks.emplace_back(chunk_index,
+                                                         staging.size() / row_width_);
+  staging.clear();
+}
+
+void CiderAggHashTable::flushSpillWriter(SpillWriter& writer) {
+  for (size_t i = 0; i < kSpillPartitionNum; ++i) {
+    flushSpillChunk(writer, i);
+  }
+}
+
+bool CiderAggHashTable::spill() {
+  if (!canSpill()) {
+    return false;
+  }
+
+  auto writer = makeSpillWriter(0, spill_partitions_);
+  spillBuffer(writer);
+  flushSpillWriter(writer);
+  runtime_state_[0].rowsSpilled();
+  return true;
+}
+
+bool CiderAggHashTable::loadNextSpillPartition() {
+  if (!spill_draining_) {
+    if (spill_partitions_.empty()) {
+      return false;
+    }
+    // Groups still in memory join their partitions on disk.
+    auto writer = makeSpillWriter(0, spill_partitions_);
+    spillBuffer(writer);
+    flushSpillWriter(writer);
+    for (auto& partition : spill_partitions_) {
+      if (!partition.chunks.empty()) {
+        pending_spill_partitions_.push_back(std::move(partition));
+      }
+    }
+    spill_partitions_.clear();
+    spill_draining_ = true;
+  }
+
+  resetBuffer(0);
+  runtime_state_[0].bufferCleared();
+  if (pending_spill_partitions_.empty()) {
+    clearSpill();
+    return false;
+  }
+
+  auto partition = std::move(pending_spill_partitions_.front());
+  pending_spill_partitions_.pop_front();
+
+  // If the partition doesn't fit in the buffer, the buffer and the remaining rows are
+  // spilled again into sub-partitions.
+  std::vector<SpillPartition> sub_partitions;
+  std::unique_ptr<SpillWriter> overflow_writer;
+  std::vector<int8_t> rows;
+  for (auto [chunk_index, row_num] : partition.chunks) {
+    auto chunk = reinterpret_cast<const int8_t*>(
+        spill_buffer_mgr_->toPartitionAt(chunk_index));
+    CHECK(chunk);
+    // Copy out the chunk, spilling again remaps the spill buffer.
+    rows.assign(chunk, chunk + row_num * row_width_);
+
+    for (size_t i = 0; i < row_num; ++i) {
+      const int8_t* row = rows.data() + row_width_ * i;
+      if (!overflow_writer) {
+        auto target_ptr = getGroupTargetPtr(reinterpret_cast<const int64_t*>(row));
+        if (target_ptr) {
+          mergeSpilledRow(reinterpret_cast<int8_t*>(target_ptr) - group_target_offset_,
+                          row);
+          continue;
+        }
+        overflow_writer = std::make_unique<SpillWriter>(
+            makeSpillWriter(partition.level + 1, sub_partitions));
+        spillBuffer(*overflow_writer);
+      }
+      appendSpillRow(*overflow_writer, row);
+    }
+  }
+
+  if (overflow_writer) {
+    flushSpillWriter(*overflow_writer);
+    for (auto& sub_partition : sub_partitions) {
+      if (!sub_partition.chunks.empty()) {
+        pending_spill_partitions_.push_front(std::move(sub_partition));
+      }
+    }
+    return loadNextSpillPartition();
+  }
+  if (pending_spill_partitions_.empty()) {
+    clearSpill();
+  }
+  return true;
+}
+
+void CiderAggHashTable::mergeSpilledRow(int8_t* row, const int8_t* spilled_row) {
+  auto nulls = reinterpret_cast<uint8_t*>(row + group_target_null_offset_);
+  auto spilled_nulls =
+      reinterpret_cast<const uint8_t*>(spilled_row + group_target_null_offset_);
+  for (size_t i = key_columns_num_; i < columns_num_; ++i) {
+    const auto& info = cols_info_[i];
+    const size_t null_index = i - key_columns_num_;
+    int8_t* slot = row + info.slot_offset;
+    const int8_t* spilled_slot = spilled_row + info.slot_offset;
+    const size_t width = getActualDataWidth(i);
+
+    // Bit set in null vector means NOT NULL.
+    if (!info.sql_type_info.get_notnull()) {
+      if (!CiderBitUtils::isBitSetAt(spilled_nulls, null_index)) {
+        continue;
+      }
+      if (!CiderBitUtils::isBitSetAt(nulls, null_index)) {
+        memcpy(slot, spilled_slot, width);
+        CiderBitUtils::setBitAt(nulls, null_index);
+        continue;
+      }
+    }
+
+    if (info.sql_type_info.is_fp() && 4 == width) {
+      mergeAggSlot<float>(info.agg_type, slot, spilled_slot);
+    } else if (info.sql_type_info.is_fp()) {
+      mergeAggSlot<double>(info.agg_type, slot, spilled_slot);
+    } else if (4 == width) {
+      mergeAggSlot<int32_t>(info.agg_type, slot, spilled_slot);
+    } else {
+      mergeAggSlot<int64_t>(info.agg_type, slot, spilled_slot);
+    }
+  }
+}
+
+void CiderAggHashTable::clearSpill() {
+  spill_partitions_.clear();
+  pending_spill_partitions_.clear();
+  spill_buffer_mgr_.reset();
+  spill_chunk_num_ = 0;
+  spill_draining_ = false;
+}
+
 size_t CiderAggHashTable::getActualDataWidth(size_t column_index) const {
   CHECK_LT(column_index, columns_num_);
 
@@ -23,6 +23,7 @@
 #define CIDER_CIDERAGGHASHTABLE_H
 
 #include <cstddef>
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -41,6 +42,7 @@ extern bool g_bigint_count;
 
 class RelAlgExecutionUnit;
 class QueryMemoryDescriptor;
+class CiderAggSpillBufferMgr;
 
 struct CiderAggHashTableEntryInfo {
   bool is_key;
@@ -300,7 +302,36 @@ class CiderAggHashTable {
 
   bool rehash();
 
+  // Moves all groups in the buffer into hash partitions on disk and clears the buffer.
+  // Returns false if the aggregation states can't be spilled.
+  bool spill();
+  bool hasSpilled() const { return spill_draining_ || !spill_partitions_.empty(); }
+  bool hasPendingSpillPartitions() const { return !pending_spill_partitions_.empty(); }
+  // Clears the buffer and re-aggregates the next spilled partition into it, groups
+  // left in memory are spilled at the first call. Returns false if no partition left.
+  bool loadNextSpillPartition();
+
  private:
+  struct SpillPartition {
+    size_t level;
+    std::vector<std::pair<size_t, size_t>> chunks;  // {chunk index, row number}
+  };
+
+  struct SpillWriter {
+    size_t level;
+    std::vector<std::vector<int8_t>> staging;
+    std::vector<SpillPartition>& partitions;
+  };
+
+  bool canSpill() const;
+  SpillWriter makeSpillWriter(size_t level, std::vector<SpillPartition>& partitions);
+  void spillBuffer(SpillWriter& writer);
+  void appendSpillRow(SpillWriter& writer, const int8_t* row);
+  void flushSpillChunk(SpillWriter& writer, size_t partition_index);
+  void flushSpillWriter(SpillWriter& writer);
+  void mergeSpilledRow(int8_t* row, const int8_t* spilled_row);
+  void clearSpill();
+
   std::vector<CiderAggHashTableEntryInfo> fillColsInfo();
   std::vector<int8_t> fillRowData();
   int8_t* allocateBufferAt(size_t buffer_id);
@@ -364,6 +395,14 @@ class CiderAggHashTable {
   size_t group_key_null_offset_;
   size_t group_target_offset_;
   size_t group_target_null_offset_;
+
+  std::unique_ptr<CiderAggSpillBufferMgr> spill_buffer_mgr_;
+  size_t spill_chunk_num_{0};
+  // Partitions being spilled by processing, indexed by the hash of keys.
+  std::vector<SpillPartition> spill_partitions_;
+  // Partitions to re-aggregate while fetching results.
+  std::deque<SpillPartition> pending_spill_partitions_;
+  bool spill_draining_{false};
 };
 
 #endif
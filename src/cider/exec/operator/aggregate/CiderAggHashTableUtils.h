@@ -48,6 +48,9 @@ class CiderAggHashTableBufferRuntimeState {
     return row_index_need_spill_vec_;
   }
 
+  // Rows failed to insert are aggregated again after spilling.
+  void rowsSpilled() { row_index_need_spill_vec_.clear(); }
+
   size_t getEmptyEntryNum() const { return empty_entry_num_; }
   size_t getNonEmptyEntryNum() const { return buffer_entry_num_ - empty_entry_num_; }
   void addEmptyEntryNum(size_t num) { empty_entry_num_ += num; }
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+A hash map specialized for hash join, which is built once and probed many times.
+Advantages:
+  - Tags (7 bits of hash) and keys of slots are stored in separated arrays, a probe
+    compares the tags of a group of 16 slots at once with SIMD, and only compares keys
+    whose tag matches.
+  - Every distinct key takes one slot, values of duplicate keys are chained in an entry
+    array, so probing never walks through duplicates of other keys.
+  - Matches are iterated by entry index, without any allocation per probe.
+  - find_many prefetches slots of following keys while probing a batch of keys.
+  - Maximum load factor is 7/8.
+Disadvantages:
+  - No erase.
+  - Up to 2^32 - 1 entries.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cider_hashtable {
+
+template <typename Key,
+          typename T,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class JoinProbeHashTable {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using entry_index = uint32_t;
+
+  // end of matches
+  static constexpr entry_index npos = std::numeric_limits<entry_index>::max();
+  static constexpr size_type group_size = 16;
+
+  explicit JoinProbeHashTable(size_type key_count = 0) {
+    rehash(slot_count_for(key_count));
+  }
+
+  // Capacity
+  bool empty() const noexcept { return values_.empty(); }
+
+  // number of entries, including duplicate keys
+  size_type size() const noexcept { return values_.size(); }
+
+  size_type key_count() const noexcept { return key_count_; }
+
+  size_type bucket_count() const noexcept { return tags_.size(); }
+
+  // Upper bound of the bytes held after reserve(count), duplicate keys share slots.
+  static size_type memory_for(size_type count) {
+    return count * (sizeof(T) + sizeof(entry_index)) +
+           slot_count_for(count) * (sizeof(uint8_t) + sizeof(Key) + sizeof(entry_index));
+  }
+
+  void reserve(size_type count) {
+    values_.reserve(count);
+    next_.reserve(count);
+    if (count > max_key_count()) {
+      rehash(slot_count_for(count));
+    }
+  }
+
+  // Modifiers
+  void insert(const Key& key, const T& value) {
+    if (key_count_ + 1 > max_key_count()) {
+      rehash(tags_.size() * 2);
+    }
+    size_t hash = hasher()(key);
+    entry_index entry = values_.size();
+    values_.push_back(value);
+
+    size_type slot = find_slot(key, hash);
+    if (slot != kNoSlot) {
+      // chained in front of other duplicates
+      next_.push_back(heads_[slot]);
+      heads_[slot] = entry;
+      return;
+    }
+    next_.push_back(npos);
+    place(key, hash, entry);
+    ++key_count_;
+  }
+
+  // Lookup, matches of a key are iterated by:
+  //   for (auto e = find_first(key); e != npos; e = find_next(e)) value_at(e);
+  entry_index find_first(const Key& key) const { return find_first(key, hasher()(key)); }
+
+  entry_index find_next(entry_index entry) const { return next_[entry]; }
+
+  const T& value_at(entry_index entry) const { return values_[entry]; }
+
+  // Looks up first entries of keys[0, n), slots of following keys are prefetched while
+  // probing, so that cache misses of a batch overlap.
+  void find_many(const Key* keys, size_type n, entry_index* first) const {
+    constexpr size_type kPrefetchDistance = 8;
+    size_t hashes[kPrefetchDistance];
+    for (size_type i = 0; i < n && i < kPrefetchDistance; ++i) {
+      hashes[i] = hasher()(keys[i]);
+      prefetch(hashes[i]);
+    }
+    for (size_type i = 0; i < n; ++i) {
+      size_t hash = hashes[i % kPrefetchDistance];
+      if (i + kPrefetchDistance < n) {
+        size_t ahead = hasher()(keys[i + kPrefetchDistance]);
+        hashes[i % kPrefetchDistance] = ahead;
+        prefetch(ahead);
+      }
+      first[i] = find_first(keys[i], hash);
+    }
+  }
+
+  // Hash policy
+  void rehash(size_type slot_count) {
+    std::vector<uint8_t> old_tags(std::move(tags_));
+    std::vector<Key> old_keys(std::move(keys_));
+    std::vector<entry_index> old_heads(std::move(heads_));
+    tags_.assign(slot_count, kEmptyTag);
+    keys_.assign(slot_count, Key());
+    heads_.assign(slot_count, npos);
+    group_mask_ = slot_count / group_size - 1;
+    for (size_type i = 0; i < old_tags.size(); ++i) {
+      if (old_tags[i] != kEmptyTag) {
+        place(old_keys[i], hasher()(old_keys[i]), old_heads[i]);
+      }
+    }
+  }
+
+ private:
+  static constexpr uint8_t kEmptyTag = 0;
+  static constexpr size_type kNoSlot = std::numeric_limits<size_type>::max();
+
+  // Tag bits are taken from the middle of hash, as high bits may be used to partition
+  // tables and low bits select the group.
+  static uint8_t tag_of(size_t hash) { return 0x80 | ((hash >> 32) & 0x7F); }
+
+  size_type group_of(size_t hash) const { return hash & group_mask_; }
+
+  size_type max_key_count() const { return tags_.size() / 8 * 7; }
+
+  static size_type slot_count_for(size_type key_count) {
+    size_type slot_count = group_size;
+    while (slot_count / 8 * 7 < key_count) {
+      slot_count <<= 1;
+    }
+    return slot_count;
+  }
+
+  // bit i is set if tag of slot (group * group_size + i) equals to tag
+  uint32_t match_group(size_type group, uint8_t tag) const {
+    const uint8_t* tags = tags_.data() + group * group_size;
+#if defined(__SSE2__)
+    auto group_tags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group_tags, _mm_set1_epi8(tag)));
+#else
+    uint32_t mask = 0;
+    for (size_type i = 0; i < group_size; ++i) {
+      mask |= static_cast<uint32_t>(tags[i] == tag) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Returns slot holding key, or kNoSlot. Keys are placed to the first group with an
+  // empty slot along the probe sequence, so the search stops at such a group.
+  size_type find_slot(const Key& key, size_t hash) const {
+    uint8_t tag = tag_of(hash);
+    for (size_type group = group_of(hash);; group = (group + 1) & group_mask_) {
+      for (uint32_t mask = match_group(group, tag); mask; mask &= mask - 1) {
+        size_type slot = group * group_size + __builtin_ctz(mask);
+        if (key_equal()(keys_[slot], key)) {
+          return slot;
+        }
+      }
+      if (match_group(group, kEmptyTag)) {
+        return kNoSlot;
+      }
+    }
+  }
+
+  entry_index find_first(const Key& key, size_t hash) const {
+    size_type slot = find_slot(key, hash);
+    return slot == kNoSlot ? npos : heads_[slot];
+  }
+
+  void place(const Key& key, size_t hash, entry_index head) {
+    for (size_type group = group_of(hash);; group = (group + 1) & group_mask_) {
+      uint32_t empty = match_group(group, kEmptyTag);
+      if (empty) {
+        size_type slot = group * group_size + __builtin_ctz(empty);
+        tags_[slot] = tag_of(hash);
+        keys_[slot] = key;
+        heads_[slot] = head;
+        return;
+      }
+    }
+  }
+
+  void prefetch(size_t hash) const {
+    size_type slot = group_of(hash) * group_size;
+    __builtin_prefetch(tags_.data() + slot);
+    __builtin_prefetch(keys_.data() + slot);
+  }
+
+  // slots
+  std::vector<uint8_t> tags_;
+  std::vector<Key> keys_;
+  std::vector<entry_index> heads_;
+  size_type group_mask_{0};
+  size_type key_count_{0};
+
+  // entries, next_ chains entries of the same key
+  std::vector<T> values_;
+  std::vector<entry_index> next_;
+};
+
+}  // namespace cider_hashtable
@@ -202,6 +202,30 @@ class LinearProbeHashTable {
   // find
   folly::fbvector<mapped_type> find(const Key& key) { return find_impl(key); }
 
+  // Allocation free lookup, used by generated code to iterate all values of a key:
+  //   for (idx = find_from(key, probe_begin(key)); idx != bucket_count();
+  //        idx = find_from(key, probe_next(idx)))
+  // Entries of a key never cross an empty bucket, as there is no erase.
+  size_type probe_begin(const Key& key) const { return key_to_idx(key); }
+
+  size_type find_from(const Key& key, size_type idx) const {
+    for (;; idx = probe_next(idx)) {
+      if (!buckets_[idx].first.is_not_null) {
+        return buckets_.size();
+      }
+      if (key_equal()(buckets_[idx].first.key, key)) {
+        return idx;
+      }
+    }
+  }
+
+  size_t probe_next(size_t idx) const noexcept {
+    const size_t mask = buckets_.size() - 1;
+    return (idx + 1) & mask;
+  }
+
+  const mapped_type& value_at(size_type idx) const { return buckets_[idx].second; }
+
   // Bucket interface
   size_type bucket_count() const noexcept { return buckets_.size(); }
 
@@ -271,11 +295,6 @@ class LinearProbeHashTable {
     return hasher()(key) & mask;
   }
 
-  size_t probe_next(size_t idx) const noexcept {
-    const size_t mask = buckets_.size() - 1;
-    return (idx + 1) & mask;
-  }
-
  private:
   key_type empty_key_;
   buckets buckets_;
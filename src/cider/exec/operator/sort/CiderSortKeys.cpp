@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/operator/sort/CiderSortKeys.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "cider/CiderException.h"
+#include "exec/operator/sort/CiderSortKeysInl.h"
+
+namespace cider::exec::sort {
+
+size_t getValueWidth(SQLTypes type) {
+  switch (type) {
+    case kBOOLEAN:
+    case kVARCHAR:
+    case kCHAR:
+    case kTEXT:
+      return 0;
+    case kTINYINT:
+      return 1;
+    case kSMALLINT:
+      return 2;
+    case kINT:
+    case kFLOAT:
+    case kDATE:
+      return 4;
+    case kBIGINT:
+    case kDOUBLE:
+    case kTIME:
+    case kTIMESTAMP:
+      return 8;
+    default:
+      CIDER_THROW(CiderUnsupportedException,
+                  "Unsupported type in sort: " + SQLTypeInfo(type).get_type_name());
+  }
+}
+
+void SortKeyLayout::addKey(size_t column, SQLTypes type, bool is_desc, bool nulls_first) {
+  size_t width = getValueWidth(type);
+  bool is_string = kBOOLEAN != type && 0 == width;
+  if (kBOOLEAN == type) {
+    width = 1;
+  } else if (is_string) {
+    width = kStringKeyPrefixBytes;
+  }
+  keys_.push_back({column, type, is_desc, nulls_first, bytes_, width});
+  bytes_ += 1 + width;
+  if (is_string) {
+    bytes_ = getKeyBytes();
+    if (0 == compare_words_) {
+      compare_words_ = getKeyWords();
+    }
+  }
+}
+
+void SortKeyLayout::encode(const ArrowArray* batch, int64_t row, int64_t* key) const {
+  auto bytes = reinterpret_cast<uint8_t*>(key);
+  memset(bytes, 0, getKeyBytes());
+  for (const auto& sort_key : keys_) {
+    const ArrowArray* column = batch->children[sort_key.column];
+    uint8_t* dst = bytes + sort_key.offset;
+    auto encode = [&](auto encode_value) {
+      encodeSortKey(column,
+                    row,
+                    sort_key.width,
+                    sort_key.is_desc,
+                    sort_key.nulls_first,
+                    dst,
+                    encode_value);
+    };
+    switch (sort_key.type) {
+      case kBOOLEAN:
+        encode(encodeBooleanSortKey);
+        break;
+      case kTINYINT:
+        encode(encodeIntegerSortKey<int8_t, uint8_t>);
+        break;
+      case kSMALLINT:
+        encode(encodeIntegerSortKey<int16_t, uint16_t>);
+        break;
+      case kINT:
+      case kDATE:
+        encode(encodeIntegerSortKey<int32_t, uint32_t>);
+        break;
+      case kBIGINT:
+      case kTIME:
+      case kTIMESTAMP:
+        encode(encodeIntegerSortKey<int64_t, uint64_t>);
+        break;
+      case kFLOAT:
+        encode(encodeFloatingPointSortKey<float, uint32_t>);
+        break;
+      case kDOUBLE:
+        encode(encodeFloatingPointSortKey<double, uint64_t>);
+        break;
+      default:
+        encode(encodeStringSortKey);
+    }
+  }
+  finishSortKey(key, getKeyWords());
+}
+
+int32_t compareSortKeys(const int64_t* lhs, const int64_t* rhs, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    if (lhs[i] != rhs[i]) {
+      return lhs[i] < rhs[i] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace cider::exec::sort
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_CIDERSORTKEYS_H
+#define CIDER_CIDERSORTKEYS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "exec/module/batch/ArrowABI.h"
+#include "type/data/sqltypes.h"
+
+namespace cider::exec::sort {
+
+// Bytes of a string kept in its normalized key, strings with equal prefixes are ordered
+// by comparing the full values.
+constexpr size_t kStringKeyPrefixBytes = 8;
+
+// Width of fixed-width values of type in Arrow, 0 for booleans and strings.
+size_t getValueWidth(SQLTypes type);
+
+struct SortKey {
+  size_t column;  // output column of the key
+  SQLTypes type;
+  bool is_desc;
+  bool nulls_first;
+  size_t offset;  // byte of the null flag in normalized key, value bytes follow it
+  size_t width;   // value bytes, the prefix length for strings
+};
+
+// Layout of normalized sort keys. The keys of a row are encoded into bytes ordered as
+// unsigned bytes, so rows compare as their keys do with memcmp. The bytes are stored in
+// native int64 words, 8 bytes per word with the first one most significant and the sign
+// bit flipped, so that a key is also ordered by signed comparison of its words.
+// String keys only keep a prefix and end at a word boundary. Words following a string
+// key decide the order only if the full strings are equal, so just the words up to the
+// first string key are compared as a whole.
+class SortKeyLayout {
+ public:
+  // Keys are compared in the order they are added.
+  void addKey(size_t column, SQLTypes type, bool is_desc, bool nulls_first);
+
+  const std::vector<SortKey>& getKeys() const { return keys_; }
+
+  size_t getKeyWords() const { return (bytes_ + sizeof(int64_t) - 1) / sizeof(int64_t); }
+
+  size_t getKeyBytes() const { return getKeyWords() * sizeof(int64_t); }
+
+  bool hasStringKey() const { return compare_words_ > 0; }
+
+  // Words ordering rows without looking at full strings, up to the end of the first
+  // string key.
+  size_t getCompareWords() const {
+    return hasStringKey() ? compare_words_ : getKeyWords();
+  }
+
+  // Encodes the keys of row in batch, a struct array of output columns. Queries use the
+  // encoder generated for their layout instead.
+  void encode(const ArrowArray* batch, int64_t row, int64_t* key) const;
+
+  // Byte i of the unsigned byte string encoded in key.
+  static uint8_t getByte(const int64_t* key, size_t i) {
+    uint64_t word = static_cast<uint64_t>(key[i / 8]) ^ (uint64_t(1) << 63);
+    return word >> (56 - 8 * (i % 8));
+  }
+
+ private:
+  std::vector<SortKey> keys_;
+  size_t bytes_{0};
+  size_t compare_words_{0};
+};
+
+// Compares normalized keys of words, returns -1, 0 or 1. Queries use the comparator
+// generated for their key width instead.
+int32_t compareSortKeys(const int64_t* lhs, const int64_t* rhs, size_t words);
+
+}  // namespace cider::exec::sort
+
+#endif  // CIDER_CIDERSORTKEYS_H
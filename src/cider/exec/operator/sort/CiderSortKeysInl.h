@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_CIDERSORTKEYSINL_H
+#define CIDER_CIDERSORTKEYSINL_H
+
+#include <algorithm>
+#include <cstring>
+
+#include "exec/module/batch/ArrowABI.h"
+#include "exec/operator/sort/CiderSortKeys.h"
+#include "util/CiderBitUtils.h"
+
+// Encoders of normalized sort keys, shared by SortKeyLayout::encode() and the runtime
+// functions called by generated encoders. See SortKeyLayout for the layout.
+namespace cider::exec::sort {
+
+template <typename T>
+inline void storeBigEndian(T value, uint8_t* dst) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    dst[i] = static_cast<uint8_t>(value >> (8 * (sizeof(T) - 1 - i)));
+  }
+}
+
+// Flipping the sign bit orders signed integers as unsigned ones.
+template <typename T, typename U>
+inline void encodeIntegerSortKey(const ArrowArray* column, int64_t index, uint8_t* dst) {
+  U bits = static_cast<U>(reinterpret_cast<const T*>(column->buffers[1])[index]);
+  storeBigEndian<U>(bits ^ (U(1) << (8 * sizeof(U) - 1)), dst);
+}
+
+// Negative floating point values have all bits flipped and positive ones the sign bit,
+// both zeros are encoded as positive zero.
+template <typename T, typename U>
+inline void encodeFloatingPointSortKey(const ArrowArray* column,
+                                       int64_t index,
+                                       uint8_t* dst) {
+  T value = reinterpret_cast<const T*>(column->buffers[1])[index];
+  U bits = 0;
+  if (value != 0) {
+    memcpy(&bits, &value, sizeof(T));
+  }
+  constexpr U sign = U(1) << (8 * sizeof(U) - 1);
+  storeBigEndian<U>((bits & sign) ? ~bits : (bits | sign), dst);
+}
+
+inline void encodeBooleanSortKey(const ArrowArray* column, int64_t index, uint8_t* dst) {
+  dst[0] = CiderBitUtils::isBitSetAt(
+      reinterpret_cast<const uint8_t*>(column->buffers[1]), index);
+}
+
+// Bytes following shorter strings are left zero.
+inline void encodeStringSortKey(const ArrowArray* column, int64_t index, uint8_t* dst) {
+  auto offsets = reinterpret_cast<const int32_t*>(column->buffers[1]);
+  auto data = reinterpret_cast<const uint8_t*>(column->buffers[2]);
+  size_t length = offsets[index + 1] - offsets[index];
+  memcpy(dst, data + offsets[index], std::min(length, kStringKeyPrefixBytes));
+}
+
+// Encodes the key of row of column at dst, the null flag followed by width value bytes
+// written by encode_value. Key bytes must be cleared before, value bytes of nulls are
+// left zero so that nulls only differ in the flag.
+template <typename EncodeValue>
+inline void encodeSortKey(const ArrowArray* column,
+                          int64_t row,
+                          size_t width,
+                          bool is_desc,
+                          bool nulls_first,
+                          uint8_t* dst,
+                          EncodeValue encode_value) {
+  const int64_t index = row + column->offset;
+  bool is_null =
+      column->buffers[0] &&
+      !CiderBitUtils::isBitSetAt(reinterpret_cast<const uint8_t*>(column->buffers[0]),
+                                 index);
+  dst[0] = is_null == nulls_first ? 0 : 1;
+  if (is_null) {
+    return;
+  }
+  encode_value(column, index, dst + 1);
+  if (is_desc) {
+    for (size_t i = 1; i <= width; ++i) {
+      dst[i] = ~dst[i];
+    }
+  }
+}
+
+// Converts encoded bytes of key into words ordered by signed comparison.
+inline void finishSortKey(int64_t* key, size_t words) {
+  for (size_t i = 0; i < words; ++i) {
+    key[i] = static_cast<int64_t>(__builtin_bswap64(static_cast<uint64_t>(key[i])) ^
+                                  (uint64_t(1) << 63));
+  }
+}
+
+}  // namespace cider::exec::sort
+
+#endif  // CIDER_CIDERSORTKEYSINL_H
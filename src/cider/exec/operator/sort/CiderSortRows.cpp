@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/operator/sort/CiderSortRows.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "exec/module/batch/CiderArrowBufferHolder.h"
+#include "util/CiderBitUtils.h"
+
+namespace cider::exec::sort {
+
+namespace {
+
+bool isString(SQLTypes type) {
+  return kVARCHAR == type || kCHAR == type || kTEXT == type;
+}
+
+bool isNullAt(const ArrowArray* column, int64_t index) {
+  return column->buffers[0] &&
+         !CiderBitUtils::isBitSetAt(reinterpret_cast<const uint8_t*>(column->buffers[0]),
+                                    index);
+}
+
+int32_t getStringLength(const ArrowArray* column, int64_t index) {
+  auto offsets = reinterpret_cast<const int32_t*>(column->buffers[1]);
+  return offsets[index + 1] - offsets[index];
+}
+
+}  // namespace
+
+SortRowFormat::SortRowFormat(const SortKeyLayout& layout, const SQLTypeInfo& output_type)
+    : layout_(layout), key_words_(layout.getKeyWords()) {
+  for (size_t i = 0; i < output_type.getChildrenNum(); ++i) {
+    SQLTypes type = output_type.getChildAt(i).get_type();
+    types_.push_back(type);
+    widths_.push_back(kBOOLEAN == type ? 1 : getValueWidth(type));
+  }
+}
+
+size_t SortRowFormat::getRowWords(const ArrowArray* batch, int64_t row) const {
+  size_t bytes = (key_words_ + 1) * sizeof(int64_t) + types_.size();
+  for (size_t i = 0; i < types_.size(); ++i) {
+    const ArrowArray* column = batch->children[i];
+    const int64_t index = row + column->offset;
+    if (isNullAt(column, index)) {
+      continue;
+    }
+    bytes += isString(types_[i]) ? sizeof(int32_t) + getStringLength(column, index)
+                                 : widths_[i];
+  }
+  return (bytes + sizeof(int64_t) - 1) / sizeof(int64_t);
+}
+
+void SortRowFormat::serialize(const ArrowArray* batch,
+                              int64_t row,
+                              const int64_t* key,
+                              int64_t* dst) const {
+  const size_t words = getRowWords(batch, row);
+  memcpy(dst, key, key_words_ * sizeof(int64_t));
+  dst[key_words_] = words;
+  auto pos = reinterpret_cast<uint8_t*>(dst + key_words_ + 1);
+  for (size_t i = 0; i < types_.size(); ++i) {
+    const ArrowArray* column = batch->children[i];
+    const int64_t index = row + column->offset;
+    bool is_null = isNullAt(column, index);
+    *pos++ = is_null;
+    if (is_null) {
+      continue;
+    }
+    if (kBOOLEAN == types_[i]) {
+      *pos++ = CiderBitUtils::isBitSetAt(
+          reinterpret_cast<const uint8_t*>(column->buffers[1]), index);
+    } else if (isString(types_[i])) {
+      int32_t length = getStringLength(column, index);
+      auto offsets = reinterpret_cast<const int32_t*>(column->buffers[1]);
+      auto data = reinterpret_cast<const uint8_t*>(column->buffers[2]);
+      memcpy(pos, &length, sizeof(int32_t));
+      memcpy(pos + sizeof(int32_t), data + offsets[index], length);
+      pos += sizeof(int32_t) + length;
+    } else {
+      auto values = reinterpret_cast<const uint8_t*>(column->buffers[1]);
+      memcpy(pos, values + index * widths_[i], widths_[i]);
+      pos += widths_[i];
+    }
+  }
+  memset(pos, 0, reinterpret_cast<uint8_t*>(dst + words) - pos);
+}
+
+size_t SortRowFormat::getValueBytes(const uint8_t* value, size_t column) const {
+  if (isString(types_[column])) {
+    int32_t length;
+    memcpy(&length, value, sizeof(int32_t));
+    return sizeof(int32_t) + length;
+  }
+  return widths_[column];
+}
+
+const uint8_t* SortRowFormat::getValue(const int64_t* row, size_t column) const {
+  auto pos = getValues(row);
+  for (size_t i = 0; i < column; ++i) {
+    pos += *pos ? 1 : 1 + getValueBytes(pos + 1, i);
+  }
+  return *pos ? nullptr : pos + 1;
+}
+
+int32_t SortRowFormat::compareRemainingKeys(const int64_t* lhs,
+                                            const int64_t* rhs) const {
+  size_t word = layout_.getCompareWords();
+  for (const auto& key : layout_.getKeys()) {
+    if (!isString(key.type)) {
+      continue;
+    }
+    // Words up to the end of the string prefix, which is word aligned.
+    size_t end = (key.offset + key.width + sizeof(int64_t)) / sizeof(int64_t);
+    if (int32_t result = compareSortKeys(lhs + word, rhs + word, end - word)) {
+      return result;
+    }
+    word = end;
+    // Null flags are equal, so either both values are null or neither is.
+    auto lhs_value = getValue(lhs, key.column);
+    auto rhs_value = getValue(rhs, key.column);
+    if (!lhs_value || !rhs_value) {
+      continue;
+    }
+    int32_t lhs_length, rhs_length;
+    memcpy(&lhs_length, lhs_value, sizeof(int32_t));
+    memcpy(&rhs_length, rhs_value, sizeof(int32_t));
+    int result = memcmp(lhs_value + sizeof(int32_t),
+                        rhs_value + sizeof(int32_t),
+                        std::min(lhs_length, rhs_length));
+    if (0 == result) {
+      result = (lhs_length > rhs_length) - (lhs_length < rhs_length);
+    }
+    if (result) {
+      return (result < 0) == key.is_desc ? 1 : -1;
+    }
+  }
+  return compareSortKeys(lhs + word, rhs + word, key_words_ - word);
+}
+
+SortBatchBuilder::SortBatchBuilder(const SortRowFormat& format)
+    : format_(format), columns_(format.getColumnNum()) {
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (isString(format_.getColumnType(i))) {
+      columns_[i].offsets.push_back(0);
+    }
+  }
+}
+
+void SortBatchBuilder::append(const int64_t* row) {
+  auto pos = format_.getValues(row);
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    auto& column = columns_[i];
+    SQLTypes type = format_.getColumnType(i);
+    const uint8_t* value = *pos ? nullptr : pos + 1;
+    pos += value ? 1 + format_.getValueBytes(value, i) : 1;
+    column.nulls.push_back(nullptr == value);
+    if (isString(type)) {
+      int32_t length = 0;
+      if (value) {
+        memcpy(&length, value, sizeof(int32_t));
+        value += sizeof(int32_t);
+        column.values.insert(column.values.end(), value, value + length);
+      }
+      column.offsets.push_back(column.offsets.back() + length);
+      bytes_ += sizeof(int32_t) + length;
+      continue;
+    }
+    size_t width = kBOOLEAN == type ? 1 : getValueWidth(type);
+    if (value) {
+      column.values.insert(column.values.end(), value, value + width);
+    } else {
+      column.values.resize(column.values.size() + width, 0);
+    }
+    bytes_ += width;
+  }
+  ++row_num_;
+}
+
+void SortBatchBuilder::build(ArrowArray* batch) {
+  const size_t bitmap_bytes = (row_num_ + 7) / 8;
+  auto holder = reinterpret_cast<CiderArrowArrayBufferHolder*>(batch->private_data);
+  holder->allocBuffer(0, bitmap_bytes);
+  memset(holder->getBufferAs<uint8_t>(0), 0xFF, bitmap_bytes);
+  batch->length = row_num_;
+
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    auto& column = columns_[i];
+    ArrowArray* child = batch->children[i];
+    auto child_holder =
+        reinterpret_cast<CiderArrowArrayBufferHolder*>(child->private_data);
+    child_holder->allocBuffer(0, bitmap_bytes);
+    auto nulls = child_holder->getBufferAs<uint8_t>(0);
+    memset(nulls, 0, bitmap_bytes);
+    int64_t null_count = 0;
+    for (size_t row = 0; row < row_num_; ++row) {
+      if (column.nulls[row]) {
+        ++null_count;
+      } else {
+        CiderBitUtils::setBitAt(nulls, row);
+      }
+    }
+    child->null_count = null_count;
+
+    SQLTypes type = format_.getColumnType(i);
+    if (kBOOLEAN == type) {
+      child_holder->allocBuffer(1, bitmap_bytes);
+      auto values = child_holder->getBufferAs<uint8_t>(1);
+      memset(values, 0, bitmap_bytes);
+      for (size_t row = 0; row < row_num_; ++row) {
+        if (column.values[row]) {
+          CiderBitUtils::setBitAt(values, row);
+        }
+      }
+    } else if (isString(type)) {
+      child_holder->allocBuffer(1, sizeof(int32_t) * column.offsets.size());
+      memcpy(child_holder->getBufferAs<int32_t>(1),
+             column.offsets.data(),
+             sizeof(int32_t) * column.offsets.size());
+      child_holder->allocBuffer(2, column.values.size());
+      if (!column.values.empty()) {
+        memcpy(child_holder->getBufferAs<uint8_t>(2),
+               column.values.data(),
+               column.values.size());
+      }
+      column.offsets.assign(1, 0);
+    } else {
+      child_holder->allocBuffer(1, column.values.size());
+      if (!column.values.empty()) {
+        memcpy(child_holder->getBufferAs<uint8_t>(1),
+               column.values.data(),
+               column.values.size());
+      }
+    }
+    child->length = row_num_;
+    column.nulls.clear();
+    column.values.clear();
+  }
+  row_num_ = 0;
+  bytes_ = 0;
+}
+
+}  // namespace cider::exec::sort
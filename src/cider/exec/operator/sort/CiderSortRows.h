@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_CIDERSORTROWS_H
+#define CIDER_CIDERSORTROWS_H
+
+#include <vector>
+
+#include "exec/operator/sort/CiderSortKeys.h"
+
+namespace cider::exec::sort {
+
+// Rows buffered by sort are serialized into words as
+//   normalized key | row words | values of output columns
+// where every value is a null flag byte followed by the value: a byte for booleans, an
+// int32 length and the bytes for strings, the fixed-width value otherwise. Rows are
+// padded to whole words so that keys stay aligned.
+class SortRowFormat {
+ public:
+  SortRowFormat(const SortKeyLayout& layout, const SQLTypeInfo& output_type);
+
+  const SortKeyLayout& getLayout() const { return layout_; }
+
+  size_t getColumnNum() const { return types_.size(); }
+
+  SQLTypes getColumnType(size_t column) const { return types_[column]; }
+
+  // Words taken by row in batch once serialized.
+  size_t getRowWords(const ArrowArray* batch, int64_t row) const;
+
+  size_t getRowWords(const int64_t* row) const { return row[key_words_]; }
+
+  // Serializes row in batch with its encoded key into dst of getRowWords() words.
+  void serialize(const ArrowArray* batch,
+                 int64_t row,
+                 const int64_t* key,
+                 int64_t* dst) const;
+
+  // Values of a serialized row, each one is a null flag byte followed by the value.
+  const uint8_t* getValues(const int64_t* row) const {
+    return reinterpret_cast<const uint8_t*>(row + key_words_ + 1);
+  }
+
+  // Bytes of a non-null value following its null flag.
+  size_t getValueBytes(const uint8_t* value, size_t column) const;
+
+  // Value of column in a serialized row, null if the value is null.
+  const uint8_t* getValue(const int64_t* row, size_t column) const;
+
+  // Compares rows whose compare words are equal by the keys following them, with string
+  // keys compared in full.
+  int32_t compareRemainingKeys(const int64_t* lhs, const int64_t* rhs) const;
+
+ private:
+  SortKeyLayout layout_;
+  size_t key_words_;
+  std::vector<SQLTypes> types_;
+  std::vector<size_t> widths_;
+};
+
+// Collects serialized rows into output columns.
+class SortBatchBuilder {
+ public:
+  explicit SortBatchBuilder(const SortRowFormat& format);
+
+  void append(const int64_t* row);
+
+  size_t getRowNum() const { return row_num_; }
+
+  size_t getBytes() const { return bytes_; }
+
+  // Fills the columns of batch, a struct array of output columns, with the collected
+  // rows and clears the builder.
+  void build(ArrowArray* batch);
+
+ private:
+  struct ColumnBuffer {
+    std::vector<uint8_t> nulls;
+    std::vector<uint8_t> values;
+    std::vector<int32_t> offsets;
+  };
+
+  const SortRowFormat& format_;
+  std::vector<ColumnBuffer> columns_;
+  size_t row_num_{0};
+  size_t bytes_{0};
+};
+
+}  // namespace cider::exec::sort
+
+#endif  // CIDER_CIDERSORTROWS_H
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/operator/sort/CiderSorter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cider/CiderException.h"
+#include "exec/operator/aggregate/CiderAggSpillBufferMgr.h"
+
+namespace cider::exec::sort {
+
+namespace {
+
+// Ranges of at most this many rows are sorted by comparison instead of radix sort.
+constexpr size_t kRadixSortCutoff = 64;
+
+// Larger limits are served by a full sort, the top rows heap would hold most rows.
+constexpr size_t kTopNMaxRows = 1 << 20;
+
+}  // namespace
+
+// Reads rows of a sorted run in order.
+class SortRunCursor {
+ public:
+  virtual ~SortRunCursor() = default;
+
+  virtual const int64_t* row() const = 0;
+
+  // Moves to the next row, returns false if there's no more rows.
+  virtual bool next() = 0;
+};
+
+namespace {
+
+class MemoryRunCursor : public SortRunCursor {
+ public:
+  MemoryRunCursor(const std::vector<int64_t>& rows, const std::vector<size_t>& offsets)
+      : rows_(rows), offsets_(offsets) {}
+
+  const int64_t* row() const override { return rows_.data() + offsets_[index_]; }
+
+  bool next() override { return ++index_ < offsets_.size(); }
+
+ private:
+  const std::vector<int64_t>& rows_;
+  const std::vector<size_t>& offsets_;
+  size_t index_{0};
+};
+
+// Rows of a spilled run are stored one after another from its first partition, each
+// prefixed by its words. A zero word marks the end of rows in a partition.
+class SpillRunCursor : public SortRunCursor {
+ public:
+  SpillRunCursor(const std::shared_ptr<CiderAggSpillFile>& file,
+                 size_t partition,
+                 size_t row_num)
+      : reader_(CiderAggSpillBufferMgr::RMODE, true, file, partition)
+      , partition_words_(reader_.getPartitionSize() / sizeof(int64_t))
+      , rows_left_(row_num)
+      , buffer_(reinterpret_cast<const int64_t*>(reader_.getBuffer())) {}
+
+  const int64_t* row() const override { return buffer_ + position_ + 1; }
+
+  bool next() override {
+    if (0 == --rows_left_) {
+      return false;
+    }
+    position_ += buffer_[position_] + 1;
+    if (position_ == partition_words_ || 0 == buffer_[position_]) {
+      buffer_ = reinterpret_cast<const int64_t*>(reader_.toNextPartition());
+      position_ = 0;
+    }
+    return true;
+  }
+
+ private:
+  CiderAggSpillBufferMgr reader_;
+  const size_t partition_words_;
+  size_t position_{0};
+  size_t rows_left_;
+  const int64_t* buffer_;
+};
+
+}  // namespace
+
+CiderSorter::CiderSorter(const SortKeyLayout& layout,
+                         KeyEncodeFunc encode,
+                         KeyCompareFunc compare,
+                         std::optional<size_t> limit,
+                         size_t offset,
+                         const SQLTypeInfo& output_type,
+                         const CiderAllocatorPtr& allocator)
+    : format_(layout, output_type)
+    , compare_words_(layout.getCompareWords())
+    , encode_(encode)
+    , compare_(compare)
+    , limit_(limit)
+    , offset_(offset)
+    , top_n_(limit && *limit + offset <= kTopNMaxRows)
+    , output_type_(output_type)
+    , allocator_(allocator)
+    , key_(layout.getKeyWords())
+    , builder_(format_) {}
+
+CiderSorter::~CiderSorter() = default;
+
+int64_t* CiderSorter::appendRow(const ArrowArray* batch, int64_t row) {
+  size_t offset = rows_.size();
+  size_t words = format_.getRowWords(batch, row);
+  rows_.resize(offset + words);
+  format_.serialize(batch, row, key_.data(), rows_.data() + offset);
+  return rows_.data() + offset;
+}
+
+void CiderSorter::append(const ArrowArray* batch) {
+  if (sorted_) {
+    CIDER_THROW(CiderRuntimeException, "Rows can't be appended after sorted.");
+  }
+  if (limit_ && 0 == *limit_) {
+    // LIMIT 0 returns no rows.
+    return;
+  }
+  if (top_n_) {
+    appendTopN(batch);
+    return;
+  }
+  for (int64_t row = 0; row < batch->length; ++row) {
+    encodeKey(batch, row);
+    row_offsets_.push_back(appendRow(batch, row) - rows_.data());
+  }
+  if (spill_threshold_ && rows_.size() * sizeof(int64_t) >= spill_threshold_) {
+    spillRun();
+  }
+}
+
+void CiderSorter::appendTopN(const ArrowArray* batch) {
+  const size_t capacity = *limit_ + offset_;
+  auto less = [this](size_t lhs, size_t rhs) {
+    return compareRows(rows_.data() + lhs, rows_.data() + rhs) < 0;
+  };
+  for (int64_t row = 0; row < batch->length; ++row) {
+    encodeKey(batch, row);
+    if (row_offsets_.size() < capacity) {
+      int64_t* new_row = appendRow(batch, row);
+      live_row_words_ += format_.getRowWords(new_row);
+      row_offsets_.push_back(new_row - rows_.data());
+      std::push_heap(row_offsets_.begin(), row_offsets_.end(), less);
+      continue;
+    }
+    // Most rows are rejected by comparing keys with the largest of the top rows, before
+    // they are serialized. Rows equal to it are kept out too, unless string keys have
+    // to be compared in full.
+    int32_t result = compareKeys(key_.data(), rows_.data() + row_offsets_.front());
+    if (result > 0 || (0 == result && !format_.getLayout().hasStringKey())) {
+      continue;
+    }
+    int64_t* new_row = appendRow(batch, row);
+    const size_t new_offset = new_row - rows_.data();
+    if (compareRows(new_row, rows_.data() + row_offsets_.front()) >= 0) {
+      rows_.resize(new_offset);
+      continue;
+    }
+    std::pop_heap(row_offsets_.begin(), row_offsets_.end(), less);
+    live_row_words_ += format_.getRowWords(new_row);
+    live_row_words_ -= format_.getRowWords(rows_.data() + row_offsets_.back());
+    row_offsets_.back() = new_offset;
+    std::push_heap(row_offsets_.begin(), row_offsets_.end(), less);
+  }
+  if (rows_.size() > 2 * live_row_words_) {
+    compactTopN();
+  }
+}
+
+void CiderSorter::compactTopN() {
+  std::vector<int64_t> rows;
+  rows.reserve(live_row_words_);
+  for (auto& offset : row_offsets_) {
+    const int64_t* row = rows_.data() + offset;
+    offset = rows.size();
+    rows.insert(rows.end(), row, row + format_.getRowWords(row));
+  }
+  rows_.swap(rows);
+}
+
+void CiderSorter::radixSort(size_t begin, size_t end, size_t byte) {
+  auto less = [this](size_t lhs, size_t rhs) {
+    return compareRows(rows_.data() + lhs, rows_.data() + rhs) < 0;
+  };
+  const size_t key_bytes = compare_words_ * sizeof(int64_t);
+  size_t counts[256];
+  while (true) {
+    if (end - begin <= kRadixSortCutoff) {
+      std::sort(row_offsets_.begin() + begin, row_offsets_.begin() + end, less);
+      return;
+    }
+    if (byte == key_bytes) {
+      // Compare words are all equal, remaining keys may still differ.
+      if (format_.getLayout().hasStringKey()) {
+        std::sort(row_offsets_.begin() + begin, row_offsets_.begin() + end, less);
+      }
+      return;
+    }
+    std::fill(std::begin(counts), std::end(counts), 0);
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[SortKeyLayout::getByte(rows_.data() + row_offsets_[i], byte)];
+    }
+    // Skips bytes shared by all rows without moving them.
+    if (counts[SortKeyLayout::getByte(rows_.data() + row_offsets_[begin], byte)] ==
+        end - begin) {
+      ++byte;
+      continue;
+    }
+    break;
+  }
+
+  size_t positions[256];
+  size_t position = begin;
+  for (size_t i = 0; i < 256; ++i) {
+    positions[i] = position;
+    position += counts[i];
+  }
+  for (size_t i = begin; i < end; ++i) {
+    auto bucket = SortKeyLayout::getByte(rows_.data() + row_offsets_[i], byte);
+    radix_buffer_[positions[bucket]++] = row_offsets_[i];
+  }
+  std::copy(radix_buffer_.begin() + begin,
+            radix_buffer_.begin() + end,
+            row_offsets_.begin() + begin);
+
+  size_t bucket_begin = begin;
+  for (size_t i = 0; i < 256; ++i) {
+    if (counts[i] > 1) {
+      radixSort(bucket_begin, bucket_begin + counts[i], byte + 1);
+    }
+    bucket_begin += counts[i];
+  }
+}
+
+void CiderSorter::sortBufferedRows() {
+  if (top_n_) {
+    std::sort_heap(row_offsets_.begin(), row_offsets_.end(), [this](size_t l, size_t r) {
+      return compareRows(rows_.data() + l, rows_.data() + r) < 0;
+    });
+    return;
+  }
+  radix_buffer_.resize(row_offsets_.size());
+  radixSort(0, row_offsets_.size(), 0);
+  radix_buffer_.clear();
+}
+
+void CiderSorter::spillRun() {
+  sortBufferedRows();
+  if (!spill_writer_) {
+    spill_writer_ =
+        std::make_unique<CiderAggSpillBufferMgr>(CiderAggSpillBufferMgr::WMODE, true);
+    spill_partition_ = 0;
+  } else {
+    spill_writer_->toNextPartition();
+    ++spill_partition_;
+  }
+  spill_position_ = 0;
+  runs_.push_back({spill_partition_, row_offsets_.size()});
+
+  const size_t partition_words = spill_writer_->getPartitionSize() / sizeof(int64_t);
+  for (auto offset : row_offsets_) {
+    const int64_t* row = rows_.data() + offset;
+    const size_t words = format_.getRowWords(row);
+    if (words + 1 > partition_words) {
+      CIDER_THROW(CiderRuntimeException, "Sort row is too large to spill.");
+    }
+    auto buffer = reinterpret_cast<int64_t*>(spill_writer_->getBuffer());
+    if (spill_position_ + words + 1 > partition_words) {
+      if (spill_position_ < partition_words) {
+        buffer[spill_position_] = 0;
+      }
+      buffer = reinterpret_cast<int64_t*>(spill_writer_->toNextPartition());
+      ++spill_partition_;
+      spill_position_ = 0;
+    }
+    buffer[spill_position_] = words;
+    memcpy(buffer + spill_position_ + 1, row, words * sizeof(int64_t));
+    spill_position_ += words + 1;
+  }
+  spill_writer_->syncBuffer();
+
+  rows_.clear();
+  row_offsets_.clear();
+}
+
+void CiderSorter::sort() {
+  if (sorted_) {
+    return;
+  }
+  sorted_ = true;
+  sortBufferedRows();
+  if (!row_offsets_.empty()) {
+    cursors_.push_back(std::make_unique<MemoryRunCursor>(rows_, row_offsets_));
+  }
+  for (const auto& run : runs_) {
+    cursors_.push_back(std::make_unique<SpillRunCursor>(
+        spill_writer_->getSpillFile(), run.partition, run.row_num));
+  }
+  for (size_t i = 0; i < cursors_.size(); ++i) {
+    merge_heap_.push_back(i);
+  }
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(), [this](size_t l, size_t r) {
+    return compareRows(cursors_[l]->row(), cursors_[r]->row()) > 0;
+  });
+}
+
+bool CiderSorter::hasMoreOutput() const {
+  return !sorted_ || (!merge_heap_.empty() && (!limit_ || output_rows_ < *limit_));
+}
+
+nextgen::context::Batch* CiderSorter::getOutputBatch(size_t max_rows, size_t max_bytes) {
+  sort();
+  auto greater = [this](size_t l, size_t r) {
+    return compareRows(cursors_[l]->row(), cursors_[r]->row()) > 0;
+  };
+  while (!merge_heap_.empty() && (!limit_ || output_rows_ < *limit_)) {
+    if ((max_rows && builder_.getRowNum() == max_rows) ||
+        (max_bytes && builder_.getBytes() >= max_bytes)) {
+      break;
+    }
+    std::pop_heap(merge_heap_.begin(), merge_heap_.end(), greater);
+    auto& cursor = cursors_[merge_heap_.back()];
+    if (skipped_rows_ < offset_) {
+      ++skipped_rows_;
+    } else {
+      builder_.append(cursor->row());
+      ++output_rows_;
+    }
+    if (cursor->next()) {
+      std::push_heap(merge_heap_.begin(), merge_heap_.end(), greater);
+    } else {
+      merge_heap_.pop_back();
+    }
+  }
+
+  // Previous output is released if it's not moved out, buffers are not reused.
+  if (!output_batch_) {
+    output_batch_ = std::make_unique<nextgen::context::Batch>(output_type_, allocator_);
+  } else {
+    output_batch_->reset(output_type_, allocator_);
+  }
+  builder_.build(output_batch_->getArray());
+  return output_batch_.get();
+}
+
+}  // namespace cider::exec::sort
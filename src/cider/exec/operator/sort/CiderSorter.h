@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_CIDERSORTER_H
+#define CIDER_CIDERSORTER_H
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "exec/nextgen/context/Batch.h"
+#include "exec/operator/sort/CiderSortRows.h"
+
+class CiderAggSpillBufferMgr;
+
+namespace cider::exec::sort {
+
+class SortRunCursor;
+
+// Sorts output rows by normalized keys. Rows are serialized as they are appended, with
+// their keys encoded once by the encoder generated for the key layout, and compared by
+// the comparator generated for its compare words.
+// A bounded ORDER BY ... LIMIT keeps the top rows in a heap checked against every input
+// row. Otherwise rows are sorted by MSD radix sort over key bytes, and once the buffered
+// rows exceed the spill threshold they are sorted and spilled to disk as a run. Sorted
+// runs are merged when results are fetched.
+class CiderSorter {
+ public:
+  using KeyEncodeFunc = void (*)(const ArrowArray*, int64_t, int64_t*);
+  using KeyCompareFunc = int32_t (*)(const int64_t*, const int64_t*);
+
+  // Returns limit rows following the first offset rows, all of them without limit. Keys
+  // are encoded by encode, or SortKeyLayout::encode() if it's null. The compare words of
+  // keys are compared by compare, or compareSortKeys() if it's null.
+  CiderSorter(const SortKeyLayout& layout,
+              KeyEncodeFunc encode,
+              KeyCompareFunc compare,
+              std::optional<size_t> limit,
+              size_t offset,
+              const SQLTypeInfo& output_type,
+              const CiderAllocatorPtr& allocator);
+
+  ~CiderSorter();
+
+  // Spills sorted runs once buffered rows take more than bytes, 0 never spills.
+  void setSpillThreshold(size_t bytes) { spill_threshold_ = bytes; }
+
+  // Buffers rows of batch, a struct array of output columns.
+  void append(const ArrowArray* batch);
+
+  // Sorts buffered rows, no more rows can be appended then.
+  void sort();
+
+  bool isSorted() const { return sorted_; }
+
+  // Returns the following sorted rows, sorts them first if not sorted yet. The batch
+  // holds at most max_rows rows of about max_bytes bytes, 0 means unbounded.
+  nextgen::context::Batch* getOutputBatch(size_t max_rows = 0, size_t max_bytes = 0);
+
+  bool hasMoreOutput() const;
+
+  size_t getSpilledRunNum() const { return runs_.size(); }
+
+ private:
+  struct SpillRun {
+    size_t partition;
+    size_t row_num;
+  };
+
+  // Encodes the key of row into key_.
+  void encodeKey(const ArrowArray* batch, int64_t row) {
+    if (encode_) {
+      encode_(batch, row, key_.data());
+    } else {
+      format_.getLayout().encode(batch, row, key_.data());
+    }
+  }
+
+  // Compares the compare words of keys.
+  int32_t compareKeys(const int64_t* lhs, const int64_t* rhs) const {
+    return compare_ ? compare_(lhs, rhs) : compareSortKeys(lhs, rhs, compare_words_);
+  }
+
+  int32_t compareRows(const int64_t* lhs, const int64_t* rhs) const {
+    int32_t result = compareKeys(lhs, rhs);
+    if (0 == result && format_.getLayout().hasStringKey()) {
+      result = format_.compareRemainingKeys(lhs, rhs);
+    }
+    return result;
+  }
+
+  int64_t* appendRow(const ArrowArray* batch, int64_t row);
+
+  void appendTopN(const ArrowArray* batch);
+
+  // Drops rows pushed out of the top rows heap.
+  void compactTopN();
+
+  void radixSort(size_t begin, size_t end, size_t byte);
+
+  void sortBufferedRows();
+
+  void spillRun();
+
+  SortRowFormat format_;
+  const size_t compare_words_;
+  KeyEncodeFunc encode_;
+  KeyCompareFunc compare_;
+  const std::optional<size_t> limit_;
+  const size_t offset_;
+  const bool top_n_;
+  const SQLTypeInfo output_type_;
+  CiderAllocatorPtr allocator_;
+
+  // Serialized rows, and the offsets of buffered rows in it. The offsets form a max-heap
+  // of the top rows for TopN.
+  std::vector<int64_t> rows_;
+  std::vector<size_t> row_offsets_;
+  std::vector<size_t> radix_buffer_;
+  std::vector<int64_t> key_;
+  size_t live_row_words_{0};
+
+  size_t spill_threshold_{0};
+  std::unique_ptr<CiderAggSpillBufferMgr> spill_writer_;
+  size_t spill_partition_{0};
+  size_t spill_position_{0};
+  std::vector<SpillRun> runs_;
+
+  bool sorted_{false};
+  std::vector<std::unique_ptr<SortRunCursor>> cursors_;
+  // Min-heap of cursors ordered by their current rows.
+  std::vector<size_t> merge_heap_;
+  size_t skipped_rows_{0};
+  size_t output_rows_{0};
+  SortBatchBuilder builder_;
+  nextgen::context::BatchPtr output_batch_;
+};
+
+using CiderSorterPtr = std::unique_ptr<CiderSorter>;
+
+}  // namespace cider::exec::sort
+
+#endif  // CIDER_CIDERSORTER_H
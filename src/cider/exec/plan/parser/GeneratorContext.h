@@ -27,6 +27,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include "ConverterHelper.h"
 #include "SubstraitToAnalyzerExpr.h"
 #include "cider/CiderException.h"
@@ -50,7 +51,8 @@ struct GeneratorContext {
   std::vector<std::shared_ptr<Analyzer::Expr>> target_exprs_;
   std::vector<std::shared_ptr<Analyzer::Expr>> groupby_exprs_;
   std::list<Analyzer::OrderEntry> orderby_collation_;
-  size_t limit_;
+  // No limit if it's not set.
+  std::optional<size_t> limit_;
   size_t offset_;
   bool has_agg_;
   JoinQualsPerNestingLevel join_quals_;
@@ -80,7 +82,11 @@ struct GeneratorContext {
     if (orderby_collation_.size() == 0) {
       return {{}, SortAlgorithm::Default, 0, 0};
     } else {
-      return {orderby_collation_, SortAlgorithm::SpeculativeTopN, limit_, offset_};
+      return {orderby_collation_,
+              SortAlgorithm::SpeculativeTopN,
+              limit_.value_or(0),
+              offset_,
+              limit_.has_value()};
     }
   }
 
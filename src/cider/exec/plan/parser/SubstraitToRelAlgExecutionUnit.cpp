@@ -48,7 +48,22 @@ RelAlgExecutionUnit SubstraitToRelAlgExecutionUnit::createRelAlgExecutionUnit()
   if (!plan_.relations(0).has_root()) {
     CIDER_THROW(CiderCompileException, "invalid plan with no root node.");
   }
-  substrait::Rel root = plan_.relations(0).root().input();
+  // Sort and limit are only supported on top of the plan, and are applied to its output.
+  const substrait::Rel* top = &plan_.relations(0).root().input();
+  const substrait::FetchRel* fetch = nullptr;
+  const substrait::SortRel* sort = nullptr;
+  if (top->has_fetch()) {
+    fetch = &top->fetch();
+    if (!fetch->input().has_sort()) {
+      CIDER_THROW(CiderCompileException, "Fetch without sort is not supported.");
+    }
+    top = &fetch->input();
+  }
+  if (top->has_sort()) {
+    sort = &top->sort();
+    top = &sort->input();
+  }
+  substrait::Rel root = *top;
   // create an empty context for future update
   std::vector<std::shared_ptr<Analyzer::Expr>> groupby_exprs;
   ctx_ = std::make_shared<GeneratorContext>(GeneratorContext{{},
@@ -58,7 +73,7 @@ RelAlgExecutionUnit SubstraitToRelAlgExecutionUnit::createRelAlgExecutionUnit()
                                                              {},
                                                              {},
                                                              {},
-                                                             0,
+                                                             std::nullopt,
                                                              0,
                                                              false,
                                                              {},
@@ -67,9 +82,49 @@ RelAlgExecutionUnit SubstraitToRelAlgExecutionUnit::createRelAlgExecutionUnit()
                                                              false,
                                                              {}});
   updateGeneratorContext(root, getFunctionMap(plan_));
+  if (sort) {
+    updateSortInfo(*sort, fetch);
+  }
   return ctx_->getExeUnitBasedOnContext();
 }
 
+void SubstraitToRelAlgExecutionUnit::updateSortInfo(const substrait::SortRel& sort,
+                                                    const substrait::FetchRel* fetch) {
+  for (const auto& sort_field : sort.sorts()) {
+    if (!sort_field.expr().has_selection() ||
+        !sort_field.expr().selection().has_direct_reference()) {
+      CIDER_THROW(CiderCompileException, "Only sort by output columns is supported.");
+    }
+    // Order entries refer to target expressions, counting from 1.
+    int tle_no =
+        sort_field.expr().selection().direct_reference().struct_field().field() + 1;
+    switch (sort_field.direction()) {
+      case substrait::SortField::SORT_DIRECTION_ASC_NULLS_FIRST:
+        ctx_->orderby_collation_.emplace_back(tle_no, false, true);
+        break;
+      case substrait::SortField::SORT_DIRECTION_ASC_NULLS_LAST:
+        ctx_->orderby_collation_.emplace_back(tle_no, false, false);
+        break;
+      case substrait::SortField::SORT_DIRECTION_DESC_NULLS_FIRST:
+        ctx_->orderby_collation_.emplace_back(tle_no, true, true);
+        break;
+      case substrait::SortField::SORT_DIRECTION_DESC_NULLS_LAST:
+        ctx_->orderby_collation_.emplace_back(tle_no, true, false);
+        break;
+      default:
+        CIDER_THROW(CiderCompileException,
+                    fmt::format("Unsupported sort direction {}", sort_field.direction()));
+    }
+  }
+  if (fetch) {
+    // A negative count means all rows, while LIMIT 0 returns none of them.
+    if (fetch->count() >= 0) {
+      ctx_->limit_ = fetch->count();
+    }
+    ctx_->offset_ = fetch->offset() > 0 ? fetch->offset() : 0;
+  }
+}
+
 std::shared_ptr<RelAlgExecutionUnit>
 SubstraitToRelAlgExecutionUnit::createRelAlgExecutionUnit(
     const std::vector<substrait::Expression*> exprs,
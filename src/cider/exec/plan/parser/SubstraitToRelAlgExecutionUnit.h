@@ -113,6 +113,9 @@ class SubstraitToRelAlgExecutionUnit {
   void updateGeneratorContext(const substrait::Rel& rel_node,
                               const std::unordered_map<int, std::string>& function_map);
 
+  // Updates sort info from the sort and fetch rels on top of the plan.
+  void updateSortInfo(const substrait::SortRel& sort, const substrait::FetchRel* fetch);
+
   // Postorder traversal to get all Relnode, use this traversal result to generate ctx
   void getRelNodesInPostOder(
       const substrait::Rel& rel_node,
@@ -23,12 +23,28 @@
 
 namespace cider::plan {
 
+namespace {
+
+// Returns the rel below the sort and fetch on top of the plan, which are applied to its
+// output.
+const ::substrait::Rel& skipSortRel(const ::substrait::Rel& rel) {
+  if (rel.has_fetch()) {
+    return skipSortRel(rel.fetch().input());
+  }
+  if (rel.has_sort()) {
+    return skipSortRel(rel.sort().input());
+  }
+  return rel;
+}
+
+}  // namespace
+
 SubstraitPlan::SubstraitPlan(const substrait::Plan& plan) : plan_(plan) {}
 
 bool SubstraitPlan::hasAggregateRel() const {
   for (auto& rel : plan_.relations()) {
     if (rel.has_root() && rel.root().has_input()) {
-      if (rel.root().input().has_aggregate()) {
+      if (skipSortRel(rel.root().input()).has_aggregate()) {
         return true;
       }
     }
@@ -39,7 +55,19 @@ bool SubstraitPlan::hasAggregateRel() const {
 bool SubstraitPlan::hasJoinRel() const {
   for (auto& rel : plan_.relations()) {
     if (rel.has_root() && rel.root().has_input()) {
-      if (rel.root().input().has_join()) {
+      if (skipSortRel(rel.root().input()).has_join()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool SubstraitPlan::hasSortRel() const {
+  for (auto& rel : plan_.relations()) {
+    if (rel.has_root() && rel.root().has_input()) {
+      auto& input = rel.root().input();
+      if (input.has_sort() || (input.has_fetch() && input.fetch().input().has_sort())) {
         return true;
       }
     }
@@ -50,7 +78,7 @@ bool SubstraitPlan::hasJoinRel() const {
 const std::optional<std::shared_ptr<::substrait::JoinRel>> SubstraitPlan::getJoinRel() {
   if (hasJoinRel()) {
     return std::make_shared<::substrait::JoinRel>(
-        plan_.relations(0).root().input().join());
+        skipSortRel(plan_.relations(0).root().input()).join());
   }
   return std::nullopt;
 }
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/processor/CompileThreadPool.h"
+
+#include <algorithm>
+
+namespace cider::exec::processor {
+
+CompileThreadPool::CompileThreadPool(size_t thread_num) {
+  workers_.reserve(thread_num);
+  for (size_t i = 0; i < thread_num; ++i) {
+    workers_.emplace_back(&CompileThreadPool::worker, this);
+  }
+}
+
+CompileThreadPool::~CompileThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    should_exit_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+CompileThreadPool& CompileThreadPool::getInstance() {
+  // Compilation is CPU bound, leave most of cores to query execution.
+  static CompileThreadPool instance(
+      std::max(1U, std::thread::hardware_concurrency() / 4));
+  return instance;
+}
+
+void CompileThreadPool::submit(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void CompileThreadPool::worker() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !tasks_.empty() || should_exit_; });
+      // drain pending tasks before exit, someone may be waiting on their results
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+}  // namespace cider::exec::processor
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_COMPILE_THREAD_POOL_H
+#define CIDER_COMPILE_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace cider::exec::processor {
+
+/// \brief Background threads shared by all batch processors to compile queries
+/// asynchronously, so driver threads don't block on LLVM codegen.
+class CompileThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit CompileThreadPool(size_t thread_num);
+
+  ~CompileThreadPool();
+
+  CompileThreadPool(const CompileThreadPool&) = delete;
+  CompileThreadPool& operator=(const CompileThreadPool&) = delete;
+
+  static CompileThreadPool& getInstance();
+
+  void submit(Task task);
+
+  size_t getThreadNum() const { return workers_.size(); }
+
+ private:
+  void worker();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool should_exit_{false};
+  std::queue<Task> tasks_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace cider::exec::processor
+
+#endif  // CIDER_COMPILE_THREAD_POOL_H
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "exec/processor/CompiledQueryCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace cider::exec::processor {
+
+CompiledQueryCache& CompiledQueryCache::getInstance() {
+  static CompiledQueryCache instance;
+  return instance;
+}
+
+std::string CompiledQueryCache::makeKey(const ::substrait::Plan& plan,
+                                        const jitlib::CompilationOptions& co,
+                                        const nextgen::context::CodegenOptions& cgo) {
+  std::string key;
+  {
+    // Deterministic serialization keeps map fields ordered, so equal plans always
+    // produce the same bytes.
+    google::protobuf::io::StringOutputStream output(&key);
+    google::protobuf::io::CodedOutputStream coded_output(&output);
+    coded_output.SetSerializationDeterministic(true);
+    plan.SerializeToCodedStream(&coded_output);
+  }
+  key.push_back(static_cast<char>(co.optimize_level));
+  key.push_back(co.aggressive_jit_compile);
+  key.push_back(co.dump_ir);
+  key.push_back(co.enable_avx2);
+  key.push_back(co.enable_avx512);
+  key.push_back(co.keep_ir);
+  key.append(co.dump_dir);
+  key.push_back(cgo.enable_block_codegen);
+  key.push_back(cgo.enable_late_materialization);
+  return key;
+}
+
+CompiledQueryCache::CacheValue CompiledQueryCache::lookupOrInsert(
+    const std::string& key,
+    std::promise<CompiledQueryPtr>& promise,
+    bool& need_compile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto cached = cache_.get(key)) {
+    ++stats_.hits;
+    need_compile = false;
+    return *cached;
+  }
+  ++stats_.misses;
+  if (cache_.size() >= cache_.capacity()) {
+    ++stats_.evictions;
+  }
+  CacheValue entry{promise.get_future().share(), next_id_++};
+  cache_.put(key, entry);
+  need_compile = true;
+  return entry;
+}
+
+void CompiledQueryCache::compile(const std::string& key,
+                                 uint64_t id,
+                                 std::promise<CompiledQueryPtr>& promise,
+                                 const Compiler& compiler) {
+  try {
+    promise.set_value(compiler());
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The entry may have been evicted and inserted again by another request.
+    auto it = cache_.find(key);
+    if (it != cache_.cend() && it->second.id == id) {
+      cache_.erase(key);
+    }
+  }
+}
+
+CompiledQueryPtr CompiledQueryCache::getOrCompile(
+    const ::substrait::Plan& plan,
+    const jitlib::CompilationOptions& co,
+    const nextgen::context::CodegenOptions& cgo,
+    const Compiler& compiler) {
+  auto key = makeKey(plan, co, cgo);
+
+  std::promise<CompiledQueryPtr> promise;
+  bool need_compile = false;
+  auto entry = lookupOrInsert(key, promise, need_compile);
+  if (need_compile) {
+    compile(key, entry.id, promise, compiler);
+  }
+
+  return entry.future.get();
+}
+
+CompiledQueryFuture CompiledQueryCache::getOrCompileAsync(
+    const ::substrait::Plan& plan,
+    const jitlib::CompilationOptions& co,
+    const nextgen::context::CodegenOptions& cgo,
+    Compiler compiler,
+    CompileThreadPool& pool) {
+  auto key = makeKey(plan, co, cgo);
+
+  auto promise = std::make_shared<std::promise<CompiledQueryPtr>>();
+  bool need_compile = false;
+  auto entry = lookupOrInsert(key, *promise, need_compile);
+  if (need_compile) {
+    pool.submit([this,
+                 key = std::move(key),
+                 id = entry.id,
+                 promise,
+                 compiler = std::move(compiler)]() {
+      compile(key, id, *promise, compiler);
+    });
+  }
+
+  return entry.future;
+}
+
+CompiledQueryCache::Stats CompiledQueryCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.size = cache_.size();
+  return stats;
+}
+
+void CompiledQueryCache::reset(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_ = LruCache<std::string, CacheValue>(capacity);
+  stats_ = Stats{};
+}
+
+}  // namespace cider::exec::processor
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_COMPILED_QUERY_CACHE_H
+#define CIDER_COMPILED_QUERY_CACHE_H
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+
+#include "exec/nextgen/Nextgen.h"
+#include "exec/processor/CompileThreadPool.h"
+#include "substrait/plan.pb.h"
+#include "type/data/string/LruCache.hpp"
+
+namespace cider::exec::processor {
+
+struct CompiledQuery {
+  std::shared_ptr<nextgen::context::CodegenContext> codegen_ctx;
+  nextgen::QueryFunc query_func;
+};
+
+using CompiledQueryPtr = std::shared_ptr<const CompiledQuery>;
+using CompiledQueryFuture = std::shared_future<CompiledQueryPtr>;
+
+/// \brief Process-wide LRU cache of compiled query functions.
+///
+/// Entries are keyed by the deterministic serialization of Substrait plan together with
+/// the compilation and codegen options, so identical plan fragments share the same
+/// machine code across processors. Concurrent requests of a key being compiled wait for
+/// the result instead of compiling it again.
+class CompiledQueryCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 128;
+
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t size{0};
+  };
+
+  using Compiler = std::function<CompiledQueryPtr()>;
+
+  explicit CompiledQueryCache(size_t capacity = kDefaultCapacity) : cache_(capacity) {}
+
+  static CompiledQueryCache& getInstance();
+
+  CompiledQueryPtr getOrCompile(const ::substrait::Plan& plan,
+                                const jitlib::CompilationOptions& co,
+                                const nextgen::context::CodegenOptions& cgo,
+                                const Compiler& compiler);
+
+  /// Same as getOrCompile, but a miss is compiled on the given pool and the returned
+  /// future becomes ready once the compilation is done.
+  CompiledQueryFuture getOrCompileAsync(const ::substrait::Plan& plan,
+                                        const jitlib::CompilationOptions& co,
+                                        const nextgen::context::CodegenOptions& cgo,
+                                        Compiler compiler,
+                                        CompileThreadPool& pool);
+
+  static std::string makeKey(const ::substrait::Plan& plan,
+                             const jitlib::CompilationOptions& co,
+                             const nextgen::context::CodegenOptions& cgo);
+
+  Stats getStats() const;
+
+  // Drops all entries and counters, and resizes the cache.
+  void reset(size_t capacity = kDefaultCapacity);
+
+ private:
+  struct CacheValue {
+    CompiledQueryFuture future;
+    // Tells apart entries inserted again for the same key after eviction.
+    uint64_t id;
+  };
+
+  // Returns the cached entry of key, or registers a new one bound to promise and sets
+  // need_compile.
+  CacheValue lookupOrInsert(const std::string& key,
+                            std::promise<CompiledQueryPtr>& promise,
+                            bool& need_compile);
+
+  // A failed entry is erased, unless it has been replaced, so the next request retries.
+  void compile(const std::string& key,
+               uint64_t id,
+               std::promise<CompiledQueryPtr>& promise,
+               const Compiler& compiler);
+
+  mutable std::mutex mutex_;
+  LruCache<std::string, CacheValue> cache_;
+  Stats stats_;
+  uint64_t next_id_{0};
+};
+
+}  // namespace cider::exec::processor
+
+#endif  // CIDER_COMPILED_QUERY_CACHE_H
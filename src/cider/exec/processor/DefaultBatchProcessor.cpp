@@ -21,10 +21,12 @@
 
 #include "exec/processor/DefaultBatchProcessor.h"
 
+#include <chrono>
 #include <memory>
 
 #include "cider/CiderException.h"
 #include "exec/plan/parser/SubstraitToRelAlgExecutionUnit.h"
+#include "exec/processor/CompileThreadPool.h"
 #include "exec/processor/StatefulProcessor.h"
 #include "exec/processor/StatelessProcessor.h"
 
@@ -33,24 +35,131 @@ namespace cider::exec::processor {
 DefaultBatchProcessor::DefaultBatchProcessor(const plan::SubstraitPlanPtr& plan,
                                              const BatchProcessorContextPtr& context)
     : plan_(plan), context_(context) {
-  auto allocator = context->getAllocator();
   if (plan_->hasJoinRel()) {
     // TODO: currently we can't distinguish the joinRel is either a hashJoin rel
     // or a mergeJoin rel, just hard-code as HashJoinHandler for now and will refactor to
     // initialize joinHandler accordingly once the
-    joinHandler_ = std::make_shared<HashProbeHandler>(shared_from_this());
+    joinHandler_ = std::make_shared<HashProbeHandler>(this);
     this->state_ = BatchProcessorState::kWaiting;
   }
 
-  auto translator =
-      std::make_shared<generator::SubstraitToRelAlgExecutionUnit>(plan_->getPlan());
-  RelAlgExecutionUnit ra_exe_unit = translator->createRelAlgExecutionUnit();
-  jitlib::CompilationOptions co;
-  co.dump_ir = true;
-  codegen_context_ = nextgen::compile(ra_exe_unit, co);
-  runtime_context_ = codegen_context_->generateRuntimeCTX(allocator);
-  query_func_ = reinterpret_cast<nextgen::QueryFunc>(
-      codegen_context_->getJITFunction()->getFunctionPointer<void, int8_t*, int8_t*>());
+  const auto& diagnostics = context->getDiagnosticsOptions();
+  co_.dump_ir = diagnostics.dump_ir;
+  co_.dump_dir = diagnostics.dump_dir;
+  co_.keep_ir = diagnostics.keep_ir;
+  co_.object_cache_dir = context->getObjectCacheDir();
+  cgo_.enable_block_codegen = context->isBlockCodegen();
+  cgo_.enable_late_materialization = context->isLateMaterialization();
+
+  auto co = co_;
+  if (context->isTieredCompile()) {
+    // First tier skips IR optimization and uses fast instruction selection, the fully
+    // optimized one is compiled in background once the query turns out to be long.
+    co.optimize_level = jitlib::LLVMJITOptimizeLevel::DEBUG;
+    co.aggressive_jit_compile = false;
+    tier_up_pending_ = true;
+  }
+
+  if (context->isAsyncCompile()) {
+    compiled_query_future_ = compileAsync(co);
+  } else {
+    auto& cache = CompiledQueryCache::getInstance();
+    onCompiled(cache.getOrCompile(plan_->getPlan(), co, cgo_, makeCompiler(co)));
+  }
+}
+
+CompiledQueryCache::Compiler DefaultBatchProcessor::makeCompiler(
+    const jitlib::CompilationOptions& co) const {
+  // Captures by value, async compilation may outlive this processor.
+  return [plan = plan_, co, cgo = cgo_]() {
+    auto translator =
+        std::make_shared<generator::SubstraitToRelAlgExecutionUnit>(plan->getPlan());
+    RelAlgExecutionUnit ra_exe_unit = translator->createRelAlgExecutionUnit();
+    std::shared_ptr<nextgen::context::CodegenContext> codegen_context =
+        nextgen::compile(ra_exe_unit, co, cgo);
+    auto query_func = reinterpret_cast<nextgen::QueryFunc>(
+        codegen_context->getJITFunction()->getFunctionPointer<void, int8_t*, int8_t*>());
+    return std::make_shared<const CompiledQuery>(
+        CompiledQuery{std::move(codegen_context), query_func});
+  };
+}
+
+CompiledQueryFuture DefaultBatchProcessor::compileAsync(
+    const jitlib::CompilationOptions& co) const {
+  // Hash join build table is fed into runtime context, so join queries are shared too.
+  return CompiledQueryCache::getInstance().getOrCompileAsync(
+      plan_->getPlan(), co, cgo_, makeCompiler(co), CompileThreadPool::getInstance());
+}
+
+void DefaultBatchProcessor::onCompiled(const CompiledQueryPtr& compiled_query) {
+  codegen_context_ = compiled_query->codegen_ctx;
+  query_func_ = compiled_query->query_func;
+  runtime_context_ = codegen_context_->generateRuntimeCTX(context_->getAllocator());
+  if (hashTable_) {
+    runtime_context_->setJoinHashTable(hashTable_->getHashTable());
+  }
+  if (auto sorter = runtime_context_->getSorter()) {
+    sorter->setSpillThreshold(context_->getSortSpillThreshold());
+  }
+}
+
+void DefaultBatchProcessor::ensureCompiled() {
+  if (!query_func_) {
+    // rethrows the exception if compilation failed
+    onCompiled(compiled_query_future_.get());
+  }
+}
+
+void DefaultBatchProcessor::tryTierUp() {
+  if (tier_up_future_.valid()) {
+    if (tier_up_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+    try {
+      auto compiled_query = tier_up_future_.get();
+      // Both tiers are generated from the same plan, so states kept in runtime context
+      // can be carried over to the optimized function.
+      CHECK(compiled_query->codegen_ctx->hasSameRuntimeLayout(*codegen_context_));
+      if (Type::kStateless == getProcessorType() && !runtime_context_->getSorter()) {
+        // Nothing is kept across batches, switch to the runtime context of the new tier.
+        onCompiled(compiled_query);
+      } else {
+        codegen_context_ = compiled_query->codegen_ctx;
+        query_func_ = compiled_query->query_func;
+      }
+      tiered_up_ = true;
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Optimized compilation failed, keep running the first tier: "
+                   << e.what();
+    }
+    tier_up_future_ = CompiledQueryFuture();
+    return;
+  }
+
+  if (tier_up_pending_ && ++processed_batch_num_ >= context_->getTierUpBatchNum()) {
+    tier_up_pending_ = false;
+    tier_up_future_ = compileAsync(co_);
+  }
+}
+
+void DefaultBatchProcessor::appendToSorter(nextgen::context::Batch* batch) {
+  struct ArrowArray array;
+  struct ArrowSchema schema;
+  batch->move(schema, array);
+  runtime_context_->getSorter()->append(&array);
+  array.release(&array);
+  schema.release(&schema);
+}
+
+void DefaultBatchProcessor::getSortedResult(struct ArrowArray& array,
+                                            struct ArrowSchema& schema) {
+  auto sorter = runtime_context_->getSorter();
+  auto output_batch = sorter->getOutputBatch(context_->getOutputBatchRows(),
+                                             context_->getOutputBatchBytes());
+  if (!sorter->hasMoreOutput()) {
+    state_ = BatchProcessorState::kFinished;
+  }
+  output_batch->move(schema, array);
 }
 
 void DefaultBatchProcessor::processNextBatch(const struct ArrowArray* array,
@@ -60,17 +169,23 @@ void DefaultBatchProcessor::processNextBatch(const struct ArrowArray* array,
                 "DefaultBatchProcessor::processNextBatch can only be called if state is "
                 "kRunning.");
   }
-  if (joinHandler_) {
-    // this->inputBatch_ = joinHandler_->onProcessBatch(batch);
-  } else {
-    input_arrow_array_ = array;
-    input_arrow_schema_ = schema;
-  }
+  ensureCompiled();
+  tryTierUp();
+  // TODO: spill probe rows by joinHandler_ if the build side was spilled.
+  input_arrow_array_ = array;
+  input_arrow_schema_ = schema;
 
   query_func_((int8_t*)runtime_context_.get(), (int8_t*)array);
 }
 
 BatchProcessorState DefaultBatchProcessor::getState() {
+  if (!query_func_) {
+    if (compiled_query_future_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return BatchProcessorState::kWaiting;
+    }
+    ensureCompiled();
+  }
   if (joinHandler_) {
     joinHandler_->onState(state_);
   }
@@ -86,9 +201,32 @@ void DefaultBatchProcessor::finish() {
 
 void DefaultBatchProcessor::feedHashBuildTable(
     const std::shared_ptr<JoinHashTable>& hashTable) {
+  auto table = std::dynamic_pointer_cast<DefaultJoinHashTable>(hashTable);
+  if (!table) {
+    CIDER_THROW(CiderRuntimeException,
+                "DefaultBatchProcessor only accepts hash table built by "
+                "DefaultJoinHashTableBuilder.");
+  }
+  // Build rows are referenced by generated code, keep them alive with the processor.
+  hashTable_ = table;
+  if (runtime_context_) {
+    runtime_context_->setJoinHashTable(hashTable_->getHashTable());
+  }
   // switch state from waiting to running once hashTable is ready
   this->state_ = BatchProcessorState::kRunning;
-  // TODO: feed the hashTable into nextGen context
+}
+
+void DefaultBatchProcessor::mergePartialAggregation(
+    const std::vector<BatchProcessorPtr>& partials,
+    size_t threadNum) {
+  CIDER_THROW(CiderRuntimeException,
+              "Partial aggregation can only be merged by stateful processor.");
+}
+
+std::string DefaultBatchProcessor::getIR() const {
+  const auto& codegen_context =
+      codegen_context_ ? codegen_context_ : compiled_query_future_.get()->codegen_ctx;
+  return codegen_context->getJITModule()->getIR();
 }
 
 std::unique_ptr<BatchProcessor> makeBatchProcessor(
@@ -25,6 +25,8 @@
 #include "cider/processor/BatchProcessor.h"
 #include "exec/nextgen/Nextgen.h"
 #include "exec/plan/substrait/SubstraitPlan.h"
+#include "exec/processor/CompiledQueryCache.h"
+#include "exec/processor/DefaultJoinHashTableBuilder.h"
 #include "exec/processor/JoinHandler.h"
 
 namespace cider::exec::processor {
@@ -47,7 +49,34 @@ class DefaultBatchProcessor : public BatchProcessor {
 
   void feedHashBuildTable(const std::shared_ptr<JoinHashTable>& hashTable) override;
 
+  void mergePartialAggregation(const std::vector<BatchProcessorPtr>& partials,
+                               size_t threadNum) override;
+
+  std::string getIR() const override;
+
+  // Whether the optimized tier of tiered compilation is running.
+  bool isTieredUp() const { return tiered_up_; }
+
  protected:
+  CompiledQueryCache::Compiler makeCompiler(const jitlib::CompilationOptions& co) const;
+
+  CompiledQueryFuture compileAsync(const jitlib::CompilationOptions& co) const;
+
+  void onCompiled(const CompiledQueryPtr& compiled_query);
+
+  // Blocks until the asynchronous compilation is done, no-op if already compiled.
+  void ensureCompiled();
+
+  // Tiered compilation: starts the optimized compilation after enough batches, and
+  // switches to it once it's ready.
+  void tryTierUp();
+
+  // Moves rows of batch into the sorter of output rows.
+  void appendToSorter(nextgen::context::Batch* batch);
+
+  // Returns the following sorted rows, and finishes after the last of them.
+  void getSortedResult(struct ArrowArray& array, struct ArrowSchema& schema);
+
   plan::SubstraitPlanPtr plan_;
 
   BatchProcessorContextPtr context_;
@@ -63,9 +92,24 @@ class DefaultBatchProcessor : public BatchProcessor {
 
   JoinHandlerPtr joinHandler_;
 
-  nextgen::context::CodegenCtxPtr codegen_context_;
+  std::shared_ptr<DefaultJoinHashTable> hashTable_;
+
+  // Options of the fully optimized compilation.
+  jitlib::CompilationOptions co_;
+  nextgen::context::CodegenOptions cgo_;
+
+  // Valid only in async compile mode, query_func_ is null until it's consumed.
+  CompiledQueryFuture compiled_query_future_;
+
+  // Shared with other processors of the same plan through CompiledQueryCache.
+  std::shared_ptr<nextgen::context::CodegenContext> codegen_context_;
   nextgen::context::RuntimeCtxPtr runtime_context_;
   nextgen::QueryFunc query_func_;
+
+  bool tier_up_pending_{false};
+  size_t processed_batch_num_{0};
+  CompiledQueryFuture tier_up_future_;
+  bool tiered_up_{false};
 };
 
 }  // namespace cider::exec::processor
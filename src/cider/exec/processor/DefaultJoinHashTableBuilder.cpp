@@ -21,15 +21,213 @@
 
 #include "DefaultJoinHashTableBuilder.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+#include "cider/CiderException.h"
+#include "exec/plan/parser/ConverterHelper.h"
+
 namespace cider::exec::processor {
 
+using nextgen::context::Batch;
+using nextgen::context::JoinHashMap;
+using nextgen::context::PartitionedJoinHashMap;
+
+namespace {
+bool isFieldReference(const ::substrait::Expression& expr) {
+  return expr.has_selection() && expr.selection().has_direct_reference() &&
+         expr.selection().direct_reference().has_struct_field();
+}
+
+int getFieldIndex(const ::substrait::Expression& expr) {
+  return expr.selection().direct_reference().struct_field().field();
+}
+
+// Returns the build side (right) column of the join key, which is the only comparison
+// between a field of each side in the join condition.
+int getBuildKeyColumn(const ::substrait::JoinRel& joinRel) {
+  int leftSize = generator::getSizeOfOutputColumns(joinRel.left());
+  std::vector<const ::substrait::Expression*> conditions{&joinRel.expression()};
+  int keyColumn = -1;
+  int keyNum = 0;
+  while (!conditions.empty()) {
+    auto condition = conditions.back();
+    conditions.pop_back();
+    if (!condition->has_scalar_function()) {
+      continue;
+    }
+    const auto& function = condition->scalar_function();
+    if (function.arguments_size() == 2 &&
+        isFieldReference(function.arguments(0).value()) &&
+        isFieldReference(function.arguments(1).value())) {
+      int lhs = getFieldIndex(function.arguments(0).value());
+      int rhs = getFieldIndex(function.arguments(1).value());
+      if ((lhs < leftSize) != (rhs < leftSize)) {
+        keyColumn = std::max(lhs, rhs) - leftSize;
+        ++keyNum;
+      }
+      continue;
+    }
+    for (const auto& argument : function.arguments()) {
+      conditions.push_back(&argument.value());
+    }
+  }
+  if (keyNum != 1) {
+    CIDER_THROW(CiderUnsupportedException,
+                "Only join with a single equi-join key is supported in hash join build.");
+  }
+  return keyColumn;
+}
+
+template <typename T>
+void scatterKeys(DefaultJoinHashTable::Partitions& partitions,
+                 size_t partitionBits,
+                 Batch* batch,
+                 int keyColumn) {
+  auto column = batch->getArray()->children[keyColumn];
+  auto nulls = reinterpret_cast<const uint8_t*>(column->buffers[0]);
+  auto keys = reinterpret_cast<const T*>(column->buffers[1]);
+  for (int64_t i = 0; i < column->length; ++i) {
+    // null keys never match in inner join
+    if (nulls && !(nulls[i >> 3] & (1 << (i & 7)))) {
+      continue;
+    }
+    int64_t key = keys[i];
+    partitions[PartitionedJoinHashMap::getPartition(key, partitionBits)].push_back(
+        {key, batch, i});
+  }
+}
+}  // namespace
+
+DefaultJoinHashTableBuilder::DefaultJoinHashTableBuilder(
+    const ::substrait::JoinRel& joinRel,
+    const std::shared_ptr<JoinHashTableBuildContext>& context)
+    : joinRel_(joinRel)
+    , context_(context)
+    , keyColumn_(getBuildKeyColumn(joinRel))
+    , partitions_(size_t(1) << kPartitionBits) {}
+
+DefaultJoinHashTable::~DefaultJoinHashTable() {
+  if (reserved_) {
+    std::static_pointer_cast<CiderTrackingAllocator>(allocator_)->release(reserved_);
+  }
+}
+
+std::unique_ptr<JoinHashTable> DefaultJoinHashTable::merge(
+    std::vector<std::unique_ptr<JoinHashTable>> otherTables) {
+  for (auto& table : otherTables) {
+    auto other = dynamic_cast<DefaultJoinHashTable*>(table.get());
+    CHECK(other);
+    CHECK_EQ(other->partitionBits_, partitionBits_);
+    std::move(
+        other->batches_.begin(), other->batches_.end(), std::back_inserter(batches_));
+    for (size_t i = 0; i < partitions_.size(); ++i) {
+      auto& entries = other->partitions_[i];
+      partitions_[i].insert(partitions_[i].end(), entries.begin(), entries.end());
+      std::vector<Entry>().swap(entries);
+    }
+  }
+  auto merged = std::make_unique<DefaultJoinHashTable>(
+      std::move(batches_), partitionBits_, std::move(partitions_), allocator_);
+  merged->buildHashTable(otherTables.size() + 1);
+  return merged;
+}
+
+PartitionedJoinHashMap* DefaultJoinHashTable::getHashTable() {
+  buildHashTable(1);
+  return hashMap_.get();
+}
+
+std::shared_ptr<const JoinKeyFilter> DefaultJoinHashTable::getKeyFilter() {
+  buildHashTable(1);
+  return keyFilter_;
+}
+
+void DefaultJoinHashTable::buildHashTable(size_t threadNum) {
+  std::call_once(built_, [this, threadNum]() {
+    size_t keyNum = 0;
+    size_t bytes = 0;
+    for (auto& entries : partitions_) {
+      keyNum += entries.size();
+      bytes += JoinHashMap::memory_for(entries.size());
+    }
+    // sub-tables are sized by reserve() below, so they never outgrow the reservation
+    if (auto tracker = std::dynamic_pointer_cast<CiderTrackingAllocator>(allocator_)) {
+      tracker->reserve(bytes);
+      reserved_ = bytes;
+    }
+    threadNum = std::max<size_t>(1, std::min(threadNum, partitions_.size()));
+    hashMap_ = std::make_unique<PartitionedJoinHashMap>(partitionBits_);
+    // every thread fills its own key filter, they are unioned at last
+    std::vector<JoinKeyFilter> filters(threadNum, JoinKeyFilter(keyNum));
+
+    // partitions are independent, threads take them one by one
+    std::atomic<size_t> nextPartition{0};
+    auto buildPartitions = [this, &nextPartition](JoinKeyFilter& filter) {
+      for (size_t i = nextPartition++; i < partitions_.size(); i = nextPartition++) {
+        auto& table = hashMap_->getPartitionTable(i);
+        table.reserve(partitions_[i].size());
+        for (auto& entry : partitions_[i]) {
+          table.insert(entry.key, std::make_pair(entry.batch, entry.row));
+          filter.insert(entry.key);
+        }
+        std::vector<Entry>().swap(partitions_[i]);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadNum; ++i) {
+      threads.emplace_back(buildPartitions, std::ref(filters[i]));
+    }
+    buildPartitions(filters[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t i = 1; i < threadNum; ++i) {
+      filters[0].merge(filters[i]);
+    }
+    keyFilter_ = std::make_shared<const JoinKeyFilter>(std::move(filters[0]));
+    hashMap_->setKeyFilter(keyFilter_.get());
+  });
+}
+
 std::unique_ptr<JoinHashTable> DefaultJoinHashTableBuilder::build() {
-  // TODO: build a join hash table
-  return std::move(hashTable_);
+  auto partitions = DefaultJoinHashTable::Partitions(size_t(1) << kPartitionBits);
+  partitions.swap(partitions_);
+  return std::make_unique<DefaultJoinHashTable>(
+      std::move(batches_), kPartitionBits, std::move(partitions), context_->allocator());
 }
 
 void DefaultJoinHashTableBuilder::appendBatch(std::shared_ptr<CiderBatch> batch) {
-  // TODO: add batch into hashTable
+  // Takes over the arrow data, build rows are referenced by the hash table until the
+  // probe side finishes.
+  ArrowSchema schema;
+  ArrowArray array;
+  batch->move(schema, array);
+  batches_.emplace_back(std::make_unique<Batch>(schema, array));
+
+  auto buildBatch = batches_.back().get();
+  auto format = buildBatch->getSchema()->children[keyColumn_]->format;
+  switch (format[0]) {
+    case 'c':
+      scatterKeys<int8_t>(partitions_, kPartitionBits, buildBatch, keyColumn_);
+      break;
+    case 's':
+      scatterKeys<int16_t>(partitions_, kPartitionBits, buildBatch, keyColumn_);
+      break;
+    case 'i':
+      scatterKeys<int32_t>(partitions_, kPartitionBits, buildBatch, keyColumn_);
+      break;
+    case 'l':
+      scatterKeys<int64_t>(partitions_, kPartitionBits, buildBatch, keyColumn_);
+      break;
+    default:
+      CIDER_THROW(CiderUnsupportedException,
+                  std::string("Unsupported join key format: ") + format);
+  }
 }
 
 std::shared_ptr<JoinHashTableBuilder> makeJoinHashTableBuilder(
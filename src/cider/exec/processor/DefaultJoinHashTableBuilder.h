@@ -23,18 +23,70 @@
 #define CIDER_DEFAULT_JOIN_HASH_TABLE_BUILDER_H
 
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "cider/processor/BatchProcessorContext.h"
 #include "cider/processor/JoinHashTableBuilder.h"
 #include "exec/module/batch/ArrowABI.h"
+#include "exec/nextgen/context/CodegenContext.h"
 
 namespace cider::exec::processor {
 
+/// Build side of a hash join, owns the build batches referenced by the hash map.
+class DefaultJoinHashTable : public JoinHashTable {
+ public:
+  struct Entry {
+    int64_t key;
+    nextgen::context::Batch* batch;
+    int64_t row;
+  };
+  // build rows scattered by nextgen::context::PartitionedJoinHashMap::getPartition
+  using Partitions = std::vector<std::vector<Entry>>;
+
+  DefaultJoinHashTable(std::vector<nextgen::context::BatchPtr>&& batches,
+                       size_t partitionBits,
+                       Partitions&& partitions,
+                       const std::shared_ptr<CiderAllocator>& allocator)
+      : batches_(std::move(batches))
+      , partitionBits_(partitionBits)
+      , partitions_(std::move(partitions))
+      , allocator_(allocator) {}
+
+  ~DefaultJoinHashTable() override;
+
+  /// partitions of all tables are built concurrently, one thread per table.
+  std::unique_ptr<JoinHashTable> merge(
+      std::vector<std::unique_ptr<JoinHashTable>> otherTables) override;
+
+  /// builds the hash map on first call if it isn't built by merge. Its memory is
+  /// reserved up front if the allocator is a CiderTrackingAllocator.
+  nextgen::context::PartitionedJoinHashMap* getHashTable();
+
+  std::shared_ptr<const JoinKeyFilter> getKeyFilter() override;
+
+ private:
+  void buildHashTable(size_t threadNum);
+
+  std::vector<nextgen::context::BatchPtr> batches_;
+  size_t partitionBits_;
+  Partitions partitions_;
+  std::shared_ptr<CiderAllocator> allocator_;
+  // bytes of the hash map reserved on allocator_
+  size_t reserved_{0};
+  std::once_flag built_;
+  std::unique_ptr<nextgen::context::PartitionedJoinHashMap> hashMap_;
+  std::shared_ptr<const JoinKeyFilter> keyFilter_;
+};
+
 class DefaultJoinHashTableBuilder : public JoinHashTableBuilder {
  public:
+  // 32 partitions, enough to keep build drivers busy with moderate skew.
+  static constexpr size_t kPartitionBits = 5;
+
   DefaultJoinHashTableBuilder(const ::substrait::JoinRel& joinRel,
-                              const std::shared_ptr<JoinHashTableBuildContext>& context)
-      : joinRel_(joinRel), context_(context) {}
+                              const std::shared_ptr<JoinHashTableBuildContext>& context);
 
+  /// scatters the keys into partitions on the calling driver.
   void appendBatch(std::shared_ptr<CiderBatch> batch) override;
 
   std::unique_ptr<JoinHashTable> build() override;
@@ -42,7 +94,10 @@ class DefaultJoinHashTableBuilder : public JoinHashTableBuilder {
  private:
   ::substrait::JoinRel joinRel_;
   std::shared_ptr<JoinHashTableBuildContext> context_;
-  std::unique_ptr<JoinHashTable> hashTable_;
+  // index of the join key column in build batches
+  int keyColumn_;
+  std::vector<nextgen::context::BatchPtr> batches_;
+  DefaultJoinHashTable::Partitions partitions_;
 };
 
 }  // namespace cider::exec::processor
@@ -43,7 +43,8 @@ using JoinHandlerPtr = std::shared_ptr<JoinHandler>;
 
 class HashProbeHandler : public JoinHandler {
  public:
-  explicit HashProbeHandler(const BatchProcessorPtr& batchProcessor)
+  // batchProcessor owns this handler
+  explicit HashProbeHandler(BatchProcessor* batchProcessor)
       : batchProcessor_(batchProcessor) {}
 
   std::shared_ptr<CiderBatch> onProcessBatch(std::shared_ptr<CiderBatch> batch) override;
@@ -51,7 +52,7 @@ class HashProbeHandler : public JoinHandler {
   void onState(BatchProcessorState state) override;
 
  private:
-  BatchProcessorPtr batchProcessor_;
+  BatchProcessor* batchProcessor_;
 };
 
 }  // namespace cider::exec::processor
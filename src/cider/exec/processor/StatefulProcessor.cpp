@@ -23,6 +23,8 @@
 
 #include <utility>
 
+#include "cider/CiderException.h"
+
 namespace cider::exec::processor {
 
 void StatefulProcessor::getResult(struct ArrowArray& array, struct ArrowSchema& schema) {
@@ -32,9 +34,62 @@ void StatefulProcessor::getResult(struct ArrowArray& array, struct ArrowSchema&
     return;
   }
 
-  state_ = BatchProcessorState::kFinished;
-  // TODO: getResult through nextGen runtime api
+  if (context_->isPartialAggregation()) {
+    // States are kept for the final processor, no batch is returned. Released structs
+    // tell callers there's nothing to read or release.
+    state_ = BatchProcessorState::kFinished;
+    input_arrow_array_ = nullptr;
+    array.length = 0;
+    array.release = nullptr;
+    schema.release = nullptr;
+    return;
+  }
+  ensureCompiled();
+  if (auto sorter = runtime_context_->getSorter()) {
+    if (!sorter->isSorted()) {
+      // all groups are sorted before the first of them is returned
+      do {
+        appendToSorter(runtime_context_->getAggOutputBatch(
+            context_->getOutputBatchRows(), context_->getOutputBatchBytes()));
+      } while (runtime_context_->hasMoreAggOutput());
+      sorter->sort();
+    }
+    getSortedResult(array, schema);
+    return;
+  }
+  auto output_batch = runtime_context_->getAggOutputBatch(
+      context_->getOutputBatchRows(), context_->getOutputBatchBytes());
+  if (!runtime_context_->hasMoreAggOutput()) {
+    state_ = BatchProcessorState::kFinished;
+  }
+  output_batch->move(schema, array);
   return;
 }
 
+void StatefulProcessor::mergePartialAggregation(
+    const std::vector<BatchProcessorPtr>& partials,
+    size_t threadNum) {
+  ensureCompiled();
+  std::vector<nextgen::context::RuntimeContext*> partial_contexts;
+  partial_contexts.reserve(partials.size());
+  for (auto& partial : partials) {
+    auto processor = dynamic_cast<StatefulProcessor*>(partial.get());
+    if (!processor || processor == this ||
+        processor->plan_->getPlan().SerializeAsString() !=
+            plan_->getPlan().SerializeAsString()) {
+      CIDER_THROW(CiderRuntimeException,
+                  "Partial aggregation must come from other stateful processors of the "
+                  "same plan.");
+    }
+    if (!processor->no_more_batch_) {
+      CIDER_THROW(CiderRuntimeException,
+                  "Partial aggregation can only be merged after it's finished.");
+    }
+    processor->ensureCompiled();
+    partial_contexts.push_back(processor->runtime_context_.get());
+  }
+  runtime_context_->mergePartialAggStates(
+      partial_contexts, context_->getAllocator(), threadNum);
+}
+
 }  // namespace cider::exec::processor
@@ -33,6 +33,9 @@ class StatefulProcessor : public DefaultBatchProcessor {
 
   void getResult(struct ArrowArray& array, struct ArrowSchema& schema) override;
 
+  void mergePartialAggregation(const std::vector<BatchProcessorPtr>& partials,
+                               size_t threadNum) override;
+
   Type getProcessorType() const override { return Type::kStateful; };
 };
 
@@ -26,6 +26,12 @@ namespace cider::exec::processor {
 void StatelessProcessor::getResult(struct ArrowArray& array, struct ArrowSchema& schema) {
   if (!input_arrow_array_) {
     if (no_more_batch_) {
+      ensureCompiled();
+      if (runtime_context_->getSorter()) {
+        // sorted rows are returned once all batches have been processed
+        getSortedResult(array, schema);
+        return;
+      }
       // set state as finish if last batch has been processed and no more batch
       state_ = BatchProcessorState::kFinished;
     }
@@ -33,6 +39,10 @@ void StatelessProcessor::getResult(struct ArrowArray& array, struct ArrowSchema&
     return;
   }
 
+  // forwarded input columns have to be filled before input is released.
+  runtime_context_->materializeOutputBatch(
+      const_cast<struct ArrowArray*>(input_arrow_array_));
+
   if (input_arrow_array_->release) {
     input_arrow_array_->release(const_cast<struct ArrowArray*>(input_arrow_array_));
   }
@@ -44,6 +54,11 @@ void StatelessProcessor::getResult(struct ArrowArray& array, struct ArrowSchema&
   input_arrow_schema_ = nullptr;
 
   auto output_batch = runtime_context_->getOutputBatch();
+  if (runtime_context_->getSorter()) {
+    appendToSorter(output_batch);
+    array.length = 0;
+    return;
+  }
   output_batch->move(schema, array);
   return;
 }
@@ -100,6 +100,9 @@ struct SortInfo {
   const SortAlgorithm algorithm;
   const size_t limit;
   const size_t offset;
+  // Whether limit applies even if it's 0. Only nextgen sort honors LIMIT 0, limit 0 means
+  // all rows elsewhere.
+  const bool has_limit{false};
 };
 
 struct JoinCondition {
@@ -21,6 +21,10 @@
  */
 #include "StringLike.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 enum LikeStatus {
   kLIKE_TRUE,
   kLIKE_FALSE,
@@ -260,6 +264,107 @@ extern "C" RUNTIME_EXPORT bool string_ilike(const char* str,
   return status == kLIKE_TRUE;
 }
 
+// Segment kernels: the LIKE pattern is split at compile time, so each row only searches
+// for fixed needles.
+template <bool is_ilike>
+static inline bool like_bytes_equal(const char* str,
+                                    const char* pat,
+                                    const int32_t len) {
+  for (int32_t i = 0; i < len; ++i) {
+    if ((is_ilike ? lowercase(str[i]) : str[i]) != pat[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef __SSE2__
+static inline __m128i like_lowercase_block(__m128i block) {
+  const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), block));
+  return _mm_add_epi8(block, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+#endif
+
+// Returns the start of the first occurrence of pat in str at or after from, -1 if none.
+// Candidates are filtered 16 positions at a time on the first and last needle bytes.
+template <bool is_ilike>
+static inline int32_t like_find(const char* str,
+                                const int32_t str_len,
+                                const int32_t from,
+                                const char* pat,
+                                const int32_t pat_len) {
+  if (pat_len == 0) {
+    return from;
+  }
+  const int32_t last = str_len - pat_len;
+  int32_t i = from;
+#ifdef __SSE2__
+  const __m128i first_char = _mm_set1_epi8(pat[0]);
+  const __m128i last_char = _mm_set1_epi8(pat[pat_len - 1]);
+  for (; i + 15 <= last; i += 16) {
+    __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+    __m128i block_last =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + pat_len - 1));
+    if (is_ilike) {
+      block_first = like_lowercase_block(block_first);
+      block_last = like_lowercase_block(block_last);
+    }
+    uint32_t mask = _mm_movemask_epi8(_mm_and_si128(
+        _mm_cmpeq_epi8(block_first, first_char), _mm_cmpeq_epi8(block_last, last_char)));
+    while (mask) {
+      const int32_t pos = i + __builtin_ctz(mask);
+      if (like_bytes_equal<is_ilike>(str + pos + 1, pat + 1, pat_len - 1)) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; i <= last; ++i) {
+    if (like_bytes_equal<is_ilike>(str + i, pat, pat_len)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+#define DEF_STRING_LIKE_SEGMENT_FUNCS(prefix, is_ilike)                                 \
+  extern "C" RUNTIME_EXPORT bool prefix##_exact(                                        \
+      const char* str, const int32_t str_len, const char* pat, const int32_t pat_len) { \
+    return str_len == pat_len && like_bytes_equal<is_ilike>(str, pat, pat_len);         \
+  }                                                                                     \
+  extern "C" RUNTIME_EXPORT int64_t prefix##_prefix(                                    \
+      const char* str, const int32_t str_len, const char* pat, const int32_t pat_len) { \
+    return str_len >= pat_len && like_bytes_equal<is_ilike>(str, pat, pat_len)          \
+               ? pat_len                                                                \
+               : -1;                                                                    \
+  }                                                                                     \
+  extern "C" RUNTIME_EXPORT int64_t prefix##_find(const char* str,                      \
+                                                  const int32_t str_len,                \
+                                                  const int64_t from,                   \
+                                                  const char* pat,                      \
+                                                  const int32_t pat_len) {              \
+    if (from < 0) {                                                                     \
+      return -1;                                                                        \
+    }                                                                                   \
+    const int32_t pos = like_find<is_ilike>(str, str_len, from, pat, pat_len);          \
+    return pos < 0 ? -1 : pos + pat_len;                                                \
+  }                                                                                     \
+  extern "C" RUNTIME_EXPORT bool prefix##_suffix(const char* str,                       \
+                                                 const int32_t str_len,                 \
+                                                 const int64_t from,                    \
+                                                 const char* pat,                       \
+                                                 const int32_t pat_len) {               \
+    return from >= 0 && str_len - from >= pat_len &&                                    \
+           like_bytes_equal<is_ilike>(str + str_len - pat_len, pat, pat_len);          \
+  }
+
+DEF_STRING_LIKE_SEGMENT_FUNCS(string_like, false)
+DEF_STRING_LIKE_SEGMENT_FUNCS(string_ilike, true)
+
+#undef DEF_STRING_LIKE_SEGMENT_FUNCS
+
 extern "C" RUNTIME_EXPORT int32_t StringCompare(const char* s1,
                                                 const int32_t s1_len,
                                                 const char* s2,
@@ -60,6 +60,57 @@ extern "C" RUNTIME_EXPORT bool string_ilike_simple(const char* str,
                                                    const char* pattern,
                                                    const int32_t pat_len);
 
+/*
+ * @brief segment kernels for LIKE patterns that only contain literals and '%'.
+ * prefix/find return the position right after the matched segment, or -1 when it is
+ * not found (or when from is already -1), so calls can be chained left to right.
+ * suffix checks that the string ends with pat and that it starts at or after from.
+ * ILIKE variants expect pat in lower case.
+ */
+extern "C" RUNTIME_EXPORT bool string_like_exact(const char* str,
+                                                 const int32_t str_len,
+                                                 const char* pat,
+                                                 const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT int64_t string_like_prefix(const char* str,
+                                                     const int32_t str_len,
+                                                     const char* pat,
+                                                     const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT int64_t string_like_find(const char* str,
+                                                   const int32_t str_len,
+                                                   const int64_t from,
+                                                   const char* pat,
+                                                   const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT bool string_like_suffix(const char* str,
+                                                  const int32_t str_len,
+                                                  const int64_t from,
+                                                  const char* pat,
+                                                  const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT bool string_ilike_exact(const char* str,
+                                                  const int32_t str_len,
+                                                  const char* pat,
+                                                  const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT int64_t string_ilike_prefix(const char* str,
+                                                      const int32_t str_len,
+                                                      const char* pat,
+                                                      const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT int64_t string_ilike_find(const char* str,
+                                                    const int32_t str_len,
+                                                    const int64_t from,
+                                                    const char* pat,
+                                                    const int32_t pat_len);
+
+extern "C" RUNTIME_EXPORT bool string_ilike_suffix(const char* str,
+                                                   const int32_t str_len,
+                                                   const int64_t from,
+                                                   const char* pat,
+                                                   const int32_t pat_len);
+
 extern "C" RUNTIME_EXPORT bool string_lt(const char* lhs,
                                          const int32_t lhs_len,
                                          const char* rhs,
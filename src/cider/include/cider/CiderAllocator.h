@@ -22,8 +22,12 @@
 #ifndef CIDER_ALLOCATOR_H
 #define CIDER_ALLOCATOR_H
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <string>
 
 #include "cider/CiderException.h"
 
@@ -52,11 +56,162 @@ using CiderAllocatorPtr = std::shared_ptr<CiderAllocator>;
 // use std::allocator<int8_t> as default allocator
 class CiderDefaultAllocator : public CiderAllocator {
  public:
-  int8_t* allocate(size_t size) final { return allocator_.allocate(size); }
-  void deallocate(int8_t* p, size_t size) final { allocator_.deallocate(p, size); }
+  int8_t* allocate(size_t size) final {
+    int8_t* p = allocator_.allocate(size);
+    usage_ += size;
+    return p;
+  }
+  void deallocate(int8_t* p, size_t size) final {
+    allocator_.deallocate(p, size);
+    usage_ -= size;
+  }
+  size_t getMemoryUsage() override { return usage_; }
 
  private:
   std::allocator<int8_t> allocator_{};
+  std::atomic<size_t> usage_{0};
+};
+
+// Allocator tracking the memory of a node in a hierarchy, e.g. query > operator > data
+// structure. Memory is allocated from the underlying allocator of the root, and counted
+// on the node and all its ancestors, each of which may have a limit. Memory can also be
+// reserved up front without allocation. Once a limit would be exceeded, the limit
+// callback of that node is called with the exceeding bytes, so that its owner can free
+// memory (e.g. by spilling) before CiderOutOfMemoryException is thrown.
+class CiderTrackingAllocator
+    : public CiderAllocator,
+      public std::enable_shared_from_this<CiderTrackingAllocator> {
+ public:
+  using LimitCallback = std::function<void(size_t exceeded_size)>;
+
+  explicit CiderTrackingAllocator(std::shared_ptr<CiderAllocator> allocator =
+                                      std::make_shared<CiderDefaultAllocator>(),
+                                  size_t limit = kMaxMemory)
+      : allocator_(std::move(allocator)), limit_(limit) {}
+
+  // Creates a child node counted on this one, it must be owned by a shared_ptr.
+  std::shared_ptr<CiderTrackingAllocator> addChild(size_t limit = kMaxMemory) {
+    auto child = std::make_shared<CiderTrackingAllocator>(allocator_, limit);
+    child->parent_ = shared_from_this();
+    return child;
+  }
+
+  int8_t* allocate(size_t size) final {
+    reserve(size);
+    try {
+      return allocator_->allocate(size);
+    } catch (...) {
+      release(size);
+      throw;
+    }
+  }
+
+  void deallocate(int8_t* p, size_t size) final {
+    allocator_->deallocate(p, size);
+    release(size);
+  }
+
+  int8_t* reallocate(int8_t* p, size_t size, size_t newSize) final {
+    if (newSize > size) {
+      reserve(newSize - size);
+    }
+    int8_t* newP = nullptr;
+    try {
+      newP = allocator_->reallocate(p, size, newSize);
+    } catch (...) {
+      if (newSize > size) {
+        release(newSize - size);
+      }
+      throw;
+    }
+    if (newSize < size) {
+      release(size - newSize);
+    }
+    return newP;
+  }
+
+  // Counts size bytes as used without allocating them, false if a limit is exceeded.
+  bool tryReserve(size_t size) {
+    size_t new_usage = 0;
+    if (!tryReserveLocal(size, new_usage)) {
+      if (!callback_) {
+        return false;
+      }
+      size_t usage = usage_.load();
+      callback_(usage + size > limit_ ? usage + size - limit_ : 0);
+      if (!tryReserveLocal(size, new_usage)) {
+        return false;
+      }
+    }
+    if (parent_ && !parent_->tryReserve(size)) {
+      usage_ -= size;
+      return false;
+    }
+    // Only reservations accepted by all ancestors count toward the peak.
+    size_t peak = peak_.load();
+    while (new_usage > peak && !peak_.compare_exchange_weak(peak, new_usage)) {
+    }
+    return true;
+  }
+
+  void reserve(size_t size) {
+    if (!tryReserve(size)) {
+      CIDER_THROW(CiderOutOfMemoryException,
+                  "Failed to reserve " + std::to_string(size) + " bytes, " +
+                      std::to_string(usage_.load()) + " of " + std::to_string(limit_) +
+                      " bytes are used.");
+    }
+  }
+
+  // Returns memory counted by allocate or reserve.
+  void release(size_t size) {
+    usage_ -= size;
+    if (parent_) {
+      parent_->release(size);
+    }
+  }
+
+  void setLimitCallback(const LimitCallback& callback) { callback_ = callback; }
+
+  size_t getLimit() const { return limit_; }
+
+  // Bytes which can still be reserved, bounded by the limits of all ancestors.
+  size_t getAvailable() const {
+    size_t usage = usage_.load();
+    size_t available = usage < limit_ ? limit_ - usage : 0;
+    return parent_ ? std::min(available, parent_->getAvailable()) : available;
+  }
+
+  // Most memory this node can hold now.
+  size_t getCap() override {
+    size_t available = getAvailable();
+    size_t usage = usage_.load();
+    return available > kMaxMemory - usage ? kMaxMemory : usage + available;
+  }
+
+  size_t getMemoryUsage() override { return usage_.load(); }
+
+  size_t getPeakMemoryUsage() const { return peak_.load(); }
+
+ private:
+  // Counts size bytes on this node only, new_usage is set to the usage after that.
+  bool tryReserveLocal(size_t size, size_t& new_usage) {
+    size_t usage = usage_.load();
+    do {
+      if (size > limit_ || usage > limit_ - size) {
+        return false;
+      }
+    } while (!usage_.compare_exchange_weak(usage, usage + size));
+    new_usage = usage + size;
+    return true;
+  }
+
+  std::shared_ptr<CiderAllocator> allocator_;
+  std::shared_ptr<CiderTrackingAllocator> parent_;
+  const size_t limit_;
+  std::atomic<size_t> usage_{0};
+  std::atomic<size_t> peak_{0};
+  LimitCallback callback_;
 };
 
 template <uint16_t ALIGNMENT = kNoAlignment>
@@ -100,6 +255,10 @@ class AlignAllocator : public CiderAllocator {
     }
   }
 
+  size_t getCap() override { return parent_->getCap(); }
+
+  size_t getMemoryUsage() override { return parent_->getMemoryUsage(); }
+
  private:
   int8_t* alignAddress(int8_t* p) const noexcept {
     // if p happen to aligned, return next aligned address.
@@ -190,6 +349,7 @@ class CiderArenaAllocator : public CiderAllocator {
     }
     auto result = head_->data.get() + head_->current_position;
     head_->current_position += len;
+    used_size_ += len;
     return result;
   }
 
@@ -204,16 +364,21 @@ class CiderArenaAllocator : public CiderAllocator {
   }
   size_t getCap() override { return total_capacity_; }
 
+  // Bytes handed out, while getCap() is the bytes held from parent.
+  size_t getMemoryUsage() override { return used_size_; }
+
   void destory() {
     head_ = nullptr;
     tail_ = nullptr;
     current_arena_capacity_ = ARENA_ALLOCATOR_INITIAL_CAPACITY;
     total_capacity_ = 0;
+    used_size_ = 0;
   }
 
  private:
   size_t current_arena_capacity_;
   size_t total_capacity_ = 0;
+  size_t used_size_ = 0;
   std::unique_ptr<ArenaChunk> head_;
   ArenaChunk* tail_;
   std::shared_ptr<CiderAllocator> parent_;
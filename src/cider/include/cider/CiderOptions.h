@@ -54,6 +54,7 @@ DECLARE_bool(allow_runtime_query_interrupt);
 DECLARE_double(running_query_interrupt_freq);
 DECLARE_uint64(pending_query_interrupt_freq);
 DECLARE_bool(force_direct_hash);
+DECLARE_uint64(groupby_buffer_memory_limit);
 
 // wrapper for Omnisci CompilationOptions
 struct CiderCompilationOption {
@@ -104,6 +105,7 @@ struct CiderExecutionOption {
   double running_query_interrupt_freq;
   unsigned pending_query_interrupt_freq;
   bool force_direct_hash;
+  size_t groupby_buffer_memory_limit;  // Group-by states beyond it are spilled to disk.
 
   static CiderExecutionOption defaults() {
     return CiderExecutionOption{FLAGS_output_columnar_hint,
@@ -120,7 +122,8 @@ struct CiderExecutionOption {
                                 FLAGS_allow_runtime_query_interrupt,
                                 FLAGS_running_query_interrupt_freq,
                                 (unsigned)FLAGS_pending_query_interrupt_freq,
-                                FLAGS_force_direct_hash};
+                                FLAGS_force_direct_hash,
+                                FLAGS_groupby_buffer_memory_limit};
   }
 
  private:
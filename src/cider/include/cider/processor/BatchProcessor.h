@@ -23,6 +23,7 @@
 #define CIDER_BATCH_PROCESSOR_H
 
 #include <memory>
+#include <vector>
 
 #include "cider/processor/BatchProcessorContext.h"
 #include "cider/processor/JoinHashTableBuilder.h"
@@ -53,6 +54,8 @@ class BatchProcessor : public std::enable_shared_from_this<BatchProcessor> {
                                 const struct ArrowSchema* schema = nullptr) = 0;
 
   /// Gets an output batch from the batchProcessor.  return null If no output data.
+  /// Results larger than the output batch size of context are returned over multiple
+  /// calls, the processor stays in kRunning state until the last one is returned.
   virtual void getResult(struct ArrowArray& array, struct ArrowSchema& schema) = 0;
 
   /// Notifies the batchProcessor that no more batch will be added and the
@@ -64,6 +67,17 @@ class BatchProcessor : public std::enable_shared_from_this<BatchProcessor> {
   virtual Type getProcessorType() const = 0;
 
   virtual void feedHashBuildTable(const std::shared_ptr<JoinHashTable>& hasTable) = 0;
+
+  /// Merges the aggregation states of finished partial processors created from the same
+  /// plan into this one, which then outputs the final result. Group-by states are split
+  /// by key hash and every partition is merged by one of threadNum threads.
+  virtual void mergePartialAggregation(
+      const std::vector<std::shared_ptr<BatchProcessor>>& partials,
+      size_t threadNum) = 0;
+
+  /// Gets the optimized IR of the compiled query for debugging, it's empty unless
+  /// keep_ir is set in DiagnosticsOptions of the context.
+  virtual std::string getIR() const = 0;
 };
 
 using BatchProcessorPtr = std::shared_ptr<BatchProcessor>;
@@ -25,26 +25,46 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 #include "cider/CiderAllocator.h"
+#include "cider/processor/JoinKeyFilter.h"
 
 namespace cider::exec::processor {
 
 class JoinHashTable {
  public:
+  virtual ~JoinHashTable() = default;
+
   /// merge other hashTable into this one
   virtual std::unique_ptr<JoinHashTable> merge(
       std::vector<std::unique_ptr<JoinHashTable>> otherTables) = 0;
+
+  /// filter of build keys for probe side, null if not available
+  virtual std::shared_ptr<const JoinKeyFilter> getKeyFilter() { return nullptr; }
 };
 
 struct HashBuildResult {
-  explicit HashBuildResult(std::shared_ptr<JoinHashTable> _table)
-      : table(std::move(_table)) {}
+  explicit HashBuildResult(std::shared_ptr<JoinHashTable> _table,
+                           std::shared_ptr<const JoinKeyFilter> _keyFilter = nullptr)
+      : table(std::move(_table)), keyFilter(std::move(_keyFilter)) {}
   std::shared_ptr<JoinHashTable> table;
+  /// could be pushed down to probe side scan as a dynamic filter
+  std::shared_ptr<const JoinKeyFilter> keyFilter;
 };
 
 using HashBuildTableSupplier = std::function<std::optional<HashBuildResult>()>;
 
+struct DiagnosticsOptions {
+  /// dump IR (before and after optimization) and ASM of the compiled query to files,
+  /// file names are unique for every query.
+  bool dump_ir{false};
+  /// directory of the dumped files, current working directory if empty.
+  std::string dump_dir;
+  /// keep optimized IR in memory, which can be retrieved by BatchProcessor::getIR().
+  bool keep_ir{false};
+};
+
 class BatchProcessorContext {
  public:
   explicit BatchProcessorContext(const std::shared_ptr<CiderAllocator>& allocator)
@@ -60,9 +80,92 @@ class BatchProcessorContext {
     return buildTableSupplier_;
   }
 
+  void setDiagnosticsOptions(const DiagnosticsOptions& diagnosticsOptions) {
+    diagnosticsOptions_ = diagnosticsOptions;
+  }
+
+  const DiagnosticsOptions& getDiagnosticsOptions() const { return diagnosticsOptions_; }
+
+  /// compile the query on a shared background thread pool, the processor stays in
+  /// kWaiting state until the compiled code is ready.
+  void setAsyncCompile(bool asyncCompile) { asyncCompile_ = asyncCompile; }
+
+  bool isAsyncCompile() const { return asyncCompile_; }
+
+  /// run a quickly compiled but unoptimized query first, and switch to the fully
+  /// optimized one compiled in background after tierUpBatchNum batches.
+  void setTieredCompile(bool tieredCompile) { tieredCompile_ = tieredCompile; }
+
+  bool isTieredCompile() const { return tieredCompile_; }
+
+  void setTierUpBatchNum(size_t tierUpBatchNum) { tierUpBatchNum_ = tierUpBatchNum; }
+
+  size_t getTierUpBatchNum() const { return tierUpBatchNum_; }
+
+  /// directory to persist compiled objects, so that other processes compiling the same
+  /// query can skip machine code generation. Disabled if empty.
+  void setObjectCacheDir(const std::string& objectCacheDir) {
+    objectCacheDir_ = objectCacheDir;
+  }
+
+  const std::string& getObjectCacheDir() const { return objectCacheDir_; }
+
+  /// generate code processing input a block of 64 rows at a time, see
+  /// nextgen::context::CodegenOptions::enable_block_codegen.
+  void setBlockCodegen(bool blockCodegen) { blockCodegen_ = blockCodegen; }
+
+  bool isBlockCodegen() const { return blockCodegen_; }
+
+  /// forward input columns to output without copying them in generated code, they are
+  /// gathered by a selection vector, or moved if all rows are selected, in getResult.
+  void setLateMaterialization(bool lateMaterialization) {
+    lateMaterialization_ = lateMaterialization;
+  }
+
+  bool isLateMaterialization() const { return lateMaterialization_; }
+
+  /// keep aggregation states in the processor instead of emitting them in getResult,
+  /// they are combined by a final processor, see BatchProcessor::mergePartialAggregation.
+  void setPartialAggregation(bool partialAggregation) {
+    partialAggregation_ = partialAggregation;
+  }
+
+  bool isPartialAggregation() const { return partialAggregation_; }
+
+  /// bound every batch returned by getResult to about this many rows and bytes, large
+  /// aggregation results are streamed over multiple calls. 0 means unbounded.
+  void setOutputBatchRows(size_t outputBatchRows) { outputBatchRows_ = outputBatchRows; }
+
+  size_t getOutputBatchRows() const { return outputBatchRows_; }
+
+  void setOutputBatchBytes(size_t outputBatchBytes) {
+    outputBatchBytes_ = outputBatchBytes;
+  }
+
+  size_t getOutputBatchBytes() const { return outputBatchBytes_; }
+
+  /// spill sorted runs of ORDER BY to disk once the buffered rows take more than this
+  /// many bytes, they are merged when results are fetched. 0 means never spill.
+  void setSortSpillThreshold(size_t sortSpillThreshold) {
+    sortSpillThreshold_ = sortSpillThreshold;
+  }
+
+  size_t getSortSpillThreshold() const { return sortSpillThreshold_; }
+
  private:
   std::shared_ptr<CiderAllocator> allocator_;
   HashBuildTableSupplier buildTableSupplier_;
+  DiagnosticsOptions diagnosticsOptions_;
+  bool asyncCompile_{false};
+  bool tieredCompile_{false};
+  size_t tierUpBatchNum_{8};
+  std::string objectCacheDir_;
+  bool blockCodegen_{false};
+  bool lateMaterialization_{false};
+  bool partialAggregation_{false};
+  size_t outputBatchRows_{0};
+  size_t outputBatchBytes_{0};
+  size_t sortSpillThreshold_{0};
 };
 
 using BatchProcessorContextPtr = std::shared_ptr<BatchProcessorContext>;
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CIDER_JOIN_KEY_FILTER_H
+#define CIDER_JOIN_KEY_FILTER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cider::exec::processor {
+
+/// Summary of the integer keys of a hash join build side. Probe rows whose key is out of
+/// [min, max] or rejected by the bloom filter never match, so they can be dropped before
+/// the hash table lookup.
+class JoinKeyFilter {
+ public:
+  /// The blocked bloom filter sets kHashNum bits in a single 64-bit block per key, about
+  /// kBitsPerKey bits are reserved for each key.
+  static constexpr int kHashNum = 3;
+  static constexpr size_t kBitsPerKey = 8;
+
+  explicit JoinKeyFilter(size_t keyNum) {
+    size_t blockNum = 1;
+    while (blockNum * 64 < keyNum * kBitsPerKey) {
+      blockNum <<= 1;
+    }
+    blocks_.resize(blockNum, 0);
+  }
+
+  void insert(int64_t key) {
+    min_ = std::min(min_, key);
+    max_ = std::max(max_, key);
+    uint64_t hash = mix(key);
+    blocks_[blockIndex(hash)] |= blockMask(hash);
+  }
+
+  /// False positives are possible, false negatives are not.
+  bool mayContain(int64_t key) const {
+    if (key < min_ || key > max_) {
+      return false;
+    }
+    uint64_t hash = mix(key);
+    uint64_t mask = blockMask(hash);
+    return (blocks_[blockIndex(hash)] & mask) == mask;
+  }
+
+  /// Unions keys of other, which must be created with the same key number.
+  void merge(const JoinKeyFilter& other) {
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      blocks_[i] |= other.blocks_[i];
+    }
+  }
+
+  bool empty() const { return min_ > max_; }
+
+  int64_t min() const { return min_; }
+
+  int64_t max() const { return max_; }
+
+ private:
+  static uint64_t mix(int64_t key) {
+    uint64_t hash = static_cast<uint64_t>(key);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  // high bits select the block, low bits select the bits in it
+  size_t blockIndex(uint64_t hash) const { return (hash >> 32) & (blocks_.size() - 1); }
+
+  static uint64_t blockMask(uint64_t hash) {
+    uint64_t mask = 0;
+    for (int i = 0; i < kHashNum; ++i) {
+      mask |= uint64_t(1) << ((hash >> (i * 6)) & 63);
+    }
+    return mask;
+  }
+
+  int64_t min_{std::numeric_limits<int64_t>::max()};
+  int64_t max_{std::numeric_limits<int64_t>::min()};
+  std::vector<uint64_t> blocks_;
+};
+
+}  // namespace cider::exec::processor
+
+#endif  // CIDER_JOIN_KEY_FILTER_H
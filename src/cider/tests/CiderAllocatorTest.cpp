@@ -40,6 +40,7 @@ TEST_F(CiderAllocatorTest, ArenaAllocator) {
 
   int8_t* ptr1 = allocator->allocate(1000);
   EXPECT_EQ(allocator->getCap(), 4096);
+  EXPECT_EQ(allocator->getMemoryUsage(), 1000);
   int8_t* ptr2 = allocator->allocate(1000);
   EXPECT_EQ(allocator->getCap(), 4096);
   int8_t* ptr3 = allocator->allocate(4000);
@@ -52,6 +53,43 @@ TEST_F(CiderAllocatorTest, ArenaAllocator) {
   allocator = nullptr;
 }
 
+TEST_F(CiderAllocatorTest, TrackingAllocator) {
+  auto query = std::make_shared<CiderTrackingAllocator>(
+      std::make_shared<CiderDefaultAllocator>(), 1000);
+  auto agg = query->addChild(800);
+  auto join = query->addChild();
+
+  int8_t* p1 = agg->allocate(500);
+  EXPECT_EQ(agg->getMemoryUsage(), 500);
+  EXPECT_EQ(query->getMemoryUsage(), 500);
+  EXPECT_EQ(agg->getAvailable(), 300);
+  EXPECT_EQ(join->getAvailable(), 500);
+
+  // exceeds the limit of agg, and then the limit of query
+  EXPECT_THROW(agg->allocate(400), CiderOutOfMemoryException);
+  EXPECT_TRUE(join->tryReserve(400));
+  EXPECT_FALSE(join->tryReserve(200));
+  EXPECT_EQ(query->getMemoryUsage(), 900);
+  // rejected by query, so the peak of join isn't raised
+  EXPECT_EQ(join->getPeakMemoryUsage(), 400);
+
+  // callback frees memory, so that the allocation succeeds
+  query->setLimitCallback([&](size_t exceeded) {
+    EXPECT_EQ(exceeded, 100);
+    agg->deallocate(p1, 500);
+    p1 = nullptr;
+  });
+  int8_t* p2 = join->allocate(200);
+  EXPECT_EQ(p1, nullptr);
+  EXPECT_EQ(agg->getMemoryUsage(), 0);
+  EXPECT_EQ(join->getMemoryUsage(), 600);
+  EXPECT_EQ(query->getPeakMemoryUsage(), 900);
+
+  join->deallocate(p2, 200);
+  join->release(400);
+  EXPECT_EQ(query->getMemoryUsage(), 0);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -23,6 +23,8 @@
 #include <gtest/gtest.h>
 #include "TestHelpers.h"
 #include "common/hashtable/FixedHashMap.h"
+#include "exec/nextgen/context/AggStateMerger.h"
+#include "exec/nextgen/context/GroupByHashTable.h"
 
 using namespace TestHelpers;
 
@@ -191,6 +193,126 @@ TEST_F(CiderNewHashTableTest, hashTableTest) {
   CHECK_EQ(fht.contains(key), false);
 }
 
+TEST_F(CiderNewHashTableTest, aggStateStoreTest) {
+  using cider::exec::nextgen::context::Int16AggStateStore;
+  using cider::exec::nextgen::context::Int64AggStateStore;
+
+  std::vector<int64_t> states(1000);
+  size_t created = 0;
+  auto create = [&](auto) { return reinterpret_cast<int8_t*>(&states[created++]); };
+
+  Int16AggStateStore int16_store;
+  for (uint16_t key = 0; key < 10; ++key) {
+    *reinterpret_cast<int64_t*>(int16_store.findOrInsert(key, create)) += key;
+    *reinterpret_cast<int64_t*>(int16_store.findOrInsert(key, create)) += key;
+  }
+  EXPECT_EQ(int16_store.size(), 10);
+  EXPECT_EQ(created, 10);
+  EXPECT_EQ(states[9], 18);
+
+  Int64AggStateStore int64_store;
+  for (uint64_t i = 0; i < 600; ++i) {
+    *reinterpret_cast<int64_t*>(int64_store.findOrInsert(i % 300, create)) += 1;
+  }
+  EXPECT_EQ(int64_store.size(), 300);
+  EXPECT_EQ(created, 310);
+  EXPECT_EQ(states[309], 2);
+}
+
+TEST_F(CiderNewHashTableTest, groupByHashTableSingleKeyTest) {
+  using cider::exec::nextgen::context::GroupByHashTable;
+
+  const std::vector<int8_t> init_state(sizeof(int64_t), 0);
+  for (size_t width : {1, 2, 8}) {
+    GroupByHashTable generic(1, init_state, allocator);
+    GroupByHashTable single(1, init_state, allocator, width);
+
+    // Keys -3 ~ 3 and null, each one appears 4 times.
+    for (int64_t i = 0; i < 32; ++i) {
+      int64_t key = i % 8 - 4;
+      bool is_null = key == -4;
+      int64_t slot = 0;
+      memcpy(&slot, &key, width);
+      for (auto table : {&generic, &single}) {
+        table->setFixedKey(0, slot, is_null);
+        *reinterpret_cast<int64_t*>(table->findOrInsert()) += 1;
+      }
+    }
+    EXPECT_EQ(generic.getEntryNum(), 8);
+    ASSERT_EQ(single.getEntryNum(), 8);
+    for (size_t i = 0; i < single.getEntryNum(); ++i) {
+      EXPECT_EQ(*reinterpret_cast<int64_t*>(single.getEntryState(i)), 4);
+    }
+  }
+}
+
+TEST_F(CiderNewHashTableTest, groupByHashTableTrackingTest) {
+  using cider::exec::nextgen::context::GroupByHashTable;
+
+  const std::vector<int8_t> init_state(sizeof(int64_t), 0);
+  auto tracker = std::make_shared<CiderTrackingAllocator>(
+      std::make_shared<CiderDefaultAllocator>(), 64 * 1024);
+  {
+    // The 65536 cells of the 16-bit store alone exceed the limit.
+    EXPECT_THROW(GroupByHashTable(1, init_state, tracker, 2), CiderOutOfMemoryException);
+    EXPECT_EQ(tracker->getMemoryUsage(), 0);
+
+    GroupByHashTable table(1, init_state, tracker, 8, 16);
+    size_t initial_usage = tracker->getMemoryUsage();
+    EXPECT_GT(initial_usage, 0);
+    // Slots and store cells grow until the limit is exceeded.
+    EXPECT_THROW(
+        for (int64_t key = 0; key < 64 * 1024; ++key) {
+          table.setFixedKey(0, key, false);
+          table.findOrInsert();
+        },
+        CiderOutOfMemoryException);
+    EXPECT_GT(tracker->getPeakMemoryUsage(), initial_usage);
+  }
+  EXPECT_EQ(tracker->getMemoryUsage(), 0);
+}
+
+TEST_F(CiderNewHashTableTest, mergeGroupByHashTablesTrackingTest) {
+  using namespace cider::exec::nextgen::context;
+
+  // SUM(BIGINT) state: value followed by the null flag.
+  AggExprsInfoVector info{
+      AggExprsInfo(SQLTypeInfo(kBIGINT), SQLTypeInfo(kBIGINT), SQLAgg::kSUM, false)};
+  info[0].null_offset_ = sizeof(int64_t);
+  std::vector<int8_t> init_state(2 * sizeof(int64_t), 0);
+  init_state[sizeof(int64_t)] = 1;
+
+  std::vector<GroupByHashTablePtr> partials;
+  for (int i = 0; i < 2; ++i) {
+    partials.emplace_back(std::make_unique<GroupByHashTable>(1, init_state, allocator));
+    for (int64_t key = 0; key < 10000; ++key) {
+      partials.back()->setFixedKey(0, key, false);
+      int8_t* state = partials.back()->findOrInsert();
+      *reinterpret_cast<int64_t*>(state) += key;
+      state[sizeof(int64_t)] = 0;
+    }
+  }
+  std::vector<const GroupByHashTable*> tables{partials[0].get(), partials[1].get()};
+
+  // Merge threads run out of memory, which is rethrown to the caller.
+  auto tracker = std::make_shared<CiderTrackingAllocator>(
+      std::make_shared<CiderDefaultAllocator>(), 64 * 1024);
+  EXPECT_THROW(mergeGroupByHashTables(tables, info, tracker, 4),
+               CiderOutOfMemoryException);
+  EXPECT_EQ(tracker->getMemoryUsage(), 0);
+
+  auto merged = mergeGroupByHashTables(tables, info, allocator, 4);
+  size_t entry_num = 0;
+  for (auto& table : merged) {
+    entry_num += table->getEntryNum();
+    for (size_t i = 0; i < table->getEntryNum(); ++i) {
+      int64_t key = table->getKeySlot(table->getEntryKey(i), 0);
+      EXPECT_EQ(*reinterpret_cast<int64_t*>(table->getEntryState(i)), key * 2);
+    }
+  }
+  EXPECT_EQ(entry_num, 10000);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <random>
+
+#include "exec/nextgen/context/GroupByHashTable.h"
+#include "tests/utils/CiderBenchmarkRunner.h"
+
+#include "CiderBenchmarkBase.h"
+
+using cider::exec::nextgen::context::GroupByHashTable;
+
+// Old engine, aggregation states are kept in CiderAggHashTable. Keys of genBatch() are
+// random in [-1000000, 1000000], so nearly every row is a new group.
+class CiderGroupByBenchmark : public CiderBenchmarkBaseFixture {
+ public:
+  CiderGroupByBenchmark() {
+    runner.prepare(
+        "CREATE TABLE test(col_1 INTEGER, col_2 BIGINT, col_3 FLOAT, col_4 DOUBLE, "
+        "col_5 INTEGER, col_6 BIGINT, col_7 FLOAT, col_8 DOUBLE);");
+  }
+
+  std::shared_ptr<CiderBatch> input_batch;
+};
+
+char* sql_groupby_long("SELECT col_2, SUM(col_1) FROM test GROUP BY col_2");
+GEN_BENCHMARK(CiderGroupByBenchmark, 10000, CiderAggHashTable, sql_groupby_long, 0)
+GEN_BENCHMARK(CiderGroupByBenchmark, 100000, CiderAggHashTable, sql_groupby_long, 0)
+
+// Nextgen engine, states of one SUM(BIGINT) are kept in GroupByHashTable.
+std::vector<int64_t> genKeys(size_t row_num) {
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> dist(-1000'000, 1000'000);
+  std::vector<int64_t> keys(row_num);
+  for (auto& key : keys) {
+    key = dist(rng);
+  }
+  return keys;
+}
+
+// single_key_width 0 takes the normalized key path, 8 the AggStateStore path.
+template <size_t single_key_width>
+void bench_groupby_hash_table(benchmark::State& state) {
+  auto keys = genKeys(state.range(0));
+  const std::vector<int8_t> init_state(sizeof(int64_t), 0);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  for (auto _ : state) {
+    GroupByHashTable table(1, init_state, allocator, single_key_width);
+    for (auto key : keys) {
+      table.setFixedKey(0, key, false);
+      *reinterpret_cast<int64_t*>(table.findOrInsert()) += key;
+    }
+    benchmark::DoNotOptimize(table.getEntryNum());
+  }
+}
+
+BENCHMARK_TEMPLATE(bench_groupby_hash_table, 0)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(bench_groupby_hash_table, 8)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -20,7 +20,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <unordered_map>
 #include "QueryArrowDataGenerator.h"
+#include "cider/batch/ScalarBatch.h"
 #include "tests/utils/CiderTestBase.h"
 
 class CiderGroupByVarcharArrowTest : public CiderTestBase {
@@ -1318,6 +1320,74 @@ WHERE_GROUP_BY_TEST_UNIT(CiderGroupByIntegerTest, whereIntegerGroupByTest)
 WHERE_AND_HAVING_GROUP_BY_TEST_UNIT(CiderGroupByIntegerTest,
                                     whereAndHavingIntegerGroupByTest)
 
+// Runs a group-by query under a buffer memory limit and collects all output batches.
+class CiderGroupBySpillRunner : public CiderQueryRunner {
+ public:
+  std::vector<std::unique_ptr<CiderBatch>> runQuery(
+      const std::string& sql,
+      const std::shared_ptr<CiderBatch>& input_batch,
+      size_t buffer_memory_limit) {
+    auto plan = genSubstraitPlan(sql);
+    compile_option.use_cider_data_format = true;
+    exe_option.groupby_buffer_memory_limit = buffer_memory_limit;
+    auto compile_res = ciderCompileModule_->compile(plan, compile_option, exe_option);
+    CiderRuntimeModule runtime_module(compile_res, compile_option, exe_option);
+    runtime_module.processNextBatch(*input_batch);
+
+    std::vector<std::unique_ptr<CiderBatch>> output_batches;
+    auto has_more_output = CiderRuntimeModule::kMoreOutput;
+    while (has_more_output == CiderRuntimeModule::kMoreOutput) {
+      std::unique_ptr<CiderBatch> output_batch;
+      std::tie(has_more_output, output_batch) = runtime_module.fetchResults(1024);
+      output_batches.push_back(std::move(output_batch));
+    }
+    return output_batches;
+  }
+};
+
+TEST(CiderGroupBySpillTest, spillTest) {
+  const size_t row_num = 50000;
+  ArrowSchema* schema = nullptr;
+  ArrowArray* array = nullptr;
+  QueryArrowDataGenerator::generateBatchByTypes(
+      schema,
+      array,
+      row_num,
+      {"col_a", "col_b"},
+      {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)},
+      {0, 0},
+      GeneratePattern::Random,
+      0,
+      100000);
+
+  std::unordered_map<int64_t, int64_t> expected_sums;
+  auto keys = reinterpret_cast<const int64_t*>(array->children[0]->buffers[1]);
+  auto values = reinterpret_cast<const int64_t*>(array->children[1]->buffers[1]);
+  for (size_t i = 0; i < row_num; ++i) {
+    expected_sums[keys[i]] += values[i];
+  }
+  auto input_batch = std::make_shared<CiderBatch>(
+      schema, array, std::make_shared<CiderDefaultAllocator>());
+
+  CiderGroupBySpillRunner runner;
+  runner.prepare("CREATE TABLE test(col_a BIGINT NOT NULL, col_b BIGINT NOT NULL);");
+  // 64KB holds 2048 groups, less than the groups of a spill partition, so partitions
+  // are spilled again while re-aggregating.
+  auto output_batches = runner.runQuery(
+      "SELECT col_a, SUM(col_b) FROM test GROUP BY col_a", input_batch, 64 * 1024);
+  EXPECT_GT(output_batches.size(), 1);
+
+  std::unordered_map<int64_t, int64_t> actual_sums;
+  for (auto& output_batch : output_batches) {
+    auto out_keys = output_batch->getChildAt(0)->as<ScalarBatch<int64_t>>()->getRawData();
+    auto out_sums = output_batch->getChildAt(1)->as<ScalarBatch<int64_t>>()->getRawData();
+    for (int64_t i = 0; i < output_batch->getLength(); ++i) {
+      EXPECT_TRUE(actual_sums.emplace(out_keys[i], out_sums[i]).second);
+    }
+  }
+  EXPECT_EQ(actual_sums, expected_sums);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   logger::LogOptions log_options(argv[0]);
@@ -27,6 +27,7 @@
 #include <unordered_map>
 #include <vector>
 #include "exec/operator/join/CiderF14HashTable.h"
+#include "exec/operator/join/CiderJoinHashTable.h"
 #include "exec/operator/join/CiderLinearProbingHashTable.h"
 #include "exec/operator/join/CiderStdUnorderedHashTable.h"
 #include "util/Logger.h"
@@ -138,6 +139,41 @@ TEST(CiderHashTableTest, keyCollisionTest) {
   }
 }
 
+TEST(CiderHashTableTest, joinProbeHashTableTest) {
+  // collided hash, duplicate keys and growth from the smallest table
+  cider_hashtable::JoinProbeHashTable<int, int, Hash, Equal> hm;
+  StdMapDuplicateKeyWrapper<int, int> dup_map;
+  for (int i = 0; i < 10000; i++) {
+    int key = random(-1000, 1000);
+    int value = random(-1000, 1000);
+    hm.insert(key, value);
+    dup_map.insert(std::move(key), std::move(value));
+  }
+  EXPECT_EQ(hm.size(), 10000);
+  EXPECT_EQ(hm.key_count(), dup_map.getMap().size());
+
+  std::vector<int> keys;
+  for (auto key_iter : dup_map.getMap()) {
+    keys.push_back(key_iter.first);
+  }
+  keys.push_back(2000);
+  std::vector<uint32_t> first(keys.size());
+  hm.find_many(keys.data(), keys.size(), first.data());
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto dup_res_vec = dup_map.find(keys[i]);
+    EXPECT_EQ(first[i], hm.find_first(keys[i]));
+    std::vector<int> hm_res_vec;
+    for (auto entry = first[i]; entry != hm.npos; entry = hm.find_next(entry)) {
+      hm_res_vec.push_back(hm.value_at(entry));
+    }
+    std::sort(dup_res_vec.begin(), dup_res_vec.end());
+    std::sort(hm_res_vec.begin(), hm_res_vec.end());
+    EXPECT_TRUE(std::equal(
+        dup_res_vec.begin(), dup_res_vec.end(), hm_res_vec.begin(), hm_res_vec.end()));
+  }
+}
+
 TEST(CiderHashTableTest, randomInsertAndfindTest) {
   // Create a LinearProbeHashTable  with 16 buckets and 0 as the empty key
   cider_hashtable::LinearProbeHashTable<int, int, MurmurHash, Equal> hm(16, NULL);
@@ -61,7 +61,7 @@ void check_array(ArrowArray* array, size_t expect_len, std::vector<TYPE> expect_
   EXPECT_EQ(array->length, expect_len);
   TYPE* data_buffer = (TYPE*)array->buffers[1];
   for (size_t i = 0; i < expect_len; ++i) {
-    EXPECT_EQ(data_buffer[0], expect_values[0]);
+    EXPECT_EQ(data_buffer[i], expect_values[i]);
   }
 }
 
@@ -188,6 +188,252 @@ TEST_F(NonGroupbyAggTest, TestResultSumInt64Nullable) {
                              {22, 1293});
 }
 
+TEST_F(NonGroupbyAggTest, TestResultMinMaxInt32Nullable) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int32_t>(
+              "a",
+              CREATE_SUBSTRAIT_TYPE(I32),
+              {-9, 2, 3, 1, 2, 4, 1, 2, 3, 4},
+              {true, false, false, false, false, false, false, false, false, false})
+          .addColumn<int32_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I32), {1, 11, 111, 2, 22, 222, 3, 33, 333, 555})
+          .build();
+
+  executeTestResult<int32_t>("CREATE TABLE test(a INT, b INT);",
+                             "select min(a), max(b) from test",
+                             input_data,
+                             {1, 555});
+}
+
+TEST_F(NonGroupbyAggTest, TestResultMinMaxInt64NotNull) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(4)
+          .addColumn<int64_t>("a", CREATE_SUBSTRAIT_TYPE(I64), {5, -3, 8, 2})
+          .addColumn<int64_t>("b", CREATE_SUBSTRAIT_TYPE(I64), {5, -3, 8, 2})
+          .build();
+
+  executeTestResult<int64_t>("CREATE TABLE test(a BIGINT NOT NULL, b BIGINT NOT NULL);",
+                             "select min(a), max(b) from test",
+                             input_data,
+                             {-3, 8});
+}
+
+TEST_F(NonGroupbyAggTest, TestResultMinMaxNotNullZeroRows) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] = input_builder.setRowNum(0)
+                             .addColumn<int64_t>("a", CREATE_SUBSTRAIT_TYPE(I64), {})
+                             .addColumn<int64_t>("b", CREATE_SUBSTRAIT_TYPE(I64), {})
+                             .build();
+
+  auto runtime_ctx = executeAndReturnRuntimeCtx(
+      "CREATE TABLE test(a BIGINT NOT NULL, b BIGINT NOT NULL);",
+      "select min(a), max(b) from test",
+      input_data);
+  // no type sentinel leaks out, MIN/MAX over zero rows are null
+  auto output_batch_array = runtime_ctx->getNonGroupByAggOutputBatch()->getArray();
+  EXPECT_EQ(output_batch_array->length, 1);
+  ASSERT_EQ(output_batch_array->n_children, 2);
+  for (size_t i = 0; i < output_batch_array->n_children; i++) {
+    auto child = output_batch_array->children[i];
+    EXPECT_EQ(child->null_count, 1);
+    auto null_buffer = reinterpret_cast<const uint8_t*>(child->buffers[0]);
+    EXPECT_FALSE(CiderBitUtils::isBitSetAt(null_buffer, 0));
+  }
+}
+
+TEST_F(NonGroupbyAggTest, TestResultAvgDouble) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(4)
+          .addColumn<double>("a",
+                             CREATE_SUBSTRAIT_TYPE(Fp64),
+                             {1.5, 100.0, 2.5, 3.5},
+                             {false, true, false, false})
+          .build();
+
+  executeTestResult<double>(
+      "CREATE TABLE test(a DOUBLE);", "select avg(a) from test", input_data, {2.5});
+}
+
+TEST_F(NonGroupbyAggTest, TestResultCount) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int64_t>(
+              "a",
+              CREATE_SUBSTRAIT_TYPE(I64),
+              {1, 2, 3, 1, 2, 4, 1, 2, 3, 4},
+              {true, false, false, false, false, false, false, false, false, true})
+          .build();
+
+  executeTestResult<int64_t>("CREATE TABLE test(a BIGINT);",
+                             "select count(*), count(a), count(distinct a) from test",
+                             input_data,
+                             {10, 8, 4});
+}
+
+class GroupbyAggTest : public ::testing::Test {
+ public:
+  // Groups are output in the order of first appearance. The targets are a key and an
+  // aggregation, placed at key_column and agg_column.
+  template <typename KEY_TYPE, typename AGG_TYPE>
+  void executeTestResult(const std::string& create_ddl,
+                         const std::string& sql,
+                         ArrowArray* array,
+                         std::vector<KEY_TYPE> keys,
+                         std::vector<bool> key_nulls,
+                         std::vector<AGG_TYPE> res,
+                         size_t key_column = 0,
+                         size_t agg_column = 1) {
+    auto runtime_ctx = executeAndReturnRuntimeCtx(create_ddl, sql, array);
+
+    auto output_batch_array = runtime_ctx->getGroupByAggOutputBatch()->getArray();
+    EXPECT_EQ(output_batch_array->length, keys.size());
+    EXPECT_EQ(output_batch_array->n_children, 2);
+
+    auto key_array = output_batch_array->children[key_column];
+    auto key_null_buffer = reinterpret_cast<const uint8_t*>(key_array->buffers[0]);
+    auto key_buffer = reinterpret_cast<const KEY_TYPE*>(key_array->buffers[1]);
+    auto agg_buffer = reinterpret_cast<const AGG_TYPE*>(
+        output_batch_array->children[agg_column]->buffers[1]);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      EXPECT_EQ(!CiderBitUtils::isBitSetAt(key_null_buffer, i), key_nulls[i]);
+      if (!key_nulls[i]) {
+        EXPECT_EQ(key_buffer[i], keys[i]);
+      }
+      EXPECT_EQ(agg_buffer[i], res[i]);
+    }
+  }
+};
+
+TEST_F(GroupbyAggTest, TestResultSumInt64NotNullKey) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int64_t>(
+              "a", CREATE_SUBSTRAIT_TYPE(I64), {1, 2, 3, 1, 2, 4, 1, 2, 3, 4})
+          .addColumn<int64_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I64), {1, 11, 111, 2, 22, 222, 3, 33, 333, 555})
+          .build();
+
+  executeTestResult<int64_t, int64_t>(
+      "CREATE TABLE test(a BIGINT NOT NULL, b BIGINT NOT NULL);",
+      "select a, sum(b) from test group by a",
+      input_data,
+      {1, 2, 3, 4},
+      {false, false, false, false},
+      {6, 66, 444, 777});
+}
+
+TEST_F(GroupbyAggTest, TestResultSumInt32NullableKey) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int32_t>(
+              "a",
+              CREATE_SUBSTRAIT_TYPE(I32),
+              {1, 2, 3, 1, 2, 4, 1, 2, 3, 4},
+              {false, true, false, false, true, false, false, false, false, false})
+          .addColumn<int64_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I64), {1, 11, 111, 2, 22, 222, 3, 33, 333, 555})
+          .build();
+
+  executeTestResult<int32_t, int64_t>(
+      "CREATE TABLE test(a INT, b BIGINT NOT NULL);",
+      "select a, sum(b) from test group by a",
+      input_data,
+      {1, 0, 3, 4, 2},
+      {false, true, false, false, false},
+      {6, 33, 444, 777, 33});
+}
+
+TEST_F(GroupbyAggTest, TestResultCountDistinct) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int64_t>(
+              "a", CREATE_SUBSTRAIT_TYPE(I64), {1, 2, 1, 1, 2, 2, 1, 2, 3, 3})
+          .addColumn<int64_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I64), {1, 1, 2, 1, 1, 5, 3, 1, 7, 7})
+          .build();
+
+  executeTestResult<int64_t, int64_t>(
+      "CREATE TABLE test(a BIGINT NOT NULL, b BIGINT NOT NULL);",
+      "select a, count(distinct b) from test group by a",
+      input_data,
+      {1, 2, 3},
+      {false, false, false},
+      {3, 2, 1});
+}
+
+TEST_F(GroupbyAggTest, TestResultAggBeforeKey) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int64_t>(
+              "a", CREATE_SUBSTRAIT_TYPE(I64), {1, 2, 3, 1, 2, 4, 1, 2, 3, 4})
+          .addColumn<int64_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I64), {1, 11, 111, 2, 22, 222, 3, 33, 333, 555})
+          .build();
+
+  executeTestResult<int64_t, int64_t>(
+      "CREATE TABLE test(a BIGINT NOT NULL, b BIGINT NOT NULL);",
+      "select sum(b), a from test group by a",
+      input_data,
+      {1, 2, 3, 4},
+      {false, false, false, false},
+      {6, 66, 444, 777},
+      1,
+      0);
+}
+
+TEST_F(GroupbyAggTest, TestResultExprOverKey) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int64_t>(
+              "a",
+              CREATE_SUBSTRAIT_TYPE(I64),
+              {1, 2, 3, 1, 2, 4, 1, 2, 3, 4},
+              {false, true, false, false, true, false, false, false, false, false})
+          .addColumn<int64_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I64), {1, 11, 111, 2, 22, 222, 3, 33, 333, 555})
+          .build();
+
+  executeTestResult<int64_t, int64_t>(
+      "CREATE TABLE test(a BIGINT, b BIGINT NOT NULL);",
+      "select a + 10, sum(b) from test group by a",
+      input_data,
+      {11, 0, 13, 14, 12},
+      {false, true, false, false, false},
+      {6, 33, 444, 777, 33});
+}
+
+TEST_F(GroupbyAggTest, TestResultKeyNotInTargets) {
+  auto input_builder = ArrowArrayBuilder();
+  auto [_, input_data] =
+      input_builder.setRowNum(10)
+          .addColumn<int64_t>(
+              "a", CREATE_SUBSTRAIT_TYPE(I64), {1, 2, 3, 1, 2, 4, 1, 2, 3, 4})
+          .addColumn<int64_t>(
+              "b", CREATE_SUBSTRAIT_TYPE(I64), {1, 11, 111, 2, 22, 222, 3, 33, 333, 555})
+          .build();
+
+  auto runtime_ctx = executeAndReturnRuntimeCtx(
+      "CREATE TABLE test(a BIGINT NOT NULL, b BIGINT NOT NULL);",
+      "select sum(b), count(b), a * 2, sum(b) from test group by a",
+      input_data);
+  auto output_batch_array = runtime_ctx->getGroupByAggOutputBatch()->getArray();
+  ASSERT_EQ(output_batch_array->n_children, 4);
+  check_array<int64_t>(output_batch_array->children[0], 4, {6, 66, 444, 777});
+  check_array<int64_t>(output_batch_array->children[1], 4, {3, 3, 2, 2});
+  check_array<int64_t>(output_batch_array->children[2], 4, {2, 4, 6, 8});
+  check_array<int64_t>(output_batch_array->children[3], 4, {6, 66, 444, 777});
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -22,6 +22,7 @@
 #include <google/protobuf/util/json_util.h>
 #include <gtest/gtest.h>
 
+#include "exec/nextgen/context/InValuesSet.h"
 #include "exec/nextgen/context/RuntimeContext.h"
 #include "exec/nextgen/jitlib/JITLib.h"
 #include "exec/operator/join/CiderLinearProbingHashTable.h"
@@ -160,14 +161,12 @@ TEST_F(ContextTests, RegisterHashTableTest) {
   StdMapDuplicateKeyWrapper<int, std::pair<Batch*, int>> dup_map;
 
   Batch build_batch(*schema, *array);
-  cider_hashtable::
-      LinearProbeHashTable<int, std::pair<Batch*, int64_t>, murmurHash, Equal>
-          hm(16, 0);
+  PartitionedJoinHashMap hm;
   auto batch = new Batch(build_batch);
   for (int i = 0; i < 10; i++) {
     int key = *(
         (reinterpret_cast<int*>(const_cast<void*>(array->children[1]->buffers[1]))) + i);
-    hm.insert(key, std::make_pair(batch, i));
+    hm.getPartitionTable(0).insert(key, std::make_pair(batch, i));
     dup_map.insert(std::move(key), std::make_pair(batch, i));
   }
 
@@ -180,10 +179,9 @@ TEST_F(ContextTests, RegisterHashTableTest) {
   EXPECT_EQ(runtime_ctx->getContextItemNum(), 1);
   EXPECT_NE(runtime_ctx->getContextItem(0), nullptr);
 
-  auto hash_table = reinterpret_cast<
-      cider_hashtable::
-          LinearProbeHashTable<int, std::pair<Batch*, int>, murmurHash, Equal>*>(
-      runtime_ctx->getContextItem(0));
+  auto hash_table = &reinterpret_cast<PartitionedJoinHashMap*>(
+                         runtime_ctx->getContextItem(0))
+                         ->getPartitionTable(0);
 
   auto check_array = [](ArrowArray* array, size_t expect_len) {
     EXPECT_EQ(array->length, expect_len);
@@ -196,15 +194,60 @@ TEST_F(ContextTests, RegisterHashTableTest) {
 
   for (auto key_iter : dup_map.getMap()) {
     auto dup_res_vec = dup_map.find(key_iter.first);
-    auto hm_res_vec = hash_table->find(key_iter.first);
-
-    for (int i = 0; i < hm_res_vec.size(); ++i) {
-      auto pair = hm_res_vec.at(i);
-      auto batch = pair.first;
+    size_t match_num = 0;
+    for (auto entry = hash_table->find_first(key_iter.first); entry != JoinHashMap::npos;
+         entry = hash_table->find_next(entry)) {
+      ++match_num;
+      auto batch = hash_table->value_at(entry).first;
       check_array(batch->getArray()->children[0], 10);
       check_array(batch->getArray()->children[1], 10);
       check_array(batch->getArray()->children[2], 10);
     }
+    EXPECT_EQ(match_num, dup_res_vec.size());
+  }
+}
+
+TEST_F(ContextTests, InValuesSetTest) {
+  std::vector<int64_t> dense{5, 7, 9, 64, 5};
+  auto bitmap = buildInBitmap(dense);
+  for (int64_t val = -10; val < 100; ++val) {
+    EXPECT_EQ(in_bitmap_contains(bitmap.data(), val),
+              val == 5 || val == 7 || val == 9 || val == 64);
+  }
+
+  std::vector<int64_t> sparse{std::numeric_limits<int64_t>::min(), -1, 0, 1 << 20};
+  for (int64_t i = 0; i < 100; ++i) {
+    sparse.push_back(i * 1000003);
+  }
+  auto hash_set = buildInHashSet(sparse);
+  for (auto val : sparse) {
+    EXPECT_TRUE(in_hash_set_contains(hash_set.data(), val));
+  }
+  EXPECT_FALSE(in_hash_set_contains(hash_set.data(), 2));
+  EXPECT_FALSE(
+      in_hash_set_contains(hash_set.data(), std::numeric_limits<int64_t>::max()));
+  // BIGINT values equal to the free slot sentinel, which is the first int64 from
+  // INT64_MIN not in the list.
+  EXPECT_FALSE(
+      in_hash_set_contains(hash_set.data(), std::numeric_limits<int64_t>::min() + 1));
+  sparse.erase(sparse.begin());
+  auto no_min_set = buildInHashSet(sparse);
+  EXPECT_FALSE(
+      in_hash_set_contains(no_min_set.data(), std::numeric_limits<int64_t>::min()));
+  EXPECT_TRUE(in_hash_set_contains(no_min_set.data(), -1));
+
+  auto double_set = buildInHashSet({in_set_double_key(0.0), in_set_double_key(2.5)});
+  EXPECT_TRUE(in_hash_set_contains(double_set.data(), in_set_double_key(-0.0)));
+  EXPECT_TRUE(in_hash_set_contains(double_set.data(), in_set_double_key(2.5)));
+  EXPECT_FALSE(in_hash_set_contains(double_set.data(), in_set_double_key(1.5)));
+
+  std::vector<std::string> strings{"", "a", "abcdefgh", "abcdefghi", "abcdefghj"};
+  auto string_set = buildInStringSet(strings);
+  for (auto& str : strings) {
+    EXPECT_TRUE(in_string_set_contains(string_set.data(), str.data(), str.size()));
+  }
+  for (std::string str : {"b", "abcdefg", "abcdefghk", "abcdefghij"}) {
+    EXPECT_FALSE(in_string_set_contains(string_set.data(), str.data(), str.size()));
   }
 }
 
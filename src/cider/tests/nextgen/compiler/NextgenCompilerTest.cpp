@@ -137,6 +137,87 @@ TEST_F(CiderNextgenCompilerTestBase, integerFilterTest) {
   assertQuery("SELECT col_1 + col_2 FROM test WHERE col_1 <= col_2");
 }
 
+class CiderNextgenBlockCodegenTest : public CiderNextgenTestBase {
+ public:
+  CiderNextgenBlockCodegenTest() {
+    table_name_ = "test";
+    create_ddl_ = "CREATE TABLE test(col_1 BIGINT, col_2 INTEGER, col_3 BOOLEAN)";
+    // not a multiple of block size, so the last block is partial
+    QueryArrowDataGenerator::generateBatchByTypes(input_schema_,
+                                                  input_array_,
+                                                  200,
+                                                  {"col_1", "col_2", "col_3"},
+                                                  {CREATE_SUBSTRAIT_TYPE(I64),
+                                                   CREATE_SUBSTRAIT_TYPE(I32),
+                                                   CREATE_SUBSTRAIT_TYPE(Bool)},
+                                                  {2, 3, 2},
+                                                  GeneratePattern::Random);
+    cider_nextgen_query_runner_.getContext()->setBlockCodegen(true);
+  }
+};
+
+TEST_F(CiderNextgenBlockCodegenTest, nullableFilterProjectTest) {
+  assertQuery("SELECT col_1 + col_2 FROM test WHERE col_1 > col_2");
+  assertQuery("SELECT col_1, col_3 FROM test WHERE col_3 = true");
+  assertQuery("SELECT col_2 FROM test WHERE col_1 IS NULL OR col_3 IS NULL");
+  // condition exprs referenced again by projection
+  assertQuery("SELECT col_1 + col_2, col_3 FROM test WHERE col_1 + col_2 > 0 AND col_3");
+  // no filter, rows of a block are consumed directly
+  assertQuery("SELECT col_1, col_3 FROM test");
+}
+
+class CiderNextgenLongStringTest : public CiderNextgenTestBase {
+ public:
+  CiderNextgenLongStringTest() {
+    table_name_ = "test";
+    create_ddl_ = "CREATE TABLE test(col_1 INTEGER NOT NULL, col_2 VARCHAR(100))";
+    // strings are much longer than the initial estimate of output buffer
+    QueryArrowDataGenerator::generateBatchByTypes(
+        input_schema_,
+        input_array_,
+        200,
+        {"col_1", "col_2"},
+        {CREATE_SUBSTRAIT_TYPE(I32), CREATE_SUBSTRAIT_TYPE(Varchar)},
+        {0, 2},
+        GeneratePattern::Sequence,
+        100,
+        100);
+  }
+};
+
+TEST_F(CiderNextgenLongStringTest, varcharOutputTest) {
+  assertQuery("SELECT col_2 FROM test");
+  assertQuery("SELECT col_1, col_2 FROM test WHERE col_1 % 3 = 0");
+}
+
+class CiderNextgenLateMaterializationTest : public CiderNextgenTestBase {
+ public:
+  CiderNextgenLateMaterializationTest() {
+    table_name_ = "test";
+    create_ddl_ = "CREATE TABLE test(col_1 BIGINT, col_2 INTEGER, col_3 VARCHAR(10))";
+    QueryArrowDataGenerator::generateBatchByTypes(input_schema_,
+                                                  input_array_,
+                                                  100,
+                                                  {"col_1", "col_2", "col_3"},
+                                                  {CREATE_SUBSTRAIT_TYPE(I64),
+                                                   CREATE_SUBSTRAIT_TYPE(I32),
+                                                   CREATE_SUBSTRAIT_TYPE(Varchar)},
+                                                  {2, 2, 2},
+                                                  GeneratePattern::Random,
+                                                  0,
+                                                  10);
+    cider_nextgen_query_runner_.getContext()->setLateMaterialization(true);
+  }
+};
+
+TEST_F(CiderNextgenLateMaterializationTest, forwardedColumnTest) {
+  // all rows selected, input columns are moved to output
+  assertQuery("SELECT col_1, col_3 FROM test");
+  // rows are gathered by selection vector
+  assertQuery("SELECT col_1, col_3 FROM test WHERE col_2 > 0");
+  assertQuery("SELECT col_3, col_1 + col_2, col_3 FROM test WHERE col_1 IS NOT NULL");
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
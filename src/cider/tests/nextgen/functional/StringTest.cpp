@@ -47,6 +47,9 @@
     ASSERT_FUNC("SELECT col_2 FROM test where col_2 LIKE '22%22'");                      \
     ASSERT_FUNC("SELECT col_2 FROM test where col_2 LIKE '_33%'");                       \
     ASSERT_FUNC("SELECT col_2 FROM test where col_2 LIKE '44_%'");                       \
+    ASSERT_FUNC("SELECT col_2 FROM test where col_2 LIKE '%11%22%'");                    \
+    ASSERT_FUNC("SELECT col_2 FROM test where col_2 LIKE '1%2%3%4'");                    \
+    ASSERT_FUNC("SELECT col_2 FROM test where col_2 LIKE '1111111111'");                 \
     ASSERT_FUNC(                                                                         \
         "SELECT col_2 FROM test where col_2 LIKE '5555%' OR col_2 LIKE '%6666'");        \
     ASSERT_FUNC(                                                                         \
@@ -160,21 +163,20 @@ class CiderStringNullableTestNextGen : public CiderTestBase {
   }
 };
 
-// TODO: (YBRua) enable inStringTest after nextgen supports IN
 BASIC_STRING_TEST_UNIT_ARROW(CiderStringTestNextGen, BasicStringTest)
 LIKE_STRING_TEST_UNIT_ARROW(CiderStringTestNextGen, LikeStringTest)
 ESCAPE_STRING_TEST_UNIT_ARROW(CiderStringTestNextGen, EscapeStringTest)
-// IN_STRING_TEST_UNIT_ARROW(CiderStringTestNextGen, InStringTest)
+IN_STRING_TEST_UNIT_ARROW(CiderStringTestNextGen, InStringTest)
 
 BASIC_STRING_TEST_UNIT_ARROW(CiderStringRandomTestNextGen, BasicRandomStringTest)
 LIKE_STRING_TEST_UNIT_ARROW(CiderStringRandomTestNextGen, LikeRandomStringTest)
 ESCAPE_STRING_TEST_UNIT_ARROW(CiderStringRandomTestNextGen, EscapeRandomStringTest)
-// IN_STRING_TEST_UNIT_ARROW(CiderStringRandomTestNextGen, InRandomStringTest)
+IN_STRING_TEST_UNIT_ARROW(CiderStringRandomTestNextGen, InRandomStringTest)
 
 BASIC_STRING_TEST_UNIT_ARROW(CiderStringNullableTestNextGen, BasicStringTest)
 LIKE_STRING_TEST_UNIT_ARROW(CiderStringNullableTestNextGen, LikeStringTest)
 ESCAPE_STRING_TEST_UNIT_ARROW(CiderStringNullableTestNextGen, EscapeStringTest)
-// IN_STRING_TEST_UNIT_ARROW(CiderStringNullableTestNextGen, InStringTest)
+IN_STRING_TEST_UNIT_ARROW(CiderStringNullableTestNextGen, InStringTest)
 
 // duplicate string
 
@@ -285,6 +287,23 @@ TEST_F(CiderConstantStringTestNextGen, LikeStringTest) {
   // expected_batch_3);
 }
 
+TEST_F(CiderConstantStringTestNextGen, LikeSegmentsTest) {
+  auto expected_vec = std::vector<std::string>{"aabbccdd"};
+  auto [data, offset] = ArrowBuilderUtils::createDataAndOffsetFromStrVector(expected_vec);
+  auto expected_batch = ArrowBuilderUtils::createCiderBatchFromArrowBuilder(
+      ArrowArrayBuilder().setRowNum(1).addUTF8Column("col_1", data, offset).build());
+  assertQueryArrow("SELECT col_1 FROM test where col_1 LIKE 'aa%cc%dd'", expected_batch);
+  assertQueryArrow("SELECT col_1 FROM test where col_1 LIKE '%b%c%'", expected_batch);
+  assertQueryArrow("SELECT col_1 FROM test where col_1 LIKE 'aabbccdd'", expected_batch);
+
+  auto expected_vec_2 = std::vector<std::string>{"1112222"};
+  auto [data_2, offset_2] =
+      ArrowBuilderUtils::createDataAndOffsetFromStrVector(expected_vec_2);
+  auto expected_batch_2 = ArrowBuilderUtils::createCiderBatchFromArrowBuilder(
+      ArrowArrayBuilder().setRowNum(1).addUTF8Column("col_1", data_2, offset_2).build());
+  assertQueryArrow("SELECT col_1 FROM test where col_1 LIKE '1%2'", expected_batch_2);
+}
+
 // stringop: substring
 
 TEST_F(CiderStringNullableTestNextGen, SubstringTest) {
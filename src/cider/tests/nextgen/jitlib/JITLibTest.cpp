@@ -21,8 +21,11 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
 #include <functional>
 
+#include <boost/filesystem.hpp>
+
 #include "exec/nextgen/jitlib/JITLib.h"
 #include "tests/TestHelpers.h"
 
@@ -666,6 +669,56 @@ TEST_F(JITLibTests, PackJITValueTest) {
   EXPECT_EQ(result, true);
 }
 
+TEST_F(JITLibTests, ObjectCacheTest) {
+  auto cache_dir = boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path("jit_object_cache_%%%%%%%%");
+  CompilationOptions co;
+  co.object_cache_dir = cache_dir.string();
+
+  auto compile_and_run = [&co]() {
+    LLVMJITModule module("TestModule", false, co);
+    JITFunctionPointer func = JITFunctionBuilder()
+                                  .setFuncName("test_func")
+                                  .registerModule(module)
+                                  .addParameter(JITTypeTag::INT32, "x")
+                                  .addReturn(JITTypeTag::INT32)
+                                  .addProcedureBuilder([](JITFunctionPointer func) {
+                                    auto x = func->getArgument(0);
+                                    auto ans = *x + 1;
+                                    func->createReturn(ans);
+                                  })
+                                  .build();
+    module.finish();
+    EXPECT_EQ(func->getFunctionPointer<int32_t, int32_t>()(41), 42);
+  };
+  auto list_objects = [&cache_dir]() {
+    std::vector<boost::filesystem::path> objects;
+    for (auto& entry : boost::filesystem::directory_iterator(cache_dir)) {
+      objects.push_back(entry.path());
+    }
+    return objects;
+  };
+
+  compile_and_run();
+  auto objects = list_objects();
+  ASSERT_EQ(objects.size(), 1);
+  auto object_size = boost::filesystem::file_size(objects[0]);
+
+  // loaded from cache, nothing new is written
+  compile_and_run();
+  EXPECT_EQ(list_objects().size(), 1);
+
+  // corrupted objects are detected and re-generated
+  {
+    std::ofstream file(objects[0].string(), std::ios::trunc);
+    file << "corrupted";
+  }
+  compile_and_run();
+  EXPECT_EQ(boost::filesystem::file_size(objects[0]), object_size);
+
+  boost::filesystem::remove_all(cache_dir);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
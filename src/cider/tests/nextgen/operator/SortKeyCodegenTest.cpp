@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Intel Corporation.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <limits>
+
+#include "exec/nextgen/Nextgen.h"
+#include "exec/operator/sort/CiderSortKeys.h"
+#include "exec/plan/parser/TypeUtils.h"
+#include "tests/TestHelpers.h"
+#include "tests/utils/ArrowArrayBuilder.h"
+
+using namespace cider::jitlib;
+using namespace cider::exec::nextgen;
+using cider::exec::sort::compareSortKeys;
+using cider::exec::sort::SortKeyLayout;
+
+class SortKeyCodegenTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    constexpr float kFloatNaN = std::numeric_limits<float>::quiet_NaN();
+    constexpr float kFloatInf = std::numeric_limits<float>::infinity();
+    constexpr double kDoubleNaN = std::numeric_limits<double>::quiet_NaN();
+    constexpr double kDoubleInf = std::numeric_limits<double>::infinity();
+    std::vector<bool> nulls{false, false, true, false, false, false, false, false};
+    auto builder = ArrowArrayBuilder();
+    std::tie(schema_, batch_) =
+        builder.setRowNum(8)
+            .addColumn<int8_t>("i8",
+                               CREATE_SUBSTRAIT_TYPE(I8),
+                               {-128, 127, 0, -1, 0, 1, 127, -128},
+                               nulls)
+            .addColumn<int16_t>("i16",
+                                CREATE_SUBSTRAIT_TYPE(I16),
+                                {-32768, 32767, 0, -1, 0, 1, 256, -256},
+                                {true, false, false, false, false, true, false, false})
+            .addColumn<int32_t>("i32",
+                                CREATE_SUBSTRAIT_TYPE(I32),
+                                {INT32_MIN, INT32_MAX, 0, -1, 0, 1, 1 << 16, -(1 << 16)},
+                                nulls)
+            .addColumn<int64_t>("i64",
+                                CREATE_SUBSTRAIT_TYPE(I64),
+                                {INT64_MIN, INT64_MAX, 0, -1, 0, 1, 1LL << 32, -1LL},
+                                {false, false, false, true, false, false, false, false})
+            .addColumn<float>(
+                "f",
+                CREATE_SUBSTRAIT_TYPE(Fp32),
+                {-0.0f, 0.0f, kFloatNaN, -kFloatInf, kFloatInf, 1.5f, -1.5f, -kFloatNaN},
+                nulls)
+            .addColumn<double>(
+                "d",
+                CREATE_SUBSTRAIT_TYPE(Fp64),
+                {kDoubleNaN, -0.0, 0.0, -kDoubleInf, kDoubleInf, 1e300, -1e-300, 0.0},
+                {false, false, false, false, false, false, false, true})
+            .addUTF8Column("s",
+                           "aabcdefghabcdefghiabcdefgzbabczzzz",
+                           {0, 0, 1, 9, 18, 26, 27, 30, 34},
+                           {false, false, false, false, false, false, true, false})
+            .addBoolColumn<bool>("b",
+                                 {true, false, true, false, false, true, true, false},
+                                 {false, true, false, false, false, false, false, true})
+            .build();
+  }
+
+  // Keys of every row encoded by the generated encoder must be the same as encoded by
+  // SortKeyLayout::encode(), and every pair of them must compare the same with the
+  // generated comparator and compareSortKeys().
+  void checkLayout(const SortKeyLayout& layout) {
+    LLVMJITModule module("SortKeyCodegenTest", true);
+    auto encode_func = buildSortKeyEncode(module, layout);
+    auto compare_func = buildSortKeyCompare(module, layout.getCompareWords());
+    module.finish();
+    auto encode =
+        encode_func->getFunctionPointer<void, const ArrowArray*, int64_t, int64_t*>();
+    auto compare =
+        compare_func->getFunctionPointer<int32_t, const int64_t*, const int64_t*>();
+
+    const size_t words = layout.getKeyWords();
+    std::vector<std::vector<int64_t>> keys;
+    for (int64_t row = 0; row < batch_->length; ++row) {
+      // dirty buffers, so bytes left unwritten show up
+      std::vector<int64_t> expected(words, -1);
+      layout.encode(batch_, row, expected.data());
+      std::vector<int64_t> key(words, 0x5A5A5A5A5A5A5A5A);
+      encode(batch_, row, key.data());
+      EXPECT_EQ(key, expected) << "row " << row;
+      keys.push_back(std::move(key));
+    }
+
+    const size_t compare_words = layout.getCompareWords();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      for (size_t j = 0; j < keys.size(); ++j) {
+        EXPECT_EQ(compare(keys[i].data(), keys[j].data()),
+                  compareSortKeys(keys[i].data(), keys[j].data(), compare_words))
+            << "rows " << i << " and " << j;
+      }
+    }
+  }
+
+  // Checks the layout of columns in every order, where order picks ASC/DESC and nulls
+  // first/last of each key.
+  void checkColumns(const std::vector<size_t>& columns) {
+    for (int order = 0; order < 4; ++order) {
+      SortKeyLayout layout;
+      for (size_t i = 0; i < columns.size(); ++i) {
+        int key_order = (order + i) % 4;
+        layout.addKey(columns[i], kTypes[columns[i]], key_order & 1, key_order & 2);
+      }
+      checkLayout(layout);
+    }
+  }
+
+ protected:
+  static constexpr SQLTypes kTypes[] = {
+      kTINYINT, kSMALLINT, kINT, kBIGINT, kFLOAT, kDOUBLE, kVARCHAR, kBOOLEAN};
+
+  ArrowSchema* schema_{nullptr};
+  ArrowArray* batch_{nullptr};
+};
+
+TEST_F(SortKeyCodegenTest, SingleKeyTest) {
+  for (size_t column = 0; column < std::size(kTypes); ++column) {
+    checkColumns({column});
+  }
+}
+
+TEST_F(SortKeyCodegenTest, FixedWidthKeysTest) {
+  checkColumns({0, 1, 2, 3, 4, 5, 7});
+  checkColumns({7, 5, 3, 1});
+}
+
+TEST_F(SortKeyCodegenTest, StringKeysTest) {
+  // words after the string key are encoded but not compared
+  checkColumns({2, 6, 5, 7});
+  checkColumns({6, 0, 6, 4});
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
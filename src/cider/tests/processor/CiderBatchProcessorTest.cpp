@@ -19,10 +19,18 @@
  * under the License.
  */
 
+#include <chrono>
+
 #include <google/protobuf/util/json_util.h>
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
+#include "cider/batch/CiderBatchUtils.h"
+#include "exec/plan/substrait/SubstraitPlan.h"
+#include "exec/processor/CompiledQueryCache.h"
+#include "exec/processor/DefaultJoinHashTableBuilder.h"
 #include "exec/processor/StatefulProcessor.h"
 #include "exec/processor/StatelessProcessor.h"
 #include "tests/utils/QueryArrowDataGenerator.h"
@@ -32,6 +40,11 @@ using namespace cider::exec::processor;
 
 namespace {
 
+// Table of three BIGINT NOT NULL columns queried by most tests.
+const std::string kTestTableDdl =
+    "CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL, "
+    "col_3 BIGINT NOT NULL);";
+
 std::shared_ptr<BatchProcessor> createBatchProcessorFromSql(const std::string& sql,
                                                             const std::string& ddl) {
   std::string json = RunIsthmus::processSql(sql, ddl);
@@ -82,6 +95,703 @@ TEST(CiderBatchProcessorTest, statelessProcessorProcessNextBatchTest) {
   std::cout << "Query result has " << output_array.length << " rows" << std::endl;
 }
 
+TEST(CiderBatchProcessorTest, compiledQueryCacheTest) {
+  const std::string& ddl = kTestTableDdl;
+  auto& cache = CompiledQueryCache::getInstance();
+  cache.reset(2);
+
+  createBatchProcessorFromSql("SELECT col_1 + col_2 FROM test", ddl);
+  createBatchProcessorFromSql("SELECT col_1 + col_2 FROM test", ddl);
+  auto stats = cache.getStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.size, 1);
+
+  createBatchProcessorFromSql("SELECT col_1 - col_2 FROM test", ddl);
+  createBatchProcessorFromSql("SELECT col_1 * col_2 FROM test", ddl);
+  stats = cache.getStats();
+  EXPECT_EQ(stats.misses, 3);
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.size, 2);
+
+  cache.reset();
+}
+
+TEST(CiderBatchProcessorTest, compiledQueryCacheFailureTest) {
+  auto& cache = CompiledQueryCache::getInstance();
+  cache.reset(1);
+  // keys differ only by codegen options
+  ::substrait::Plan plan;
+  cider::jitlib::CompilationOptions co;
+  cider::exec::nextgen::context::CodegenOptions cgo;
+  cider::exec::nextgen::context::CodegenOptions other_cgo;
+  other_cgo.enable_late_materialization = true;
+  int compiled = 0;
+  auto compiler = [&compiled]() {
+    ++compiled;
+    return std::make_shared<CompiledQuery>();
+  };
+
+  // the compilation fails after its entry is evicted and inserted again
+  auto pool = std::make_unique<CompileThreadPool>(1);
+  std::promise<void> reinserted;
+  auto failed = cache.getOrCompileAsync(
+      plan,
+      co,
+      cgo,
+      [&reinserted]() -> CompiledQueryPtr {
+        reinserted.get_future().wait();
+        throw std::runtime_error("compilation failed");
+      },
+      *pool);
+  cache.getOrCompile(plan, co, other_cgo, compiler);
+  cache.getOrCompile(plan, co, cgo, compiler);
+  EXPECT_EQ(compiled, 2);
+  reinserted.set_value();
+  // wait until the failed entry is handled
+  pool.reset();
+  EXPECT_THROW(failed.get(), std::runtime_error);
+
+  // the failure doesn't drop the entry inserted again
+  cache.getOrCompile(plan, co, cgo, compiler);
+  EXPECT_EQ(compiled, 2);
+  EXPECT_EQ(cache.getStats().hits, 1);
+
+  cache.reset();
+}
+
+TEST(CiderBatchProcessorTest, keepIRTest) {
+  std::string sql = "SELECT col_1 + col_2 FROM test WHERE col_1 <= col_2";
+  std::string json = RunIsthmus::processSql(sql, kTestTableDdl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  EXPECT_TRUE(makeBatchProcessor(plan, context)->getIR().empty());
+
+  DiagnosticsOptions diagnostics;
+  diagnostics.keep_ir = true;
+  context->setDiagnosticsOptions(diagnostics);
+  auto ir = makeBatchProcessor(plan, context)->getIR();
+  EXPECT_NE(ir.find("query_func"), std::string::npos);
+}
+
+TEST(CiderBatchProcessorTest, blockCodegenTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT, col_2 INTEGER, col_3 BOOLEAN);
+        )";
+  std::string sql =
+      "SELECT col_1 + col_2, col_3 FROM test WHERE col_1 > col_2 OR col_3 IS NULL";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto make_processor = [&](bool block_codegen) {
+    auto context = std::make_shared<BatchProcessorContext>(allocator);
+    DiagnosticsOptions diagnostics;
+    diagnostics.keep_ir = true;
+    context->setDiagnosticsOptions(diagnostics);
+    context->setBlockCodegen(block_codegen);
+    return makeBatchProcessor(plan, context);
+  };
+  auto row_processor = make_processor(false);
+  auto block_processor = make_processor(true);
+  // the option generates a different query function
+  EXPECT_NE(row_processor->getIR(), block_processor->getIR());
+
+  // not a multiple of 64 rows, so the last bitmap word is partial
+  struct ArrowArray* input_array;
+  struct ArrowSchema* input_schema;
+  QueryArrowDataGenerator::generateBatchByTypes(input_schema,
+                                                input_array,
+                                                200,
+                                                {"col_1", "col_2", "col_3"},
+                                                {CREATE_SUBSTRAIT_TYPE(I64),
+                                                 CREATE_SUBSTRAIT_TYPE(I32),
+                                                 CREATE_SUBSTRAIT_TYPE(Bool)},
+                                                {2, 3, 2},
+                                                GeneratePattern::Random);
+  // the same input goes through both processors, only the last one releases it
+  struct ArrowArray borrowed_array = *input_array;
+  struct ArrowSchema borrowed_schema = *input_schema;
+  borrowed_array.release = nullptr;
+  borrowed_schema.release = nullptr;
+  row_processor->processNextBatch(&borrowed_array, &borrowed_schema);
+  struct ArrowArray row_array;
+  struct ArrowSchema row_schema;
+  row_processor->getResult(row_array, row_schema);
+  block_processor->processNextBatch(input_array, input_schema);
+  struct ArrowArray block_array;
+  struct ArrowSchema block_schema;
+  block_processor->getResult(block_array, block_schema);
+
+  auto is_bit_set = [](const void* bitmap, int64_t i) {
+    auto bytes = reinterpret_cast<const uint8_t*>(bitmap);
+    return !bytes || (bytes[i >> 3] >> (i & 7)) & 1;
+  };
+  ASSERT_EQ(row_array.length, block_array.length);
+  ASSERT_EQ(row_array.n_children, 2);
+  ASSERT_EQ(block_array.n_children, 2);
+  auto row_sums = reinterpret_cast<const int64_t*>(row_array.children[0]->buffers[1]);
+  auto word_sums = reinterpret_cast<const int64_t*>(block_array.children[0]->buffers[1]);
+  for (int64_t i = 0; i < row_array.length; ++i) {
+    bool valid = is_bit_set(row_array.children[0]->buffers[0], i);
+    EXPECT_EQ(valid, is_bit_set(block_array.children[0]->buffers[0], i));
+    if (valid) {
+      EXPECT_EQ(row_sums[i], word_sums[i]);
+    }
+    valid = is_bit_set(row_array.children[1]->buffers[0], i);
+    EXPECT_EQ(valid, is_bit_set(block_array.children[1]->buffers[0], i));
+    if (valid) {
+      EXPECT_EQ(is_bit_set(row_array.children[1]->buffers[1], i),
+                is_bit_set(block_array.children[1]->buffers[1], i));
+    }
+  }
+  row_array.release(&row_array);
+  row_schema.release(&row_schema);
+  block_array.release(&block_array);
+  block_schema.release(&block_schema);
+}
+
+TEST(CiderBatchProcessorTest, asyncCompileTest) {
+  std::string sql = "SELECT col_1 + col_3 FROM test WHERE col_1 <= col_3";
+  std::string json = RunIsthmus::processSql(sql, kTestTableDdl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  context->setAsyncCompile(true);
+
+  // fragments of the same plan compile once, others wait for the same result
+  std::vector<std::unique_ptr<BatchProcessor>> processors;
+  for (int i = 0; i < 4; ++i) {
+    processors.emplace_back(makeBatchProcessor(plan, context));
+  }
+
+  for (auto& processor : processors) {
+    while (processor->getState() == BatchProcessorState::kWaiting) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(processor->getState(), BatchProcessorState::kRunning);
+
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(input_schema,
+                                                  input_array,
+                                                  10,
+                                                  {"col_1", "col_2", "col_3"},
+                                                  {CREATE_SUBSTRAIT_TYPE(I64),
+                                                   CREATE_SUBSTRAIT_TYPE(I64),
+                                                   CREATE_SUBSTRAIT_TYPE(I64)});
+    processor->processNextBatch(input_array, input_schema);
+
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    EXPECT_LE(output_array.length, 10);
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+  }
+}
+
+TEST(CiderBatchProcessorTest, tieredCompileTest) {
+  std::string sql = "SELECT SUM(col_2) FROM test";
+  std::string json = RunIsthmus::processSql(sql, kTestTableDdl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  context->setTieredCompile(true);
+  context->setTierUpBatchNum(2);
+  auto processor = makeBatchProcessor(plan, context);
+
+  // aggregation states must survive the switch between tiers
+  constexpr int kBatchNum = 50;
+  for (int i = 0; i < kBatchNum; ++i) {
+    EXPECT_EQ(processor->getState(), BatchProcessorState::kRunning);
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(input_schema,
+                                                  input_array,
+                                                  10,
+                                                  {"col_1", "col_2", "col_3"},
+                                                  {CREATE_SUBSTRAIT_TYPE(I64),
+                                                   CREATE_SUBSTRAIT_TYPE(I64),
+                                                   CREATE_SUBSTRAIT_TYPE(I64)});
+    processor->processNextBatch(input_array, input_schema);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  processor->finish();
+
+  struct ArrowArray output_array;
+  struct ArrowSchema output_schema;
+  processor->getResult(output_array, output_schema);
+  ASSERT_EQ(output_array.length, 1);
+  auto sum = reinterpret_cast<const int64_t*>(output_array.children[0]->buffers[1]);
+  EXPECT_EQ(sum[0], 45 * kBatchNum);
+  output_array.release(&output_array);
+  output_schema.release(&output_schema);
+}
+
+TEST(CiderBatchProcessorTest, tieredCompileStatelessTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT col_1 + col_2 FROM test WHERE col_1 < 5";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  context->setTieredCompile(true);
+  context->setTierUpBatchNum(2);
+  auto processor = makeBatchProcessor(plan, context);
+  auto default_processor = dynamic_cast<DefaultBatchProcessor*>(processor.get());
+  ASSERT_NE(default_processor, nullptr);
+
+  // results must be the same before and after the switch between tiers
+  int tiered_up_batch_num = 0;
+  for (int i = 0; i < 1000 && tiered_up_batch_num < 3; ++i) {
+    EXPECT_EQ(processor->getState(), BatchProcessorState::kRunning);
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(
+        input_schema,
+        input_array,
+        10,
+        {"col_1", "col_2"},
+        {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+    processor->processNextBatch(input_array, input_schema);
+    if (default_processor->isTieredUp()) {
+      ++tiered_up_batch_num;
+    }
+
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    ASSERT_EQ(output_array.length, 5);
+    auto sums = reinterpret_cast<const int64_t*>(output_array.children[0]->buffers[1]);
+    for (int64_t j = 0; j < output_array.length; ++j) {
+      EXPECT_EQ(sums[j], 2 * j);
+    }
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_TRUE(default_processor->isTieredUp());
+}
+
+TEST(CiderBatchProcessorTest, hashJoinTest) {
+  std::string ddl = R"(
+        CREATE TABLE probe(a BIGINT NOT NULL, b BIGINT NOT NULL);
+        CREATE TABLE build(c INTEGER NOT NULL, d BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT a, b, d FROM probe JOIN build ON a = c";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+
+  // build side holds keys 0, 1, 2
+  auto joinRel = cider::plan::SubstraitPlan(plan).getJoinRel();
+  ASSERT_TRUE(joinRel.has_value());
+  auto builder = makeJoinHashTableBuilder(
+      *joinRel.value(), std::make_shared<JoinHashTableBuildContext>(allocator));
+  struct ArrowArray* build_array;
+  struct ArrowSchema* build_schema;
+  QueryArrowDataGenerator::generateBatchByTypes(
+      build_schema,
+      build_array,
+      3,
+      {"c", "d"},
+      {CREATE_SUBSTRAIT_TYPE(I32), CREATE_SUBSTRAIT_TYPE(I64)});
+  builder->appendBatch(
+      CiderBatchUtils::createCiderBatch(allocator, build_schema, build_array));
+  std::shared_ptr<JoinHashTable> table = builder->build();
+
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  context->setHashBuildTableSupplier(
+      [table]() -> std::optional<HashBuildResult> { return HashBuildResult(table); });
+  auto processor = makeBatchProcessor(plan, context);
+  EXPECT_EQ(processor->getState(), BatchProcessorState::kRunning);
+
+  struct ArrowArray* input_array;
+  struct ArrowSchema* input_schema;
+  QueryArrowDataGenerator::generateBatchByTypes(
+      input_schema,
+      input_array,
+      10,
+      {"a", "b"},
+      {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+  processor->processNextBatch(input_array, input_schema);
+
+  struct ArrowArray output_array;
+  struct ArrowSchema output_schema;
+  processor->getResult(output_array, output_schema);
+  ASSERT_EQ(output_array.length, 3);
+  auto a = reinterpret_cast<const int64_t*>(output_array.children[0]->buffers[1]);
+  auto d = reinterpret_cast<const int64_t*>(output_array.children[2]->buffers[1]);
+  for (int64_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(a[i], i);
+    EXPECT_EQ(d[i], i);
+  }
+  output_array.release(&output_array);
+  output_schema.release(&output_schema);
+}
+
+TEST(CiderBatchProcessorTest, hashJoinMergeTest) {
+  std::string ddl = R"(
+        CREATE TABLE probe(a BIGINT NOT NULL, b BIGINT NOT NULL);
+        CREATE TABLE build(c BIGINT NOT NULL, d BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT a, d FROM probe JOIN build ON a = c";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto joinRel = cider::plan::SubstraitPlan(plan).getJoinRel();
+  ASSERT_TRUE(joinRel.has_value());
+
+  // every build driver holds keys 0 ~ 99
+  constexpr int kDriverNum = 4;
+  std::vector<std::unique_ptr<JoinHashTable>> tables;
+  for (int i = 0; i < kDriverNum; ++i) {
+    auto builder = makeJoinHashTableBuilder(
+        *joinRel.value(), std::make_shared<JoinHashTableBuildContext>(allocator));
+    struct ArrowArray* build_array;
+    struct ArrowSchema* build_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(
+        build_schema,
+        build_array,
+        100,
+        {"c", "d"},
+        {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+    builder->appendBatch(
+        CiderBatchUtils::createCiderBatch(allocator, build_schema, build_array));
+    tables.emplace_back(builder->build());
+  }
+  auto last = std::move(tables.back());
+  tables.pop_back();
+  auto merged = last->merge(std::move(tables));
+
+  auto keyFilter = merged->getKeyFilter();
+  ASSERT_NE(keyFilter, nullptr);
+  EXPECT_EQ(keyFilter->min(), 0);
+  EXPECT_EQ(keyFilter->max(), 99);
+
+  auto hashMap = dynamic_cast<DefaultJoinHashTable*>(merged.get())->getHashTable();
+  for (int64_t key = 0; key < 100; ++key) {
+    int matches = 0;
+    for (auto slot = hashMap->probeFirst(key); slot >= 0;
+         slot = hashMap->probeNext(key, slot)) {
+      EXPECT_EQ(hashMap->valueAt(slot).second, key);
+      ++matches;
+    }
+    EXPECT_EQ(matches, kDriverNum);
+  }
+  EXPECT_EQ(hashMap->probeFirst(100), -1);
+}
+
+TEST(CiderBatchProcessorTest, partialAggregationMergeTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT col_1, SUM(col_2), COUNT(*) FROM test GROUP BY col_1";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto partialContext = std::make_shared<BatchProcessorContext>(allocator);
+  partialContext->setPartialAggregation(true);
+
+  // every driver aggregates keys 0 ~ 99 with values equal to keys
+  constexpr int kDriverNum = 4;
+  auto runDriver = [](BatchProcessor& processor) {
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(
+        input_schema,
+        input_array,
+        100,
+        {"col_1", "col_2"},
+        {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+    processor.processNextBatch(input_array, input_schema);
+    processor.finish();
+  };
+  std::vector<BatchProcessorPtr> partials;
+  for (int i = 0; i < kDriverNum; ++i) {
+    partials.emplace_back(makeBatchProcessor(plan, partialContext));
+    runDriver(*partials.back());
+
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    partials.back()->getResult(output_array, output_schema);
+    EXPECT_EQ(output_array.length, 0);
+    EXPECT_EQ(output_array.release, nullptr);
+    EXPECT_EQ(output_schema.release, nullptr);
+    EXPECT_EQ(partials.back()->getState(), BatchProcessorState::kFinished);
+  }
+
+  auto finalContext = std::make_shared<BatchProcessorContext>(allocator);
+  auto finalProcessor = makeBatchProcessor(plan, finalContext);
+  runDriver(*finalProcessor);
+  finalProcessor->mergePartialAggregation(partials, 4);
+
+  struct ArrowArray output_array;
+  struct ArrowSchema output_schema;
+  finalProcessor->getResult(output_array, output_schema);
+  ASSERT_EQ(output_array.length, 100);
+  auto keys = reinterpret_cast<const int64_t*>(output_array.children[0]->buffers[1]);
+  auto sums = reinterpret_cast<const int64_t*>(output_array.children[1]->buffers[1]);
+  auto counts = reinterpret_cast<const int64_t*>(output_array.children[2]->buffers[1]);
+  std::vector<bool> seen(100, false);
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_GE(keys[i], 0);
+    ASSERT_LT(keys[i], 100);
+    EXPECT_FALSE(seen[keys[i]]);
+    seen[keys[i]] = true;
+    EXPECT_EQ(sums[i], keys[i] * (kDriverNum + 1));
+    EXPECT_EQ(counts[i], kDriverNum + 1);
+  }
+}
+
+TEST(CiderBatchProcessorTest, streamingAggregationOutputTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT col_1, SUM(col_2) FROM test GROUP BY col_1";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  context->setOutputBatchRows(30);
+  auto processor = makeBatchProcessor(plan, context);
+
+  struct ArrowArray* input_array;
+  struct ArrowSchema* input_schema;
+  QueryArrowDataGenerator::generateBatchByTypes(
+      input_schema,
+      input_array,
+      100,
+      {"col_1", "col_2"},
+      {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+  processor->processNextBatch(input_array, input_schema);
+  processor->finish();
+
+  // 100 groups are returned in batches of 30, 30, 30 and 10 rows
+  std::vector<bool> seen(100, false);
+  std::vector<int64_t> lengths;
+  while (processor->getState() == BatchProcessorState::kRunning) {
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    lengths.push_back(output_array.length);
+    auto keys = reinterpret_cast<const int64_t*>(output_array.children[0]->buffers[1]);
+    auto sums = reinterpret_cast<const int64_t*>(output_array.children[1]->buffers[1]);
+    for (int64_t i = 0; i < output_array.length; ++i) {
+      ASSERT_GE(keys[i], 0);
+      ASSERT_LT(keys[i], 100);
+      EXPECT_FALSE(seen[keys[i]]);
+      seen[keys[i]] = true;
+      EXPECT_EQ(sums[i], keys[i]);
+    }
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+  }
+  EXPECT_EQ(lengths, std::vector<int64_t>({30, 30, 30, 10}));
+}
+
+TEST(CiderBatchProcessorTest, sortTopNTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  std::string sql =
+      "SELECT col_1, col_2 FROM test ORDER BY col_2 DESC LIMIT 10 OFFSET 5";
+  auto processor = createBatchProcessorFromSql(sql, ddl);
+  EXPECT_EQ(processor->getProcessorType(), BatchProcessor::Type::kStateless);
+
+  for (int i = 0; i < 2; ++i) {
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(
+        input_schema,
+        input_array,
+        100,
+        {"col_1", "col_2"},
+        {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+    processor->processNextBatch(input_array, input_schema);
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    // rows are buffered until all batches have been processed
+    EXPECT_EQ(output_array.length, 0);
+  }
+  processor->finish();
+
+  std::vector<int64_t> values;
+  while (processor->getState() == BatchProcessorState::kRunning) {
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    auto col_2 = reinterpret_cast<const int64_t*>(output_array.children[1]->buffers[1]);
+    values.insert(values.end(), col_2, col_2 + output_array.length);
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+  }
+  EXPECT_EQ(values, std::vector<int64_t>({97, 96, 96, 95, 95, 94, 94, 93, 93, 92}));
+}
+
+TEST(CiderBatchProcessorTest, sortSpillTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT col_1, col_2 FROM test ORDER BY col_2";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  context->setOutputBatchRows(64);
+  // every batch is spilled as a sorted run
+  context->setSortSpillThreshold(1024);
+  auto processor = makeBatchProcessor(plan, context);
+
+  for (int i = 0; i < 4; ++i) {
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(
+        input_schema,
+        input_array,
+        100,
+        {"col_1", "col_2"},
+        {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+    processor->processNextBatch(input_array, input_schema);
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+  }
+  processor->finish();
+
+  std::vector<int64_t> values;
+  while (processor->getState() == BatchProcessorState::kRunning) {
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    EXPECT_LE(output_array.length, 64);
+    auto col_2 = reinterpret_cast<const int64_t*>(output_array.children[1]->buffers[1]);
+    values.insert(values.end(), col_2, col_2 + output_array.length);
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+  }
+  ASSERT_EQ(values.size(), 400);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], i / 4);
+  }
+}
+
+TEST(CiderBatchProcessorTest, sortGroupByAggregateTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  // the sort key is the first output column, an aggregate before the group-by key
+  std::string sql =
+      "SELECT SUM(col_2), col_1 FROM test GROUP BY col_1 ORDER BY SUM(col_2) DESC "
+      "LIMIT 3";
+  auto processor = createBatchProcessorFromSql(sql, ddl);
+  EXPECT_EQ(processor->getProcessorType(), BatchProcessor::Type::kStateful);
+
+  for (int i = 0; i < 2; ++i) {
+    struct ArrowArray* input_array;
+    struct ArrowSchema* input_schema;
+    QueryArrowDataGenerator::generateBatchByTypes(
+        input_schema,
+        input_array,
+        100,
+        {"col_1", "col_2"},
+        {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+    processor->processNextBatch(input_array, input_schema);
+  }
+  processor->finish();
+
+  std::vector<int64_t> sums;
+  std::vector<int64_t> keys;
+  while (processor->getState() == BatchProcessorState::kRunning) {
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    auto sum = reinterpret_cast<const int64_t*>(output_array.children[0]->buffers[1]);
+    auto key = reinterpret_cast<const int64_t*>(output_array.children[1]->buffers[1]);
+    sums.insert(sums.end(), sum, sum + output_array.length);
+    keys.insert(keys.end(), key, key + output_array.length);
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+  }
+  EXPECT_EQ(sums, std::vector<int64_t>({198, 196, 194}));
+  EXPECT_EQ(keys, std::vector<int64_t>({99, 98, 97}));
+}
+
+TEST(CiderBatchProcessorTest, sortLimitZeroTest) {
+  std::string ddl = R"(
+        CREATE TABLE test(col_1 BIGINT NOT NULL, col_2 BIGINT NOT NULL);
+        )";
+  std::string sql = "SELECT col_1, col_2 FROM test ORDER BY col_2 LIMIT 1";
+  std::string json = RunIsthmus::processSql(sql, ddl);
+  ::substrait::Plan plan;
+  google::protobuf::util::JsonStringToMessage(json, &plan);
+  // LIMIT 0 may be folded into an empty plan by the frontend, set it on the fetch
+  auto fetch =
+      plan.mutable_relations(0)->mutable_root()->mutable_input()->mutable_fetch();
+  fetch->set_count(0);
+  auto allocator = std::make_shared<CiderDefaultAllocator>();
+  auto context = std::make_shared<BatchProcessorContext>(allocator);
+  auto processor = makeBatchProcessor(plan, context);
+
+  struct ArrowArray* input_array;
+  struct ArrowSchema* input_schema;
+  QueryArrowDataGenerator::generateBatchByTypes(
+      input_schema,
+      input_array,
+      100,
+      {"col_1", "col_2"},
+      {CREATE_SUBSTRAIT_TYPE(I64), CREATE_SUBSTRAIT_TYPE(I64)});
+  processor->processNextBatch(input_array, input_schema);
+  processor->finish();
+
+  int64_t rows = 0;
+  while (processor->getState() == BatchProcessorState::kRunning) {
+    struct ArrowArray output_array;
+    struct ArrowSchema output_schema;
+    processor->getResult(output_array, output_schema);
+    rows += output_array.length;
+    output_array.release(&output_array);
+    output_schema.release(&output_schema);
+  }
+  EXPECT_EQ(rows, 0);
+}
+
+TEST(CiderBatchProcessorTest, joinKeyFilterTest) {
+  constexpr int64_t kKeyNum = 10000;
+  JoinKeyFilter filter(kKeyNum);
+  EXPECT_TRUE(filter.empty());
+  EXPECT_FALSE(filter.mayContain(0));
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    filter.insert(i * 2);
+  }
+  EXPECT_EQ(filter.min(), 0);
+  EXPECT_EQ(filter.max(), (kKeyNum - 1) * 2);
+
+  int falsePositives = 0;
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    EXPECT_TRUE(filter.mayContain(i * 2));
+    falsePositives += filter.mayContain(i * 2 + 1);
+  }
+  EXPECT_LT(falsePositives, kKeyNum / 10);
+  EXPECT_FALSE(filter.mayContain(-2));
+  EXPECT_FALSE(filter.mayContain(kKeyNum * 2));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
 
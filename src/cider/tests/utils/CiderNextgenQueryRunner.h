@@ -47,6 +47,8 @@ class CiderNextgenQueryRunner {
 
   const std::shared_ptr<CiderAllocator>& getAllocator() const { return allocator_; }
 
+  const exec::processor::BatchProcessorContextPtr& getContext() const { return context_; }
+
   void runQueryOneBatch(const std::string& file_or_sql,
                         const struct ArrowArray& input_array,
                         const struct ArrowSchema& input_schema,
@@ -72,6 +72,18 @@ class LruCache {
 
   const_list_iterator_t cend() const { return (cache_items_list_.cend()); }
 
+  void erase(const key_t& key) {
+    auto it = cache_items_map_.find(key);
+    if (it != cache_items_map_.end()) {
+      cache_items_list_.erase(it->second);
+      cache_items_map_.erase(it);
+    }
+  }
+
+  size_t size() const { return cache_items_map_.size(); }
+
+  size_t capacity() const { return max_size_; }
+
   void clear() {
     cache_items_list_.clear();
     cache_items_map_.clear();
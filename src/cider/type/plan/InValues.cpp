@@ -19,7 +19,11 @@
  * under the License.
  */
 #include "InValues.h"
-#include "exec/nextgen/context/CiderSet.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "exec/nextgen/context/InValuesSet.h"
 #include "exec/template/Execute.h"
 
 namespace Analyzer {
@@ -159,126 +163,150 @@ void InValues::find_expr(bool (*f)(const Expr*),
   }
 }
 
-CiderSetPtr insertValuesToSet(
-    CiderSetPtr set,
+namespace {
+// IN lists up to this size are compared inline, the compares are OR-ed without
+// branches.
+constexpr size_t kInlineCompareMaxValues = 8;
+// Integer lists use a bitmap over [min, max] if it costs at most this many bits per
+// value, and a hash set otherwise.
+constexpr uint64_t kInBitmapMaxBitsPerValue = 64;
+constexpr uint64_t kInBitmapMaxBits = 1ULL << 26;
+
+// For case like IN [1, 2, NULL], NULL will be ignored
+// TODO: (yma11) fot case like NOT IN [1, 2, NULL], should pops up error during
+// parse?
+std::vector<Analyzer::Constant*> getNotNullConstants(
     const std::list<std::shared_ptr<Analyzer::Expr>>& val_list) {
-  auto& in_val_ti = val_list.front()->get_type_info();
+  std::vector<Analyzer::Constant*> constants;
   for (auto in_val : val_list) {
-    const auto in_val_const =
-        dynamic_cast<const Analyzer::Constant*>(extract_cast_arg(in_val.get()));
+    auto in_val_const = dynamic_cast<Analyzer::Constant*>(
+        const_cast<Analyzer::Expr*>(extract_cast_arg(in_val.get())));
     if (!in_val_const) {
       CIDER_THROW(CiderCompileException, "InValues only support constant value list.");
     }
-    // For case like IN [1, 2, NULL], NULL will be ignored
-    // TODO: (yma11) fot case like NOT IN [1, 2, NULL], should pops up error during
-    // parse?
-    switch (in_val_ti.get_type()) {
-      case kTINYINT: {
-        if (in_val_const->get_type_info().get_notnull()) {
-          set->insert(in_val_const->get_constval().tinyintval);
-        }
-        break;
-      }
-      case kSMALLINT: {
-        if (in_val_const->get_type_info().get_notnull()) {
-          set->insert(in_val_const->get_constval().smallintval);
-        }
-        break;
-      }
-      case kINT: {
-        if (in_val_const->get_type_info().get_notnull()) {
-          set->insert(in_val_const->get_constval().intval);
-        }
-        break;
-      }
-      case kBIGINT: {
-        if (in_val_const->get_type_info().get_notnull()) {
-          set->insert(in_val_const->get_constval().bigintval);
-        }
-        break;
-      }
-      case kFLOAT: {
-        if (in_val_const->get_type_info().get_notnull()) {
-          set->insert(in_val_const->get_constval().floatval);
-        }
-        break;
-      }
-      case kDOUBLE: {
-        if (in_val_const->get_type_info().get_notnull()) {
-          set->insert(in_val_const->get_constval().doubleval);
-        }
-        break;
-      }
-      default:
-        UNREACHABLE();
+    if (in_val_const->get_type_info().get_notnull()) {
+      constants.push_back(in_val_const);
     }
   }
-  return std::move(set);
+  return constants;
 }
 
-std::string get_fn_name(const SQLTypeInfo& type_info) {
-  switch (type_info.get_type()) {
+int64_t getIntegerValue(const Analyzer::Constant* in_val_const, const SQLTypeInfo& ti) {
+  switch (ti.get_type()) {
     case kTINYINT:
-      return "cider_set_contains_int8_t_val";
+      return in_val_const->get_constval().tinyintval;
     case kSMALLINT:
-      return "cider_set_contains_int16_t_val";
+      return in_val_const->get_constval().smallintval;
     case kINT:
-      return "cider_set_contains_int32_t_val";
+      return in_val_const->get_constval().intval;
     case kBIGINT:
-      return "cider_set_contains_int64_t_val";
+      return in_val_const->get_constval().bigintval;
+    default:
+      UNREACHABLE();
+  }
+  return 0;
+}
+
+double getFpValue(const Analyzer::Constant* in_val_const, const SQLTypeInfo& ti) {
+  switch (ti.get_type()) {
     case kFLOAT:
-      return "cider_set_contains_float_val";
+      return in_val_const->get_constval().floatval;
     case kDOUBLE:
-      return "cider_set_contains_double_val";
+      return in_val_const->get_constval().doubleval;
     default:
       UNREACHABLE();
   }
+  return 0;
 }
 
+JITValuePointer registerInValuesSet(CodegenContext& context,
+                                    const std::string& name,
+                                    std::vector<int8_t> set) {
+  CHECK_LE(set.size(), size_t(std::numeric_limits<int32_t>::max()));
+  int32_t capacity = set.size();
+  return context.registerBuffer(capacity, name, [set = std::move(set)](Buffer* buf) {
+    memcpy(buf->getBuffer(), set.data(), set.size());
+  });
+}
+}  // namespace
+
+// The evaluation strategy is chosen from the constant list: short lists are compared
+// inline, longer ones are looked up in a bitmap (dense integers), an open-addressing
+// table (other integers and fp) or a string table. The tables are plain memory read by
+// inlined runtime functions.
 JITExprValue& InValues::codegen(CodegenContext& context) {
   JITFunction& func = *context.getJITFunction();
-  // get the constant list and insert them in the set
   auto in_arg = const_cast<Analyzer::Expr*>(get_arg());
   if (is_unnest(in_arg)) {
     CIDER_THROW(CiderCompileException, "IN not supported for unnested expressions");
   }
   const auto& expr_ti = get_type_info();
   CHECK(expr_ti.is_boolean());
+  const auto& arg_ti = in_arg->get_type_info();
+  const auto& val_ti = get_value_list().front()->get_type_info();
+  auto constants = getNotNullConstants(get_value_list());
+
+  if (arg_ti.is_string()) {
+    VarSizeJITExprValue in_arg_val(in_arg->codegen(context));
+    std::vector<std::string> values;
+    for (auto in_val_const : constants) {
+      values.push_back(*in_val_const->get_constval().stringval);
+    }
+    auto set_ptr =
+        registerInValuesSet(context, "in_string_set", buildInStringSet(values));
+    auto value = func.emitRuntimeFunctionCall(
+        "cider_in_string_set_contains",
+        JITFunctionEmitDescriptor{.ret_type = JITTypeTag::BOOL,
+                                  .params_vector = {set_ptr.get(),
+                                                    in_arg_val.getValue().get(),
+                                                    in_arg_val.getLength().get()}});
+    return set_expr_value(in_arg_val.getNull(), value);
+  }
+
   FixSizeJITExprValue in_arg_val(in_arg->codegen(context));
   auto null_value = in_arg_val.getNull();
-  // For values count >= 3, use CiderSet for evaluation
-  // Otherwise, translate it into OR exprs
-  if (get_value_list().size() >= 3) {
-    CiderSetPtr cider_set;
-    if (in_arg->get_type_info().is_integer()) {
-      cider_set = std::make_unique<CiderInt64Set>();
-    }
-    if (in_arg->get_type_info().is_fp()) {
-      cider_set = std::make_unique<CiderDoubleSet>();
+
+  if (constants.size() > kInlineCompareMaxValues && arg_ti.is_integer()) {
+    std::vector<int64_t> values;
+    for (auto in_val_const : constants) {
+      values.push_back(getIntegerValue(in_val_const, val_ti));
     }
-    auto filled_set = insertValuesToSet(std::move(cider_set), get_value_list());
-    auto set_ptr = context.registerCiderSet("in_set", expr_ti, std::move(filled_set));
-    auto emit_desc = JITFunctionEmitDescriptor{
-        .ret_type = JITTypeTag::BOOL,
-        .params_vector = {set_ptr.get(), in_arg_val.getValue().get()}};
-    // call corresponding contains function
-    auto value =
-        func.emitRuntimeFunctionCall(get_fn_name(in_arg->get_type_info()), emit_desc);
+    auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+    uint64_t bitmap_bits = static_cast<uint64_t>(*max_it) - *min_it + 1;
+    bool use_bitmap = bitmap_bits != 0 && bitmap_bits <= kInBitmapMaxBits &&
+                      bitmap_bits <= values.size() * kInBitmapMaxBitsPerValue;
+    auto set_ptr =
+        use_bitmap ? registerInValuesSet(context, "in_bitmap", buildInBitmap(values))
+                   : registerInValuesSet(context, "in_set", buildInHashSet(values));
+    auto in_arg_int64 =
+        in_arg_val.getValue()->castJITValuePrimitiveType(JITTypeTag::INT64);
+    auto value = func.emitRuntimeFunctionCall(
+        use_bitmap ? "cider_in_bitmap_contains" : "cider_in_hash_set_contains",
+        JITFunctionEmitDescriptor{.ret_type = JITTypeTag::BOOL,
+                                  .params_vector = {set_ptr.get(), in_arg_int64.get()}});
     return set_expr_value(null_value, value);
-  } else {
-    JITValuePointer val = func.createVariable(JITTypeTag::BOOL, "null_val", false);
-    for (auto in_val : get_value_list()) {
-      auto in_val_const = dynamic_cast<Analyzer::Constant*>(
-          const_cast<Analyzer::Expr*>(extract_cast_arg(in_val.get())));
-      if (!in_val_const) {
-        CIDER_THROW(CiderCompileException, "InValues only support constant value list.");
-      }
-      if (in_val_const->get_type_info().get_notnull()) {
-        FixSizeJITExprValue in_val_const_jit(in_val_const->codegen(context));
-        val.replace(val || (in_arg_val.getValue() == in_val_const_jit.getValue()));
-      }
+  }
+
+  if (constants.size() > kInlineCompareMaxValues && arg_ti.is_fp()) {
+    std::vector<int64_t> values;
+    for (auto in_val_const : constants) {
+      values.push_back(in_set_double_key(getFpValue(in_val_const, val_ti)));
     }
-    return set_expr_value(null_value, val);
+    auto set_ptr = registerInValuesSet(context, "in_set", buildInHashSet(values));
+    auto in_arg_double =
+        in_arg_val.getValue()->castJITValuePrimitiveType(JITTypeTag::DOUBLE);
+    auto value = func.emitRuntimeFunctionCall(
+        "cider_in_hash_set_contains_double",
+        JITFunctionEmitDescriptor{.ret_type = JITTypeTag::BOOL,
+                                  .params_vector = {set_ptr.get(), in_arg_double.get()}});
+    return set_expr_value(null_value, value);
+  }
+
+  JITValuePointer val = func.createVariable(JITTypeTag::BOOL, "null_val", false);
+  for (auto in_val_const : constants) {
+    FixSizeJITExprValue in_val_const_jit(in_val_const->codegen(context));
+    val.replace(val || (in_arg_val.getValue() == in_val_const_jit.getValue()));
   }
+  return set_expr_value(null_value, val);
 }
 }  // namespace Analyzer
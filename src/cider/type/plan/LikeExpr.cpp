@@ -19,12 +19,105 @@
  * under the License.
  */
 #include "type/plan/LikeExpr.h"
+
+#include <algorithm>
+
 #include "exec/nextgen/jitlib/base/JITValue.h"
 #include "exec/template/Execute.h"  // for is_unnest
 
 namespace Analyzer {
 using namespace cider::jitlib;
 
+namespace {
+// Splits a constant LIKE pattern at unescaped '%' into literal segments. Returns false if
+// the pattern uses '_' or '[...]', which still go through the generic matcher.
+bool splitLikePattern(const std::string& pattern,
+                      const char escape_char,
+                      std::vector<std::string>& segments) {
+  segments.emplace_back();
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    char c = pattern[i];
+    if (c == escape_char) {
+      if (++i == pattern.size()) {
+        return false;
+      }
+      c = pattern[i];
+    } else if (c == '%') {
+      segments.emplace_back();
+      continue;
+    } else if (c == '_' || c == '[') {
+      return false;
+    }
+    segments.back().push_back(c);
+  }
+  return true;
+}
+
+// Matches the segments left to right: the first one is anchored at the start, the last
+// one at the end, and the ones in between are searched in order.
+JITValuePointer codegenLikeSegments(JITFunction& func,
+                                    VarSizeJITExprValue& arg_val,
+                                    const std::vector<std::string>& segments,
+                                    const bool is_ilike) {
+  std::string fn_prefix{is_ilike ? "string_ilike" : "string_like"};
+  // keep needle literals alive until codegen complete
+  std::vector<JITValuePointer> needles;
+  auto needle = [&](const std::string& segment) {
+    needles.emplace_back(func.createStringLiteral(segment));
+    needles.emplace_back(func.createLiteral(JITTypeTag::INT32, segment.size()));
+    return std::make_pair(needles[needles.size() - 2].get(), needles.back().get());
+  };
+
+  if (segments.size() == 1) {
+    auto [pat, pat_len] = needle(segments.front());
+    return func.emitRuntimeFunctionCall(
+        fn_prefix + "_exact",
+        JITFunctionEmitDescriptor{
+            .ret_type = JITTypeTag::BOOL,
+            .params_vector = {
+                arg_val.getValue().get(), arg_val.getLength().get(), pat, pat_len}});
+  }
+
+  auto pos = func.createLiteral(JITTypeTag::INT64, 0);
+  if (!segments.front().empty()) {
+    auto [pat, pat_len] = needle(segments.front());
+    pos.replace(func.emitRuntimeFunctionCall(
+        fn_prefix + "_prefix",
+        JITFunctionEmitDescriptor{
+            .ret_type = JITTypeTag::INT64,
+            .params_vector = {
+                arg_val.getValue().get(), arg_val.getLength().get(), pat, pat_len}}));
+  }
+  for (size_t i = 1; i < segments.size() - 1; ++i) {
+    if (segments[i].empty()) {
+      continue;
+    }
+    auto [pat, pat_len] = needle(segments[i]);
+    pos.replace(func.emitRuntimeFunctionCall(fn_prefix + "_find",
+                                             JITFunctionEmitDescriptor{
+                                                 .ret_type = JITTypeTag::INT64,
+                                                 .params_vector = {
+                                                     arg_val.getValue().get(),
+                                                     arg_val.getLength().get(),
+                                                     pos.get(),
+                                                     pat,
+                                                     pat_len}}));
+  }
+  if (!segments.back().empty()) {
+    auto [pat, pat_len] = needle(segments.back());
+    return func.emitRuntimeFunctionCall(fn_prefix + "_suffix",
+                                        JITFunctionEmitDescriptor{
+                                            .ret_type = JITTypeTag::BOOL,
+                                            .params_vector = {arg_val.getValue().get(),
+                                                              arg_val.getLength().get(),
+                                                              pos.get(),
+                                                              pat,
+                                                              pat_len}});
+  }
+  return pos >= 0l;
+}
+}  // namespace
+
 JITExprValue& LikeExpr::codegen(CodegenContext& context) {
   JITFunction& func = *context.getJITFunction();
   if (auto expr_val = get_expr_value()) {
@@ -43,6 +136,37 @@ JITExprValue& LikeExpr::codegen(CodegenContext& context) {
   CHECK(pattern->get_type_info().is_string());
 
   auto arg_val = VarSizeJITExprValue(arg->codegen(context));
+
+  auto escape_char = char{'\\'};
+  if (escape) {
+    auto escape_char_expr = dynamic_cast<Analyzer::Constant*>(escape);
+    CHECK(escape_char_expr);
+    CHECK(escape_char_expr->get_type_info().is_string());
+    CHECK_EQ(size_t(1), escape_char_expr->get_constval().stringval->size());
+    escape_char = (*escape_char_expr->get_constval().stringval)[0];
+  }
+
+  // Constant patterns are specialized here instead of being re-parsed for every row.
+  if (auto pattern_const = dynamic_cast<Analyzer::Constant*>(pattern);
+      pattern_const && !pattern_const->get_is_null()) {
+    const auto& pattern_str = *pattern_const->get_constval().stringval;
+    std::vector<std::string> segments;
+    if (get_is_simple()) {
+      // simple patterns have their enclosing '%' and escapes already erased
+      segments = {"", pattern_str, ""};
+    }
+    if (get_is_simple() ||
+        splitLikePattern(pattern_str, escape_char, segments)) {
+      if (get_is_ilike()) {
+        for (auto& segment : segments) {
+          std::transform(segment.begin(), segment.end(), segment.begin(), ::tolower);
+        }
+      }
+      return set_expr_value(arg_val.getNull(),
+                            codegenLikeSegments(func, arg_val, segments, get_is_ilike()));
+    }
+  }
+
   auto pattern_val = VarSizeJITExprValue(pattern->codegen(context));
 
   std::string fn_name{get_is_ilike() ? "string_ilike" : "string_like"};
@@ -53,14 +177,6 @@ JITExprValue& LikeExpr::codegen(CodegenContext& context) {
                                                   pattern_val.getValue().get(),
                                                   pattern_val.getLength().get()}};
 
-  auto escape_char = char{'\\'};
-  if (escape) {
-    auto escape_char_expr = dynamic_cast<Analyzer::Constant*>(escape);
-    CHECK(escape_char_expr);
-    CHECK(escape_char_expr->get_type_info().is_string());
-    CHECK_EQ(size_t(1), escape_char_expr->get_constval().stringval->size());
-    escape_char = (*escape_char_expr->get_constval().stringval)[0];
-  }
   // put escape_char_val here to keep it alive until codegen complete
   auto escape_char_val = func.createLiteral(JITTypeTag::INT8, int8_t(escape_char));
 